@@ -526,6 +526,47 @@ namespace com.epam.indigo
             return new IndigoObject(this, checkResult(_indigo_lib.indigoUnserialize(buf, buf.Length)));
         }
 
+        public int serializedCountAtoms(byte[] buf)
+        {
+            setSessionID();
+            return checkResult(_indigo_lib.indigoSerializedCountAtoms(buf, buf.Length));
+        }
+
+        public int serializedCountBonds(byte[] buf)
+        {
+            setSessionID();
+            return checkResult(_indigo_lib.indigoSerializedCountBonds(buf, buf.Length));
+        }
+
+        public string serializedGrossFormula(byte[] buf)
+        {
+            setSessionID();
+            return checkResult(_indigo_lib.indigoSerializedGrossFormula(buf, buf.Length));
+        }
+
+        public float[] serializedXYZ(byte[] buf, int atom)
+        {
+            setSessionID();
+            float* ptr = checkResult(_indigo_lib.indigoSerializedXYZ(buf, buf.Length, atom));
+            float[] res = new float[3];
+            res[0] = ptr[0];
+            res[1] = ptr[1];
+            res[2] = ptr[2];
+            return res;
+        }
+
+        public string serializedName(byte[] buf)
+        {
+            setSessionID();
+            return checkResult(_indigo_lib.indigoSerializedName(buf, buf.Length));
+        }
+
+        public string serializedGetProperty(byte[] buf, string prop)
+        {
+            setSessionID();
+            return checkResult(_indigo_lib.indigoSerializedGetProperty(buf, buf.Length, prop));
+        }
+
         public IndigoObject createArray()
         {
             setSessionID();
@@ -540,6 +581,24 @@ namespace com.epam.indigo
             return checkResult(_indigo_lib.indigoSimilarity(obj1.self, obj2.self, metrics));
         }
 
+        public int fingerprintBatchRowSize()
+        {
+            setSessionID();
+            return checkResult(_indigo_lib.indigoFingerprintBatchRowSize());
+        }
+
+        // Writes fingerprints of the next molecules as rows of the buffer and
+        // returns the number of rows; status[i] is 0 for a molecule that failed
+        public int fingerprintBatch(IndigoObject items, string type, int threads, byte[] buffer, byte[] status)
+        {
+            setSessionID();
+            if (type == null)
+                type = "";
+            if (status != null && status.Length < buffer.Length / fingerprintBatchRowSize())
+                throw new IndigoException("fingerprintBatch(): status array is too small");
+            return checkResult(_indigo_lib.indigoFingerprintBatch(items.self, type, threads, buffer, buffer.Length, status));
+        }
+
         public int commonBits(IndigoObject obj1, IndigoObject obj2)
         {
             setSessionID();
@@ -331,6 +331,12 @@ namespace com.epam.indigo
         int indigoSetName(int item, string name);
         int indigoSerialize(int handle, byte** buf, int* size);
         int indigoUnserialize(byte[] buf, int size);
+        int indigoSerializedCountAtoms(byte[] buf, int size);
+        int indigoSerializedCountBonds(byte[] buf, int size);
+        sbyte* indigoSerializedGrossFormula(byte[] buf, int size);
+        float* indigoSerializedXYZ(byte[] buf, int size, int atom);
+        sbyte* indigoSerializedName(byte[] buf, int size);
+        sbyte* indigoSerializedGetProperty(byte[] buf, int size, string prop);
         int indigoHasProperty(int handle, string field);
         sbyte* indigoGetProperty(int handle, string field);
         int indigoSetProperty(int handle, string field, string value);
@@ -344,6 +350,8 @@ namespace com.epam.indigo
         int indigoCountBits(int fingerprint);
         int indigoCommonBits(int fingerprint1, int fingerprint2);
         float indigoSimilarity(int molecule1, int molecule2, string metrics);
+        int indigoFingerprintBatchRowSize();
+        int indigoFingerprintBatch(int items, string type, int threads, byte[] buffer, int buffer_size, byte[] status);
 
         int indigoIterateSDF(int reader);
         int indigoIterateRDF(int reader);
@@ -357,6 +365,7 @@ namespace com.epam.indigo
         int indigoIterateCDXFile(string filename);
         sbyte* indigoRawData(int item);
         int indigoTell(int item);
+        int indigoBuildOffsetsIndex(int iterator, int threads);
         int indigoSdfAppend(int output, int item);
         int indigoSmilesAppend(int output, int item);
         int indigoRdfHeader(int output);
@@ -1634,6 +1634,12 @@ namespace com.epam.indigo
             return dispatcher.checkResult(_indigo_lib.indigoTell(self));
         }
 
+        public int buildOffsetsIndex(int threads)
+        {
+            dispatcher.setSessionID();
+            return dispatcher.checkResult(_indigo_lib.indigoBuildOffsetsIndex(self, threads));
+        }
+
         public void sdfAppend(IndigoObject item)
         {
             dispatcher.setSessionID();
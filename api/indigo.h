@@ -709,6 +709,19 @@ CEXPORT int indigoSerialize (int handle, byte **buf, int *size);
 
 CEXPORT int indigoUnserialize (const byte *buf, int size);
 
+// Molecules serialized with "serialize-fixed-layout" option enabled are
+// read in place by the functions below, without unserializing, e.g. from
+// mmapped files. The buffer should be aligned to 4 bytes, otherwise the
+// molecule is copied first. The returned strings and coordinates are valid
+// until the next call of these functions in the same thread.
+CEXPORT int indigoSerializedCountAtoms (const byte *buf, int size);
+CEXPORT int indigoSerializedCountBonds (const byte *buf, int size);
+CEXPORT const char * indigoSerializedGrossFormula (const byte *buf, int size);
+// Returns pointer to three floats
+CEXPORT const float * indigoSerializedXYZ (const byte *buf, int size, int atom);
+CEXPORT const char * indigoSerializedName (const byte *buf, int size);
+CEXPORT const char * indigoSerializedGetProperty (const byte *buf, int size, const char *prop);
+
 // Applicable to molecules/reactions obtained from SDF or RDF files,
 // and to their clones, and to their R-Group deconvolutions.
 CEXPORT int indigoHasProperty (int handle, const char *prop);
@@ -758,6 +771,20 @@ CEXPORT const char * indigoCheckAmbiguousH (int handle);
 //                 fingerprint types included
 CEXPORT int indigoFingerprint (int item, const char *type);
 
+// Size in bytes of the molecule fingerprint rows written by indigoFingerprintBatch()
+CEXPORT int indigoFingerprintBatchRowSize (void);
+
+// Computes fingerprints of the molecules from an array or an iterator and
+// writes them as consecutive rows of the buffer, without creating objects
+// for them. Molecules are loaded and processed on 'threads' worker threads
+// (zero means the number of processors). Stops when the molecules are over
+// or the buffer is full, so an iterator can be processed in several calls.
+// A molecule that fails to load gets a zero row; if 'status' is not NULL,
+// it receives one byte per row: 1 for a computed fingerprint, 0 for a failure.
+// Returns the number of rows written.
+CEXPORT int indigoFingerprintBatch (int items, const char *type, int threads, byte *buffer, int buffer_size,
+                                    byte *status);
+
 // Counts the nonzero (i.e. one) bits in a fingerprint
 CEXPORT int indigoCountBits (int fingerprint);
 
@@ -797,6 +824,16 @@ CEXPORT const char * indigoRawData (int item);
 CEXPORT int indigoTell (int handle);
 CEXPORT long long indigoTell64(int handle);
 
+// Builds the index of record offsets for an SDF/RDF file iterator and saves
+// it next to the file as <filename>.idx. The file is scanned in parallel
+// chunks on 'threads' worker threads (zero means the number of processors).
+// When "file-offsets-index" option is enabled, file iterators load a valid
+// index, so indigoAt() and indigoCount() don't need to scan the file. With
+// the option enabled, a missing index is also saved after the first full
+// scan of the file by indigoCount() or by iterating to the end.
+// Returns the number of records.
+CEXPORT int indigoBuildOffsetsIndex (int iterator, int threads);
+
 // Saves the molecule to an SDF output stream
 CEXPORT int indigoSdfAppend (int output, int item);
 // Saves the molecule to a multiline SMILES output stream
@@ -815,6 +852,8 @@ CEXPORT int indigoCmlFooter (int output);
 // Supported formats: 'sdf', 'smi' or 'smiles', 'cml', 'rdf'
 // Format argument is case-insensitive
 // Saver should be closed with indigoClose function
+// With "saving-threads" option greater than one, SDF records are written in
+// batches, and the errors of the last batch are returned by indigoClose only
 CEXPORT int indigoCreateSaver (int output, const char *format);
 CEXPORT int indigoCreateFileSaver (const char *filename, const char *format);
 
@@ -617,11 +617,59 @@ public class Indigo {
         return checkResult(guard, _lib.indigoCommonBits(fingerprint1.self, fingerprint2.self));
     }
 
+    public int fingerprintBatchRowSize() {
+        setSessionID();
+        return checkResult(this, _lib.indigoFingerprintBatchRowSize());
+    }
+
+    // Writes fingerprints of the next molecules as rows of the buffer and
+    // returns the number of rows; status[i] is 0 for a molecule that failed
+    public int fingerprintBatch(IndigoObject items, String type, int threads, byte[] buffer, byte[] status) {
+        if (type == null)
+            type = "";
+        if (status != null && status.length < buffer.length / fingerprintBatchRowSize())
+            throw new IndigoException(this, "fingerprintBatch(): status array is too small");
+        Object[] guard = new Object[]{this, items};
+        setSessionID();
+        return checkResult(guard, _lib.indigoFingerprintBatch(items.self, type, threads, buffer, buffer.length, status));
+    }
+
     public IndigoObject unserialize(byte[] data) {
         setSessionID();
         return new IndigoObject(this, checkResult(this, _lib.indigoUnserialize(data, data.length)));
     }
 
+    public int serializedCountAtoms(byte[] data) {
+        setSessionID();
+        return checkResult(this, _lib.indigoSerializedCountAtoms(data, data.length));
+    }
+
+    public int serializedCountBonds(byte[] data) {
+        setSessionID();
+        return checkResult(this, _lib.indigoSerializedCountBonds(data, data.length));
+    }
+
+    public String serializedGrossFormula(byte[] data) {
+        setSessionID();
+        return checkResultString(this, _lib.indigoSerializedGrossFormula(data, data.length));
+    }
+
+    public float[] serializedXYZ(byte[] data, int atom) {
+        setSessionID();
+        Pointer ptr = checkResultPointer(this, _lib.indigoSerializedXYZ(data, data.length, atom));
+        return ptr.getFloatArray(0, 3);
+    }
+
+    public String serializedName(byte[] data) {
+        setSessionID();
+        return checkResultString(this, _lib.indigoSerializedName(data, data.length));
+    }
+
+    public String serializedGetProperty(byte[] data, String prop) {
+        setSessionID();
+        return checkResultString(this, _lib.indigoSerializedGetProperty(data, data.length, prop));
+    }
+
     public IndigoObject createArray() {
         setSessionID();
         return new IndigoObject(this, checkResult(this, _lib.indigoCreateArray()));
@@ -393,6 +393,13 @@ public interface IndigoLib extends Library
 
    int indigoUnserialize (byte[] buf, int size);
 
+   int indigoSerializedCountAtoms (byte[] buf, int size);
+   int indigoSerializedCountBonds (byte[] buf, int size);
+   Pointer indigoSerializedGrossFormula (byte[] buf, int size);
+   Pointer indigoSerializedXYZ (byte[] buf, int size, int atom);
+   Pointer indigoSerializedName (byte[] buf, int size);
+   Pointer indigoSerializedGetProperty (byte[] buf, int size, String prop);
+
    int indigoHasProperty (int handle, String prop);
    Pointer indigoGetProperty (int handle, String prop);
 
@@ -407,6 +414,8 @@ public interface IndigoLib extends Library
    int indigoCountBits (int fingerprint);
    int indigoCommonBits (int fingerprint1, int fingerprint2);
    float indigoSimilarity (int item1, int item2, String metrics);
+   int indigoFingerprintBatchRowSize ();
+   int indigoFingerprintBatch (int items, String type, int threads, byte[] buffer, int buffer_size, byte[] status);
 
    int indigoIterateSDF    (int reader);
    int indigoIterateRDF    (int reader);
@@ -422,6 +431,7 @@ public interface IndigoLib extends Library
 
    Pointer indigoRawData (int item);
    int indigoTell (int handle);
+   int indigoBuildOffsetsIndex (int iterator, int threads);
    int indigoSdfAppend (int output, int item);
    int indigoSmilesAppend (int output, int item);
    int indigoRdfHeader (int output);
@@ -1635,6 +1635,12 @@ public class IndigoObject implements Iterator<IndigoObject>, Iterable<IndigoObje
       return Indigo.checkResult(this, _lib.indigoTell(self));
    }
 
+   public int buildOffsetsIndex (int threads)
+   {
+      dispatcher.setSessionID();
+      return Indigo.checkResult(this, _lib.indigoBuildOffsetsIndex(self, threads));
+   }
+
    public void sdfAppend (IndigoObject item)
    {
       dispatcher.setSessionID();
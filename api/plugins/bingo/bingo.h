@@ -21,6 +21,8 @@ CEXPORT const char * bingoVersion ();
 
 // options = "id: <property-name>"
 CEXPORT int bingoCreateDatabaseFile (const char *location, const char *type, const char *options);
+// Databases created by the previous version (v0.72) are loaded too, but
+// their substructure search has no property vector screening
 CEXPORT int bingoLoadDatabaseFile (const char *location, const char *options);
 CEXPORT int bingoCloseDatabase (int db);
 
@@ -29,6 +31,13 @@ CEXPORT int bingoCloseDatabase (int db);
 //
 CEXPORT int bingoInsertRecordObj (int db, int obj);
 CEXPORT int bingoInsertRecordObjWithId (int db, int obj, int id);
+// Inserts all objects of the iterator. Objects are loaded and indexed on
+// 'threads' worker threads (zero means the number of processors) and
+// inserted in the order of the iterator. Records that can't be loaded,
+// indexed or inserted (e.g. with an id that is already used) are skipped
+// and counted in 'skipped' if it is not NULL.
+// Returns the number of inserted records
+CEXPORT int bingoInsertRecordsFromIterator (int db, int iterator, int threads, int *skipped);
 CEXPORT int bingoDeleteRecord (int db, int id);
 CEXPORT int bingoGetRecordObj (int db, int id);
 
@@ -40,6 +49,10 @@ CEXPORT int bingoSearchSub (int db, int query_obj, const char *options);
 CEXPORT int bingoSearchExact (int db, int query_obj, const char *options);
 CEXPORT int bingoSearchMolFormula (int db, const char *query, const char *options);
 CEXPORT int bingoSearchSim (int db, int query_obj, float min, float max, const char *options);
+// Returns limit most similar objects in the descending order of similarity.
+// Options specify the metric as for bingoSearchSim. With the "part" option
+// the most similar objects of the part are returned.
+CEXPORT int bingoSearchSimTopN (int db, int query_obj, int limit, const char *options);
 
 CEXPORT int bingoEnumerateId (int db);
 
@@ -199,6 +199,34 @@ namespace com.epam.indigo
            return Bingo.checkResult(_indigo, _lib.bingoInsertRecordObjWithId(_id, record.self, id));
         }
 
+        /// <summary>
+        /// Inserts all structures of an iterator. Structures are loaded and indexed on several threads
+        /// </summary>
+        /// <param name="iterator">Indigo iterator over chemical structures (molecules or reactions)</param>
+        /// <param name="threads">number of threads, 0 means the number of processors</param>
+        /// <returns>number of inserted records</returns>
+        public int insertFromIterator(IndigoObject iterator, int threads)
+        {
+           int skipped;
+           return insertFromIterator(iterator, threads, out skipped);
+        }
+
+        /// <summary>
+        /// Inserts all structures of an iterator. Structures are loaded and indexed on several threads
+        /// </summary>
+        /// <param name="iterator">Indigo iterator over chemical structures (molecules or reactions)</param>
+        /// <param name="threads">number of threads, 0 means the number of processors</param>
+        /// <param name="skipped">number of structures which could not be loaded, indexed or inserted</param>
+        /// <returns>number of inserted records</returns>
+        public int insertFromIterator(IndigoObject iterator, int threads, out int skipped)
+        {
+           int skipped_count = 0;
+           _indigo.setSessionID();
+           int inserted = Bingo.checkResult(_indigo, _lib.bingoInsertRecordsFromIterator(_id, iterator.self, threads, &skipped_count));
+           skipped = skipped_count;
+           return inserted;
+        }
+
         /// <summary>
         /// Delete a record by id
         /// </summary>
@@ -265,6 +293,23 @@ namespace com.epam.indigo
             return searchSim(query, min, max, null);
         }
 
+        /// <summary>
+        /// Execute search for the most similar objects
+        /// </summary>
+        /// <param name="query">indigo object (molecule or reaction)</param>
+        /// <param name="limit">Number of the most similar objects to return</param>
+        /// <param name="metric">Default value is "tanimoto"</param>
+        /// <returns>Bingo search object instance with results in the descending order of similarity</returns>
+        public BingoObject searchSimTopN(IndigoObject query, int limit, string metric)
+        {
+            if (metric == null)
+            {
+                metric = "tanimoto";
+            }
+            _indigo.setSessionID();
+            return new BingoObject(Bingo.checkResult(_indigo, _lib.bingoSearchSimTopN(_id, query.self, limit, metric)), _indigo, _lib);
+        }
+
         /// <summary>
         /// Execute enumerate id operation
         /// </summary>
@@ -14,12 +14,14 @@ namespace com.epam.indigo
 
         int bingoInsertRecordObj (int db, int obj);
         int bingoInsertRecordObjWithId(int db, int obj, int id);
+        int bingoInsertRecordsFromIterator(int db, int iterator, int threads, int* skipped);
         int bingoDeleteRecord (int db, int index);
 
         int bingoOptimize (int db);
 
         int bingoSearchSub (int db, int query_obj, string options);
         int bingoSearchSim (int db, int query_obj, float min, float max, string options);
+        int bingoSearchSimTopN (int db, int query_obj, int limit, string options);
         int bingoSearchExact (int db, int query_obj, string options);
         int bingoSearchMolFormula (int db, string query, string options);
 
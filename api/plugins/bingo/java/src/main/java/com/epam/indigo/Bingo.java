@@ -185,6 +185,30 @@ public class Bingo {
 		return Bingo.checkResult(_indigo, _lib.bingoInsertRecordObjWithId(_id, record.self, id));
 	}
 
+    /**
+        Inserts all structures of an iterator. Structures are loaded and indexed on several threads
+
+        @param iterator Indigo iterator over chemical structures (molecules or reactions)
+        @param threads number of threads, 0 means the number of processors
+        @return number of inserted records
+    */
+	public int insertFromIterator(IndigoObject iterator, int threads) {
+		return insertFromIterator(iterator, threads, null);
+	}
+
+    /**
+        Inserts all structures of an iterator. Structures are loaded and indexed on several threads
+
+        @param iterator Indigo iterator over chemical structures (molecules or reactions)
+        @param threads number of threads, 0 means the number of processors
+        @param skipped array of one element that receives the number of structures which could not be loaded, indexed or inserted
+        @return number of inserted records
+    */
+	public int insertFromIterator(IndigoObject iterator, int threads, int[] skipped) {
+		_indigo.setSessionID();
+		return Bingo.checkResult(_indigo, _lib.bingoInsertRecordsFromIterator(_id, iterator.self, threads, skipped));
+	}
+
 	/**
         Delete a record by id
 
@@ -249,6 +273,22 @@ public class Bingo {
 		return searchSim(query, min, max, null);
 	}
 
+	/**
+		Execute search for the most similar objects
+
+		@param query indigo object (molecule or reaction)
+		@param limit Number of the most similar objects to return
+		@param metric Default value is "tanimoto"
+		@return Bingo search object instance with results in the descending order of similarity
+	*/
+	public BingoObject searchSimTopN(IndigoObject query, int limit, String metric) {
+		if (metric == null) {
+			metric = "tanimoto";
+		}
+		_indigo.setSessionID();
+		return new BingoObject(Bingo.checkResult(_indigo, _lib.bingoSearchSimTopN(_id, query.self, limit, metric)), _indigo, _lib);
+	}
+
 	/**
 		Execute enumerate id operation
 
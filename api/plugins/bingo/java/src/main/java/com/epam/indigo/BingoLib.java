@@ -25,12 +25,14 @@ public interface BingoLib extends Library
 
         int bingoInsertRecordObj (int db, int obj);
         int bingoInsertRecordObjWithId(int db, int obj, int id);
+        int bingoInsertRecordsFromIterator(int db, int iterator, int threads, int[] skipped);
         int bingoDeleteRecord (int db, int index);
 
         int bingoOptimize (int db);
 
         int bingoSearchSub (int db, int query_obj, String options);
         int bingoSearchSim (int db, int query_obj, float min, float max, String options);
+        int bingoSearchSimTopN (int db, int query_obj, int limit, String options);
         int bingoSearchExact (int db, int query_obj, String options);
         int bingoSearchMolFormula (int db, String query, String options);
 
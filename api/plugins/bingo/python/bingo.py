@@ -46,6 +46,8 @@ class Bingo(object):
         self._lib.bingoGetRecordObj.argtypes = [c_int, c_int]
         self._lib.bingoInsertRecordObjWithId.restype = c_int
         self._lib.bingoInsertRecordObjWithId.argtypes = [c_int, c_int, c_int]
+        self._lib.bingoInsertRecordsFromIterator.restype = c_int
+        self._lib.bingoInsertRecordsFromIterator.argtypes = [c_int, c_int, c_int, POINTER(c_int)]
         self._lib.bingoDeleteRecord.restype = c_int
         self._lib.bingoDeleteRecord.argtypes = [c_int, c_int]
         self._lib.bingoSearchSub.restype = c_int
@@ -56,6 +58,8 @@ class Bingo(object):
         self._lib.bingoSearchMolFormula.argtypes = [c_int, c_char_p, c_char_p]
         self._lib.bingoSearchSim.restype = c_int
         self._lib.bingoSearchSim.argtypes = [c_int, c_int, c_float, c_float, c_char_p]
+        self._lib.bingoSearchSimTopN.restype = c_int
+        self._lib.bingoSearchSimTopN.argtypes = [c_int, c_int, c_int, c_char_p]
         self._lib.bingoEnumerateId.restype = c_int
         self._lib.bingoEnumerateId.argtypes = [c_int]
         self._lib.bingoNext.restype = c_int
@@ -150,6 +154,14 @@ class Bingo(object):
             return Bingo._checkResult(self._indigo,
                                       self._lib.bingoInsertRecordObjWithId(self._id, indigoObject.id, index))
 
+    def insertFromIterator(self, iterator, threads=0):
+        """Returns a tuple of the numbers of inserted and skipped records"""
+        skipped = c_int()
+        self._indigo._setSessionId()
+        inserted = Bingo._checkResult(self._indigo,
+                                      self._lib.bingoInsertRecordsFromIterator(self._id, iterator.id, threads, pointer(skipped)))
+        return inserted, skipped.value
+
     def delete(self, index):
         self._indigo._setSessionId()
         Bingo._checkResult(self._indigo, self._lib.bingoDeleteRecord(self._id, index))
@@ -176,6 +188,14 @@ class Bingo(object):
             Bingo._checkResult(self._indigo, self._lib.bingoSearchSim(self._id, query.id, minSim, maxSim, metric.encode('ascii'))),
             self._indigo, self)
 
+    def searchSimTopN(self, query, limit, metric='tanimoto'):
+        self._indigo._setSessionId()
+        if not metric:
+            metric = 'tanimoto'
+        return BingoObject(
+            Bingo._checkResult(self._indigo, self._lib.bingoSearchSimTopN(self._id, query.id, limit, metric.encode('ascii'))),
+            self._indigo, self)
+
     def enumerateId(self):
         self._indigo._setSessionId()
         e = self._lib.bingoEnumerateId(self._id)
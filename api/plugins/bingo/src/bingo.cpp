@@ -33,6 +33,8 @@
 #include "base_cpp/auto_ptr.h"
 #include "base_cpp/exception.h"
 #include "base_cpp/os_sync_wrapper.h"
+#include "base_cpp/os_thread_wrapper.h"
+#include "base_cpp/obj_array.h"
 
 using namespace indigo;
 using namespace bingo;
@@ -138,6 +140,213 @@ static int _insertObjectToDatabase (int db, Indigo &self, Index &bingo_index, In
    return -1;
 }
 
+//
+// Bulk insertion
+//
+
+namespace
+{
+   class BulkInsertResult : public OsCommandResult
+   {
+   public:
+      virtual void clear ()
+      {
+         data.clear();
+         ids.clear();
+         prepared.clear();
+      }
+
+      ObjArray<ObjectIndexData> data;
+      Array<int> ids;
+      Array<bool> prepared;
+   };
+
+   class BulkInsertCommand : public OsCommand
+   {
+   public:
+      BulkInsertCommand (Index &index) : _index(index)
+      {
+      }
+
+      virtual void clear ()
+      {
+         items.clear();
+      }
+
+      virtual void execute (OsCommandResult &result)
+      {
+         BulkInsertResult &res = (BulkInsertResult &)result;
+         Indigo &self = indigoGetInstance();
+
+         for (int i = 0; i < items.size(); i++)
+         {
+            // Objects from the iterator are loaded here, in the worker thread
+            IndigoObject &indigo_obj = *items[i];
+            ObjectIndexData &obj_data = res.data.push();
+            bool prepared;
+            long obj_id = -1;
+
+            // A record that can't be loaded or indexed is skipped
+            try
+            {
+               if (_index.getType() == Index::MOLECULE)
+               {
+                  if (!IndigoMolecule::is(indigo_obj))
+                     throw BingoException("bingoInsertRecordsFromIterator: Only molecule objects can be added to molecule index");
+
+                  indigo_obj.getBaseMolecule().aromatize(self.arom_options);
+
+                  IndexMolecule ind_mol(indigo_obj.getMolecule());
+                  prepared = _index.prepare(ind_mol, obj_data);
+               }
+               else
+               {
+                  if (!IndigoReaction::is(indigo_obj))
+                     throw BingoException("bingoInsertRecordsFromIterator: Only reaction objects can be added to reaction index");
+
+                  indigo_obj.getBaseReaction().aromatize(self.arom_options);
+
+                  IndexReaction ind_rxn(indigo_obj.getReaction());
+                  prepared = _index.prepare(ind_rxn, obj_data);
+               }
+
+               auto& properties = indigo_obj.getProperties();
+
+               if (key_name != 0 && properties.contains(key_name))
+                  obj_id = strtol(properties.at(key_name), NULL, 10);
+            }
+            catch (Exception &)
+            {
+               prepared = false;
+            }
+
+            res.ids.push(obj_id);
+            res.prepared.push(prepared);
+         }
+      }
+
+      PtrArray<IndigoObject> items;
+      const char *key_name;
+
+   private:
+      Index &_index;
+   };
+
+   // Objects are taken from the iterator in the main thread and their index
+   // data is prepared on the worker threads. Results are inserted into the
+   // storages in the main thread, in the order of the iterator.
+   class BulkInsertDispatcher : public OsCommandDispatcher
+   {
+   public:
+      BulkInsertDispatcher (Index &index, DatabaseLockData &lock_data, IndigoObject &iterator) :
+         OsCommandDispatcher(HANDLING_ORDER_SERIAL, true), _index(index), _lock_data(lock_data),
+         _iterator(iterator), _inserted(0), _skipped(0), _finished(false)
+      {
+         _key_name = _index.getIdPropertyName();
+         _database_id = MMFStorage::getDatabaseId();
+      }
+
+      int insert (int threads)
+      {
+         run(threads > 1 ? threads : 0);
+
+         // Errors of the iterator are raised after the workers are finished
+         if (_iterator_error.get() != 0)
+            throw BingoException("bingoInsertRecordsFromIterator: %s (%d records inserted, %d skipped)",
+               _iterator_error->message(), _inserted, _skipped);
+         return _inserted;
+      }
+
+      int skipped () const
+      {
+         return _skipped;
+      }
+
+   protected:
+      enum { _CHUNK_SIZE = 32 };
+
+      virtual OsCommand * _allocateCommand ()
+      {
+         return new BulkInsertCommand(_index);
+      }
+
+      virtual OsCommandResult * _allocateResult ()
+      {
+         return new BulkInsertResult();
+      }
+
+      virtual bool _setupCommand (OsCommand &command)
+      {
+         BulkInsertCommand &cmd = (BulkInsertCommand &)command;
+
+         cmd.key_name = _key_name;
+         while (!_finished && cmd.items.size() < _CHUNK_SIZE)
+         {
+            IndigoObject *item;
+
+            try
+            {
+               item = _iterator.next();
+            }
+            catch (Exception &e)
+            {
+               _iterator_error.reset(e.clone());
+               item = 0;
+            }
+
+            if (item == 0)
+               _finished = true;
+            else
+               cmd.items.add(item);
+         }
+
+         return cmd.items.size() > 0;
+      }
+
+      virtual void _handleResult (OsCommandResult &result)
+      {
+         BulkInsertResult &res = (BulkInsertResult &)result;
+
+         for (int i = 0; i < res.data.size(); i++)
+         {
+            if (!res.prepared[i])
+            {
+               _skipped++;
+               continue;
+            }
+
+            // A record with an id that is already used is skipped too
+            try
+            {
+               _index.insert(res.data[i], res.ids[i], _lock_data);
+            }
+            catch (Exception &)
+            {
+               _skipped++;
+               continue;
+            }
+            _inserted++;
+         }
+      }
+
+      virtual void _prepareThread ()
+      {
+         MMFStorage::setDatabaseId(_database_id);
+      }
+
+   private:
+      Index &_index;
+      DatabaseLockData &_lock_data;
+      IndigoObject &_iterator;
+      const char *_key_name;
+      int _database_id;
+      int _inserted;
+      int _skipped;
+      bool _finished;
+      AutoPtr<Exception> _iterator_error;
+   };
+}
+
 Matcher& getMatcher (int id)
 {
    if (id < _searches.begin() || id >= _searches.end() || !_searches.hasElement(id))
@@ -212,6 +421,27 @@ CEXPORT int bingoInsertRecordObjWithId (int db, int obj, int id)
    BINGO_END(-1);
 }
 
+CEXPORT int bingoInsertRecordsFromIterator (int db, int iterator, int threads, int *skipped)
+{
+   BINGO_BEGIN_DB(db)
+   {
+      IndigoObject &iter_obj = self.getObject(iterator);
+      Index &bingo_index = _bingo_instances.ref(db);
+
+      if (threads <= 0)
+         threads = osGetProcessorsCount();
+
+      BulkInsertDispatcher dispatcher(bingo_index, *_lockers[db], iter_obj);
+
+      int inserted = dispatcher.insert(threads);
+
+      if (skipped != 0)
+         *skipped = dispatcher.skipped();
+      return inserted;
+   }
+   BINGO_END(-1);
+}
+
 CEXPORT int bingoDeleteRecord (int db, int id)
 {
    BINGO_BEGIN_DB(db)
@@ -460,6 +690,52 @@ CEXPORT int bingoSearchSim (int db, int query_obj, float min, float max, const c
    BINGO_END(-1);
 }
 
+CEXPORT int bingoSearchSimTopN (int db, int query_obj, int limit, const char *options)
+{
+   BINGO_BEGIN_DB(db)
+   {
+      if (limit <= 0)
+         throw BingoException("bingoSearchSimTopN: limit should be positive");
+
+      AutoPtr<IndigoObject> obj(self.getObject(query_obj).clone());
+      BaseSimilarityMatcher *matcher;
+
+      if (IndigoMolecule::is(obj.ref()))
+      {
+         obj->getBaseMolecule().aromatize(self.arom_options);
+
+         AutoPtr<MoleculeSimilarityQueryData> query_data(new MoleculeSimilarityQueryData(obj->getMolecule(), 0, 1));
+
+         MoleculeIndex &bingo_index = dynamic_cast<MoleculeIndex &>(_bingo_instances.ref(db));
+         matcher = dynamic_cast<MoleculeSimMatcher *>(bingo_index.createMatcher("sim", query_data.release(), options));
+      }
+      else if (IndigoReaction::is(obj.ref()))
+      {
+         obj->getBaseReaction().aromatize(self.arom_options);
+
+         AutoPtr<ReactionSimilarityQueryData> query_data(new ReactionSimilarityQueryData(obj->getReaction(), 0, 1));
+
+         ReactionIndex &bingo_index = dynamic_cast<ReactionIndex &>(_bingo_instances.ref(db));
+         matcher = dynamic_cast<ReactionSimMatcher *>(bingo_index.createMatcher("sim", query_data.release(), options));
+      }
+      else
+         throw BingoException("bingoSearchSimTopN: only query molecule and query reaction can be set as query object");
+
+      matcher->setTopN(limit);
+
+      int search_id;
+      {
+         OsLocker searches_locker(_searches_lock);
+         search_id = _searches.add(matcher);
+         _searches_db.expand(search_id + 1);
+         _searches_db[search_id] = db;
+      }
+
+      return search_id;
+   }
+   BINGO_END(-1);
+}
+
 CEXPORT int bingoEnumerateId (int db)
 {
    BINGO_BEGIN_DB(db)
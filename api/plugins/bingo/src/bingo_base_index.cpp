@@ -17,6 +17,8 @@ static const char *_cf_offset_filename = "cf_offset";
 static const char *_id_mapping_filename = "id_mapping";
 static const char *_reaction_type = "reaction_" BINGO_VERSION;
 static const char *_molecule_type = "molecule_" BINGO_VERSION;
+static const char *_reaction_type_no_props = "reaction_" BINGO_VERSION_NO_PROPERTIES;
+static const char *_molecule_type_no_props = "molecule_" BINGO_VERSION_NO_PROPERTIES;
 static const int _type_len = 30;
 static const char *_mmf_file = "mmf_storage";
 static const char *_version_prop = "version";
@@ -92,6 +94,7 @@ void BaseIndex::create (const char *location, const MoleculeFingerprintParameter
    _header->sim_offset = SimStorage::create(_sim_fp_storage, _fp_params.fingerprintSizeSim(), mt_size, _small_base_size);
    _header->exact_offset = ExactStorage::create(_exact_storage);
    _header->gross_offset = GrossStorage::create(_gross_storage, cf_block_size);
+   _header->prop_offset = PropertyStorage::create(_prop_storage);
 
    _header->first_free_id = 0;
    _header->object_count = 0;
@@ -128,11 +131,16 @@ void BaseIndex::load (const char *location, const char *options, int index_id)
    Properties::load(_properties, _header->properties_offset);
    
    const char *ver = _properties->get(_version_prop);
+   bool has_props = (strcmp(ver, BINGO_VERSION) == 0);
 
-   if (strcmp(ver, BINGO_VERSION) != 0)
+   if (!has_props && strcmp(ver, BINGO_VERSION_NO_PROPERTIES) != 0)
       throw Exception("BaseIndex: load(): incorrect database version");
 
-   const char *type_str = (_type == MOLECULE ? _molecule_type : _reaction_type);
+   const char *type_str;
+   if (has_props)
+      type_str = (_type == MOLECULE ? _molecule_type : _reaction_type);
+   else
+      type_str = (_type == MOLECULE ? _molecule_type_no_props : _reaction_type_no_props);
    if (strcmp(_properties->get("base_type"), type_str) != 0)
       throw Exception("Loading databse: wrong type propety");
    
@@ -151,6 +159,8 @@ void BaseIndex::load (const char *location, const char *options, int index_id)
    TranspFpStorage::load(_sub_fp_storage, _header.ptr()->sub_offset);
    ByteBufferStorage::load(_cf_storage, _header.ptr()->cf_offset);
    GrossStorage::load(_gross_storage, _header.ptr()->gross_offset);
+   if (has_props)
+      PropertyStorage::load(_prop_storage, _header.ptr()->prop_offset);
 }
 
 int BaseIndex::add (/* const */ IndexObject &obj, int obj_id, DatabaseLockData &lock_data)
@@ -166,15 +176,29 @@ int BaseIndex::add (/* const */ IndexObject &obj, int obj_id, DatabaseLockData &
             throw Exception("insert fail: This id was already used");
    }
 
-   _ObjectIndexData _obj_data;
+   ObjectIndexData _obj_data;
    {
       profTimerStart(t_in, "prepare_obj_data");      
-      _prepareIndexData(obj, _obj_data);
+      if (!prepare(obj, _obj_data))
+         throw Exception("insert fail: Index data can't be built for the object");
    }
    
+   return insert(_obj_data, obj_id, lock_data);
+}
+
+int BaseIndex::insert (ObjectIndexData &_obj_data, int obj_id, DatabaseLockData &lock_data)
+{
+   if (_read_only)
+      throw Exception("insert fail: Read only index can't be changed");
+
+   BingoMapping & back_id_mapping = _back_id_mapping_ptr.ref();
+
    WriteLock wlock(lock_data);
    profTimerStart(t_after, "exclusive_write");   
 
+   if (obj_id != -1 && back_id_mapping.get(obj_id) != (size_t)-1)
+      throw Exception("insert fail: This id was already used");
+
    {
       profTimerStart(t_in, "add_obj_data");   
       _insertIndexData(_obj_data);
@@ -251,6 +275,16 @@ GrossStorage & BaseIndex::getGrossStorage ()
    return _gross_storage.ref();
 }
 
+bool BaseIndex::hasPropertyStorage ()
+{
+   return !_prop_storage.isNull();
+}
+
+PropertyStorage & BaseIndex::getPropertyStorage ()
+{
+   return _prop_storage.ref();
+}
+
 BingoArray<int> & BaseIndex::getIdMapping ()
 {
    return _id_mapping_ptr.ref();
@@ -310,9 +344,9 @@ Index::IndexType BaseIndex::determineType (const char *location)
    file.seekg(0);
    file.read(type, _type_len);
 
-   if (strcmp(type, _molecule_type) == 0)
+   if (strcmp(type, _molecule_type) == 0 || strcmp(type, _molecule_type_no_props) == 0)
       return MOLECULE;
-   else if (strcmp(type, _reaction_type) == 0)
+   else if (strcmp(type, _reaction_type) == 0 || strcmp(type, _reaction_type_no_props) == 0)
       return REACTION;
    else
       throw Exception("BingoIndex: determineType(): Database format is not compatible with this version.");
@@ -416,7 +450,7 @@ void BaseIndex::_saveProperties (const MoleculeFingerprintParameters &fp_params,
    }
 }
 
-bool BaseIndex::_prepareIndexData (IndexObject &obj, _ObjectIndexData &obj_data)
+bool BaseIndex::prepare (IndexObject &obj, ObjectIndexData &obj_data)
 {
    {
       profTimerStart(t, "prepare_cf");
@@ -439,16 +473,21 @@ bool BaseIndex::_prepareIndexData (IndexObject &obj, _ObjectIndexData &obj_data)
    if (!obj.buildHash(obj_data.hash))
       return false;
 
+   if (!obj.buildPropertyVector(obj_data.prop_vector))
+      return false;
+
    return true;
 }
 
-void BaseIndex::_insertIndexData (_ObjectIndexData &obj_data)
+void BaseIndex::_insertIndexData (ObjectIndexData &obj_data)
 {
    _sub_fp_storage.ptr()->add(obj_data.sub_fp.ptr());
    _sim_fp_storage.ptr()->add(obj_data.sim_fp.ptr(), _header->object_count);
    _cf_storage.ptr()->add((byte *)obj_data.cf_str.ptr(), obj_data.cf_str.size(), _header->object_count);
    _exact_storage.ptr()->add(obj_data.hash, _header->object_count);
    _gross_storage.ptr()->add(obj_data.gross_str, _header->object_count);
+   if (hasPropertyStorage())
+      _prop_storage.ptr()->add(obj_data.prop_vector.ptr());
 }
 
 void BaseIndex::_mappingLoad ()
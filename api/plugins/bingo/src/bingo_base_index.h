@@ -11,9 +11,13 @@
 #include "bingo_exact_storage.h"
 #include "bingo_gross_storage.h"
 #include "bingo_sim_storge.h"
+#include "bingo_prop_storage.h"
 #include "bingo_lock.h"
 
-#define BINGO_VERSION "v0.72"
+#define BINGO_VERSION "v0.73"
+// Databases of the previous version have no property vectors, they are
+// searched without the property screening
+#define BINGO_VERSION_NO_PROPERTIES "v0.72"
 
 using namespace indigo;
 
@@ -22,6 +26,17 @@ namespace bingo
    class Matcher;
    class MatcherQueryData;
 
+   // Object data stored in the index storages
+   struct ObjectIndexData
+   {
+      Array<byte> sub_fp;
+      Array<byte> sim_fp;
+      Array<char> cf_str;
+      Array<char> gross_str;
+      Array<byte> prop_vector;
+      dword hash;
+   };
+
    class Index
    {
    public:
@@ -35,6 +50,12 @@ namespace bingo
 
       virtual int add (IndexObject &obj, int obj_id, DatabaseLockData &lock_data) = 0;
 
+      // Two stages of add() for the bulk insertion: prepare() can be called
+      // for several objects simultaneously, insert() takes the write lock
+      virtual bool prepare (IndexObject &obj, ObjectIndexData &obj_data) = 0;
+
+      virtual int insert (ObjectIndexData &obj_data, int obj_id, DatabaseLockData &lock_data) = 0;
+
       virtual void optimize () = 0;
 
       virtual void remove (int id) = 0;
@@ -65,6 +86,8 @@ namespace bingo
          BingoAddr gross_offset;
          int object_count;
          int first_free_id;
+         // Absent in the databases of BINGO_VERSION_NO_PROPERTIES
+         BingoAddr prop_offset;
       };
 
    public:
@@ -74,6 +97,10 @@ namespace bingo
       
       virtual int add (IndexObject &obj, int obj_id, DatabaseLockData &lock_data);
 
+      virtual bool prepare (IndexObject &obj, ObjectIndexData &obj_data);
+
+      virtual int insert (ObjectIndexData &obj_data, int obj_id, DatabaseLockData &lock_data);
+
       virtual void optimize ();
 
       virtual void remove (int id);
@@ -88,6 +115,10 @@ namespace bingo
       
       GrossStorage & getGrossStorage ();
 
+      bool hasPropertyStorage ();
+
+      PropertyStorage & getPropertyStorage ();
+
       BingoArray<int> & getIdMapping ();
 
       BingoMapping & getBackIdMapping ();
@@ -114,15 +145,6 @@ namespace bingo
       bool _read_only;
 
    private:
-      struct _ObjectIndexData 
-      {
-         Array<byte> sub_fp;
-         Array<byte> sim_fp;
-         Array<char> cf_str;
-         Array<char> gross_str;
-         dword hash;
-      };
-
       MMFStorage _mmf_storage;
       BingoPtr<_Header> _header;
       BingoPtr< BingoArray<int> > _id_mapping_ptr;
@@ -131,6 +153,7 @@ namespace bingo
       BingoPtr<SimStorage> _sim_fp_storage;
       BingoPtr<ExactStorage> _exact_storage;
       BingoPtr<GrossStorage> _gross_storage;
+      BingoPtr<PropertyStorage> _prop_storage;
       BingoPtr<ByteBufferStorage> _cf_storage;
       BingoPtr<Properties> _properties;
       
@@ -151,9 +174,7 @@ namespace bingo
                             int sim_block_size, int cf_block_size, 
                             std::map<std::string, std::string> &option_map);
 
-      bool _prepareIndexData (IndexObject &obj, _ObjectIndexData &obj_data);
-
-      void _insertIndexData(_ObjectIndexData &obj_data);
+      void _insertIndexData(ObjectIndexData &obj_data);
 
       void _mappingCreate ();
 
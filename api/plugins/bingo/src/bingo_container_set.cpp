@@ -188,12 +188,17 @@ int ContainerSet::_findSimilarInc (const byte *query, SimCoef &sim_coef, double
 
    int query_bit_number = bitGetOnesCount(query, _fp_size);
 
+   QS_DEF(Array<int>, fp_bit_numbers);
+   QS_DEF(Array<int>, common_bits);
+   fp_bit_numbers.clear_resize(_inc_count);
+   common_bits.clear_resize(_inc_count);
+
+   bitGetOnesCountBlock(inc, _fp_size, _inc_count, fp_bit_numbers.ptr());
+   bitCommonOnesBlock(query, inc, _fp_size, _inc_count, common_bits.ptr());
+
    for (int i = 0; i < _inc_count; i++)
    {
-      byte *fp = inc + i * _fp_size;
-      int fp_bit_number = bitGetOnesCount(fp, _fp_size);
-
-      double coef = sim_coef.calcCoef(fp, query, query_bit_number, fp_bit_number);
+      double coef = sim_coef.calcCoef(query_bit_number, fp_bit_numbers[i], common_bits[i]);
       if (coef < min_coef)
          continue;
 
@@ -13,6 +13,11 @@ double EuclidCoef::calcCoef (const byte *target, const byte *query, int target_b
    if (target_bit_count == -1)
       target_bit_count = bitGetOnesCount(target, _fp_size);
    
+   return calcCoef(target_bit_count, query_bit_count, common_bits);
+}
+
+double EuclidCoef::calcCoef (int target_bit_count, int query_bit_count, int common_bits )
+{
    return (double)common_bits / target_bit_count;
 }
 
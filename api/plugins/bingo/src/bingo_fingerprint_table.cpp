@@ -124,6 +124,13 @@ void FingerprintTable::getCellsInterval (const byte *query, SimCoef &sim_coef, d
    }
 }
 
+double FingerprintTable::getCellUpperBound (int query_bit_count, SimCoef &sim_coef, int cell_idx) const
+{
+   if (cell_idx >= _table.size())
+      throw Exception("FingerprintTable: Incorrect cell index");
+
+   return sim_coef.calcUpperBound(query_bit_count, _table[cell_idx].getMinBorder(), _table[cell_idx].getMaxBorder());
+}
       
 int FingerprintTable::firstFitCell (int query_bit_count, int min_cell, int max_cell) const
 {
@@ -38,6 +38,8 @@ namespace bingo
       
       void getCellsInterval (const byte *query, SimCoef &sim_coef, double min_coef, int &min_cell, int &max_cell);
 
+      double getCellUpperBound (int query_bit_count, SimCoef &sim_coef, int cell_idx) const;
+
       int firstFitCell (int query_bit_count, int min_cell, int max_cell ) const;
 
       int nextFitCell (int query_bit_count, int first_fit_cell, int min_cell, int max_cell, int idx) const;
@@ -111,7 +111,7 @@ void TranspFpStorage::_addIncToStorage ()
 
       int block_idx = (_pack_count * _fp_size * 8) + bit_idx;
       _storage.resize(block_idx + 1);
-      _storage[block_idx].allocate(_block_size);
+      _storage[block_idx].allocate(_block_size, block_alignment);
       memcpy(_storage[block_idx].ptr(), &block_buf[0], _block_size);
       _block_count++;
    }
@@ -11,6 +11,9 @@ namespace bingo
    class TranspFpStorage
    {
    public:
+      // Blocks are aligned for the vectorized screening
+      static const int block_alignment = 64;
+
       TranspFpStorage (int fp_size, int block_size, int small_base_size);
 
       static BingoAddr create (BingoPtr<TranspFpStorage> &ptr, int fp_size, int block_size, int small_base_size);
@@ -8,6 +8,7 @@
 #include "base_c/nano.h"
 #include "base_c/bitarray.h"
 #include "base_cpp/profiling.h"
+#include "base_cpp/os_thread_wrapper.h"
 
 #include <algorithm>
 #include <vector>
@@ -18,6 +19,12 @@ using namespace bingo;
 
 static const char *_matcher_params_prop = "";
 static const char *_matcher_part_prop = "part";
+static const char *_matcher_threads_prop = "threads";
+
+// Number of candidates verified by one command in the multithreaded substructure search
+static const int _verification_chunk_size = 16;
+// Number of candidates verified per thread before returning the found objects
+static const int _verification_window_per_thread = 256;
 
 GrossQueryData::GrossQueryData (Array<char> &gross_str) : _obj(gross_str)
 {
@@ -134,6 +141,7 @@ BaseMatcher::BaseMatcher(BaseIndex &index, IndigoObject *& current_obj) : _index
    _current_id = 0;
    _part_id = -1;
    _part_count = -1;
+   _threads_count = 1;
 }
 
 BaseMatcher::~BaseMatcher ()
@@ -179,6 +187,7 @@ void BaseMatcher::setOptions (const char * options)
    std::vector<std::string> allowed_props;
    allowed_props.push_back(_matcher_params_prop);
    allowed_props.push_back(_matcher_part_prop);
+   allowed_props.push_back(_matcher_threads_prop);
    Properties::parseOptions(options, option_map, &allowed_props);
 
    if (option_map.find(_matcher_params_prop) != option_map.end())
@@ -205,6 +214,24 @@ void BaseMatcher::setOptions (const char * options)
       _part_count = part_count;
       _initPartition();
    }
+
+   if (option_map.find(_matcher_threads_prop) != option_map.end())
+   {
+      std::stringstream threads_str;
+      threads_str << option_map[_matcher_threads_prop];
+
+      int threads_count;
+      threads_str >> threads_count;
+
+      if (threads_str.fail() || threads_count < 0)
+         throw Exception("BaseMatcher: setOptions: incorrect threads count");
+
+      if (!_isThreadsSupported())
+         throw Exception("BaseMatcher: setOptions: threads option is supported by substructure search only");
+
+      // Zero means the number of processors
+      _threads_count = (threads_count == 0 ? osGetProcessorsCount() : threads_count);
+   }
 }
 
 bool BaseMatcher::_isCurrentObjectExist()
@@ -219,17 +246,22 @@ bool BaseMatcher::_isCurrentObjectExist()
 }
 
 bool BaseMatcher::_loadCurrentObject()
+{
+   if (_current_obj == 0)
+      throw Exception("BaseMatcher: Matcher's current object was destroyed");
+
+   return loadObject(_index, _current_id, *_current_obj);
+}
+
+bool BaseMatcher::loadObject (BaseIndex &index, int id, IndigoObject &obj)
 {
    try 
    {
-      if (_current_obj == 0)
-         throw Exception("BaseMatcher: Matcher's current object was destroyed");
-
       profTimerStart(t_get_cmf, "loadCurObj_get_cf");
-      ByteBufferStorage &cf_storage = _index.getCfStorage();
+      ByteBufferStorage &cf_storage = index.getCfStorage();
    
       int cf_len;
-      const char *cf_str = (const char *)cf_storage.get(_current_id, cf_len);
+      const char *cf_str = (const char *)cf_storage.get(id, cf_len);
 
       if (cf_len == -1)
          return false;
@@ -238,17 +270,17 @@ bool BaseMatcher::_loadCurrentObject()
       profTimerStart(t_load_cmf, "loadCurObj_load_cf");
       BufferScanner buf_scn(cf_str, cf_len);
    
-      if (IndigoMolecule::is(*_current_obj))
+      if (IndigoMolecule::is(obj))
       {
-         Molecule &mol = _current_obj->getMolecule();
+         Molecule &mol = obj.getMolecule();
 
          CmfLoader cmf_loader(buf_scn);
 
          cmf_loader.loadMolecule(mol);
       }
-      else if (IndigoReaction::is(*_current_obj))
+      else if (IndigoReaction::is(obj))
       {
-         Reaction &rxn = _current_obj->getReaction();
+         Reaction &rxn = obj.getReaction();
    
          CrfLoader crf_loader(buf_scn);
 
@@ -263,7 +295,7 @@ bool BaseMatcher::_loadCurrentObject()
    }
    catch (Exception &ex)
    {
-      int db_id = _index.getIdMapping()[_current_id];
+      int db_id = index.getIdMapping()[id];
       ex.appendMessage(" on id=%d", db_id);
       ex.throwSelf();
       return false; // This statement is dummy because throwSelf always throws an exception
@@ -295,6 +327,188 @@ float BaseMatcher::esimateRemainingTime (float &delta)
    return left_obj_count * mean_time;
 }
 
+//
+// Multithreaded substructure search
+//
+
+namespace bingo
+{
+   class SubstructureSearchResult : public OsCommandResult
+   {
+   public:
+      virtual void clear ()
+      {
+         ids.clear();
+         mappings.clear();
+         mapping_ends.clear();
+         tried = 0;
+         time_sec = 0;
+      }
+
+      // Candidates after screening or found ids after verification
+      Array<int> ids;
+      // Packed mappings of the found ids, see SubstructureVerifier
+      Array<int> mappings;
+      Array<int> mapping_ends;
+      int tried;
+      float time_sec;
+   };
+
+   class SubstructureSearchCommand : public OsCommand
+   {
+   public:
+      SubstructureSearchCommand (BaseSubstructureMatcher &matcher) : _matcher(matcher)
+      {
+      }
+
+      virtual void clear ()
+      {
+         screening = false;
+         first = last = -1;
+      }
+
+      virtual void execute (OsCommandResult &result);
+
+      bool screening;
+      int first, last;
+      AutoPtr<SubstructureVerifier> verifier;
+
+   private:
+      BaseSubstructureMatcher &_matcher;
+   };
+
+   // Screens fingerprint packs or verifies candidates on the worker threads.
+   // Results are handled in the order of packs/candidates.
+   class SubstructureSearchDispatcher : public OsCommandDispatcher
+   {
+   public:
+      SubstructureSearchDispatcher (BaseSubstructureMatcher &matcher) : 
+         OsCommandDispatcher(HANDLING_ORDER_SERIAL, false), _matcher(matcher)
+      {
+      }
+
+      // Appends candidates from packs [first_pack, last_pack) to the matcher candidates
+      void screen (int first_pack, int last_pack)
+      {
+         _start(true, first_pack, last_pack, 1);
+      }
+
+      // Appends matched ids of candidates [first_cand, last_cand) to the matcher found list
+      void verify (int first_cand, int last_cand)
+      {
+         _start(false, first_cand, last_cand, _verification_chunk_size);
+      }
+
+   protected:
+      virtual OsCommand * _allocateCommand ()
+      {
+         return new SubstructureSearchCommand(_matcher);
+      }
+
+      virtual OsCommandResult * _allocateResult ()
+      {
+         return new SubstructureSearchResult();
+      }
+
+      virtual bool _setupCommand (OsCommand &command)
+      {
+         if (_next >= _end)
+            return false;
+
+         SubstructureSearchCommand &cmd = (SubstructureSearchCommand &)command;
+
+         cmd.screening = _screening;
+         cmd.first = _next;
+         cmd.last = __min(_next + _step, _end);
+         // Query copies are created in the main thread
+         if (!_screening && cmd.verifier.get() == 0)
+            cmd.verifier.reset(_matcher._createVerifier());
+
+         _next = cmd.last;
+         return true;
+      }
+
+      virtual void _handleResult (OsCommandResult &result)
+      {
+         SubstructureSearchResult &res = (SubstructureSearchResult &)result;
+
+         if (_screening)
+         {
+            _matcher._candidates.concat(res.ids);
+            return;
+         }
+
+         int mappings_offset = _matcher._parallel_mappings.size();
+
+         _matcher._parallel_found.concat(res.ids);
+         _matcher._parallel_mappings.concat(res.mappings);
+         for (int i = 0; i < res.mapping_ends.size(); i++)
+            _matcher._parallel_mapping_ends.push(mappings_offset + res.mapping_ends[i]);
+
+         for (int i = 0; i < res.tried; i++)
+         {
+            _matcher._match_probability_esimate.addValue(i < res.ids.size() ? 1.0f : 0.0f);
+            _matcher._match_time_esimate.addValue(res.time_sec / res.tried);
+         }
+      }
+
+      virtual void _prepareThread ()
+      {
+         MMFStorage::setDatabaseId(_database_id);
+      }
+
+   private:
+      BaseSubstructureMatcher &_matcher;
+      bool _screening;
+      int _next, _end, _step;
+      int _database_id;
+
+      void _start (bool screening, int first, int last, int step)
+      {
+         _screening = screening;
+         _next = first;
+         _end = last;
+         _step = step;
+         _database_id = MMFStorage::getDatabaseId();
+
+         run(_matcher._threads_count);
+      }
+   };
+}
+
+void SubstructureSearchCommand::execute (OsCommandResult &result)
+{
+   SubstructureSearchResult &res = (SubstructureSearchResult &)result;
+
+   if (screening)
+   {
+      QS_DEF(Array<int>, pack_candidates);
+
+      for (int pack_idx = first; pack_idx < last; pack_idx++)
+      {
+         _matcher._findPackCandidates(pack_idx, pack_candidates);
+         res.ids.concat(pack_candidates);
+      }
+      return;
+   }
+
+   profTimerStart(tverify, "sub_try_chunk");
+
+   for (int i = first; i < last; i++)
+   {
+      int id = _matcher._candidates[i];
+
+      if (verifier->verify(id, res.mappings))
+      {
+         res.ids.push(id);
+         res.mapping_ends.push(res.mappings.size());
+      }
+   }
+
+   res.tried = last - first;
+   res.time_sec = profTimerGetTimeSec(tverify);
+}
+
 //
 // BaseSubstructureMatcher
 //
@@ -309,10 +523,18 @@ BaseSubstructureMatcher::BaseSubstructureMatcher (/*const */ BaseIndex &index, I
    _final_pack = _fp_storage.getPackCount() + 1;
 
    _cand_count = 0;
+   _parallel_found_id = 0;
+}
+
+BaseSubstructureMatcher::~BaseSubstructureMatcher ()
+{
 }
 
 bool BaseSubstructureMatcher::next ()
 {
+   if (_threads_count > 1)
+      return _nextParallel();
+
    //int fp_size_in_bits = _fp_size * 8;
    static int sub_cnt = 0;
 
@@ -327,7 +549,7 @@ bool BaseSubstructureMatcher::next ()
          _current_pack++;
          if (_current_pack < _final_pack)
          {
-            _findPackCandidates(_current_pack);
+            _findPackCandidates(_current_pack, _candidates);
             _cand_count += _candidates.size();
          }
          else
@@ -364,6 +586,65 @@ bool BaseSubstructureMatcher::next ()
    return false;
 }
 
+bool BaseSubstructureMatcher::_nextParallel ()
+{
+   if (_dispatcher.get() == 0)
+   {
+      _dispatcher.reset(new SubstructureSearchDispatcher(*this));
+      _candidates.clear();
+      _current_cand_id = 0;
+   }
+
+   while (true)
+   {
+      if (_parallel_found_id < _parallel_found.size())
+      {
+         int found_idx = _parallel_found_id++;
+         _current_id = _parallel_found[found_idx];
+
+         if (!_loadCurrentObject())
+            continue;
+
+         int mapping_begin = (found_idx > 0 ? _parallel_mapping_ends[found_idx - 1] : 0);
+         _setPackedMapping(_parallel_mappings.ptr() + mapping_begin,
+                           _parallel_mapping_ends[found_idx] - mapping_begin);
+
+         profIncCounter("sub_found", 1);
+         return true;
+      }
+
+      _parallel_found.clear();
+      _parallel_mappings.clear();
+      _parallel_mapping_ends.clear();
+      _parallel_found_id = 0;
+
+      if (_current_cand_id < _candidates.size())
+      {
+         profTimerStart(tt, "sub_try_parallel");
+         int window_end = __min(_candidates.size(), _current_cand_id + _threads_count * _verification_window_per_thread);
+         _dispatcher->verify(_current_cand_id, window_end);
+         _current_cand_id = window_end;
+         continue;
+      }
+
+      if (_current_pack + 1 >= _final_pack)
+         break;
+
+      profTimerStart(tf, "sub_find_cand_parallel");
+      int first_pack = _current_pack + 1;
+      int last_pack = __min(_final_pack, first_pack + _threads_count);
+
+      _candidates.clear();
+      _current_cand_id = 0;
+      _dispatcher->screen(first_pack, last_pack);
+      _cand_count += _candidates.size();
+      _current_pack = last_pack - 1;
+   }
+
+   profIncCounter("sub_count_cand", _cand_count);
+   return false;
+}
+
 void BaseSubstructureMatcher::setQueryData (SubstructureQueryData *query_data)
 {
    _query_data.reset(query_data);
@@ -371,6 +652,9 @@ void BaseSubstructureMatcher::setQueryData (SubstructureQueryData *query_data)
    const MoleculeFingerprintParameters & fp_params = _index.getFingerprintParams();
    _query_data->getQueryObject().buildFingerprint(fp_params, &_query_fp, 0);
 
+   if (!_query_data->getQueryObject().buildPropertyVector(_query_props))
+      _query_props.clear();
+
    int bit_cnt = bitGetOnesCount(_query_fp.ptr(), _fp_size);
 
    profIncCounter("query_bit_count", bit_cnt);
@@ -391,17 +675,17 @@ void BaseSubstructureMatcher::setQueryData (SubstructureQueryData *query_data)
       });
 }
 
-void BaseSubstructureMatcher::_findPackCandidates (int pack_idx)
+void BaseSubstructureMatcher::_findPackCandidates (int pack_idx, Array<int> &candidates)
 {
    if (pack_idx == _fp_storage.getPackCount())
    {
-      _findIncCandidates();
+      _findIncCandidates(candidates);
       return;
    }
 
    profTimerStart(t, "sub_find_cand_pack");
 
-   _candidates.clear();
+   candidates.clear();
 
    TranspFpStorage &fp_storage = _index.getSubStorage();
 
@@ -410,13 +694,19 @@ void BaseSubstructureMatcher::_findPackCandidates (int pack_idx)
    const byte * block;
    
    int fp_size_in_bits = _fp_size * 8;
+   int block_size = fp_storage.getBlockSize();
+   // Searched range is narrowed by whole aligned lines
+   const int line_size = TranspFpStorage::block_alignment;
 
-   Array<byte> fit_bits;
-   fit_bits.clear_resize(fp_storage.getBlockSize());
-   fit_bits.fill(255);
+   // Fit mask is reused between packs
+   QS_DEF(Array<qword>, fit_words);
+   fit_words.clear_resize((block_size + sizeof(qword) - 1) / sizeof(qword));
+   byte *fit_bits = (byte *)fit_words.ptr();
+   memset(fit_bits, 255, block_size);
 
    profTimerStart(tgs, "sub_find_cand_pack_get_search");
-   int left = 0, right = fp_storage.getBlockSize() - 1;
+   int left = 0, right = block_size;
+   int fit_count = block_size * 8;
 
    // Filter only based on the first 10 bits
    // TODO: collect time infromation about the reading and matching measurements and
@@ -430,30 +720,39 @@ void BaseSubstructureMatcher::_findPackCandidates (int pack_idx)
       profTimerStop(tgb);
 
       profTimerStart(tgu, "sub_find_cand_pack_fit_update");
-      bitAnd(fit_bits.ptr() + left, &block[0] + left, right - left + 1);
+      fit_count = bitAndOnes(fit_bits + left, block + left, right - left);
 
-      while(left <= right && fit_bits[left] == 0)
-         left++;
-      while(left <= right && fit_bits[right] == 0)
-         right--;
-
-      if (left > right)
+      if (fit_count == 0)
          // Not more results
          break;
 
+      while (bitIsAllZero(fit_bits + left, __min(line_size, right - left)))
+         left += line_size;
+
+      int last_line = (right - 1) / line_size * line_size;
+      while (bitIsAllZero(fit_bits + last_line, right - last_line))
+      {
+         right = last_line;
+         last_line -= line_size;
+      }
+
       profTimerStop(tgu);
    }
    profTimerStop(tgs);
    
-   for (int k = 0; k < 8 * fp_storage.getBlockSize(); k++)
-      if (bitGetBit(fit_bits.ptr(), k))
-         _candidates.push(k + pack_idx * fp_storage.getBlockSize() * 8);
+   if (fit_count == 0)
+      return;
+
+   candidates.resize(fit_count);
+   bitGetOnesIndices(fit_bits + left, right - left, (pack_idx * block_size + left) * 8, candidates.ptr());
+
+   _filterCandidates(candidates);
 }
 
-void BaseSubstructureMatcher::_findIncCandidates ()
+void BaseSubstructureMatcher::_findIncCandidates (Array<int> &candidates)
 {
    profTimerStart(t, "sub_find_cand_inc");
-   _candidates.clear();
+   candidates.clear();
 
    const TranspFpStorage &fp_storage = _index.getSubStorage();
 
@@ -463,8 +762,28 @@ void BaseSubstructureMatcher::_findIncCandidates ()
    {
       const byte *fp = inc + i * _fp_size;
       if (bitTestOnes(_query_fp.ptr(), fp, _fp_size))
-         _candidates.push(i + inc_block_id_offset);
+         candidates.push(i + inc_block_id_offset);
    }
+
+   _filterCandidates(candidates);
+}
+
+void BaseSubstructureMatcher::_filterCandidates (Array<int> &candidates)
+{
+   if (_query_props.size() == 0 || !_index.hasPropertyStorage())
+      return;
+
+   profTimerStart(t, "sub_filter_props");
+
+   const PropertyStorage &prop_storage = _index.getPropertyStorage();
+   int count = 0;
+
+   for (int i = 0; i < candidates.size(); i++)
+      if (prop_storage.fits(_query_props.ptr(), candidates[i]))
+         candidates[count++] = candidates[i];
+
+   profIncCounter("sub_filtered_props", candidates.size() - count);
+   candidates.resize(count);
 }
 
 void BaseSubstructureMatcher::_setParameters (const char * params)
@@ -505,6 +824,28 @@ const Array<int> & MoleculeSubMatcher::currentMapping ()
    return _mapping;
 }
 
+void MoleculeSubMatcher::_setPackedMapping (const int *mapping, int size)
+{
+   _mapping.copy(mapping, size);
+}
+
+bool MoleculeSubMatcher::matchMolecule (QueryMolecule &query_mol, Molecule &target_mol, Array<int> *mapping)
+{
+   profTimerStart(tr_m, "sub_try_matching");
+   MoleculeSubstructureMatcher msm(target_mol);
+
+   msm.setQuery(query_mol);
+
+   bool find_res = msm.find();
+   
+   profTimerStop(tr_m);
+   
+   if (find_res && mapping != 0)
+      mapping->copy(msm.getTargetMapping(), target_mol.vertexCount());
+
+   return find_res;
+}
+
 bool MoleculeSubMatcher::_tryCurrent ()// const
 {
    SubstructureMoleculeQuery &query = (SubstructureMoleculeQuery &)(_query_data->getQueryObject());
@@ -518,23 +859,75 @@ bool MoleculeSubMatcher::_tryCurrent ()// const
 
    Molecule &target_mol = _current_obj->getMolecule();
 
-   profTimerStart(tr_m, "sub_try_matching");
-   MoleculeSubstructureMatcher msm(target_mol);
+   return matchMolecule(query_mol, target_mol, &_mapping);
+}
 
-   msm.setQuery(query_mol);
+namespace bingo
+{
+   class MoleculeSubVerifier : public SubstructureVerifier
+   {
+   public:
+      MoleculeSubVerifier (BaseIndex &index, QueryMolecule &query_mol) : _index(index)
+      {
+         _query_mol.clone(query_mol, 0, 0);
+      }
 
-   bool find_res = msm.find();
-   
-   profTimerStop(tr_m);
-   
-   if (find_res)
+      virtual bool verify (int id, Array<int> &mappings)
+      {
+         if (!BaseMatcher::loadObject(_index, id, _target))
+            return false;
+
+         if (!MoleculeSubMatcher::matchMolecule(_query_mol, _target.getMolecule(), &_mapping))
+            return false;
+
+         mappings.concat(_mapping);
+         return true;
+      }
+
+   private:
+      BaseIndex &_index;
+      QueryMolecule _query_mol;
+      IndigoMolecule _target;
+      Array<int> _mapping;
+   };
+
+   class ReactionSubVerifier : public SubstructureVerifier
    {
-      _mapping.copy(msm.getTargetMapping(), target_mol.vertexCount());
-      return true;
-   }
+   public:
+      ReactionSubVerifier (BaseIndex &index, QueryReaction &query_rxn) : _index(index)
+      {
+         _query_rxn.clone(query_rxn, 0, 0, 0);
+      }
 
-   //return true;
-   return false;
+      virtual bool verify (int id, Array<int> &mappings)
+      {
+         if (!BaseMatcher::loadObject(_index, id, _target))
+            return false;
+
+         if (!ReactionSubMatcher::matchReaction(_query_rxn, _target.getReaction(), &_mapping))
+            return false;
+
+         for (int i = 0; i < _mapping.size(); i++)
+         {
+            mappings.push(_mapping[i].size());
+            mappings.concat(_mapping[i]);
+         }
+         return true;
+      }
+
+   private:
+      BaseIndex &_index;
+      QueryReaction _query_rxn;
+      IndigoReaction _target;
+      ObjArray<Array<int> > _mapping;
+   };
+}
+
+SubstructureVerifier * MoleculeSubMatcher::_createVerifier ()
+{
+   SubstructureMoleculeQuery &query = (SubstructureMoleculeQuery &)(_query_data->getQueryObject());
+
+   return new MoleculeSubVerifier(_index, (QueryMolecule &)query.getMolecule());
 }
    
 ReactionSubMatcher::ReactionSubMatcher (/*const */ BaseIndex &index) : BaseSubstructureMatcher(index, (IndigoObject *&)_current_rxn), _current_rxn(new IndexCurrentReaction(_current_rxn))
@@ -547,40 +940,68 @@ const ObjArray<Array<int> > & ReactionSubMatcher::currentMapping ()
    return _mapping;
 }
 
-bool ReactionSubMatcher::_tryCurrent ()// const
+void ReactionSubMatcher::_setPackedMapping (const int *mapping, int size)
 {
-   SubstructureReactionQuery &query = (SubstructureReactionQuery &)_query_data->getQueryObject();
-   QueryReaction &query_rxn = (QueryReaction &)(query.getReaction());
+   // Mapping of each target molecule is packed as its size followed by the items
+   int pos = 0;
 
-   if (!_loadCurrentObject())
-      return false;
-
-   if (_current_obj == 0)
-      throw Exception("ReactionSubMatcher: Matcher's current object was destroyed");
+   _mapping.clear();
+   while (pos < size)
+   {
+      Array<int> &mol_mapping = _mapping.push();
 
-   Reaction &target_rxn = _current_obj->getReaction();
+      mol_mapping.copy(mapping + pos + 1, mapping[pos]);
+      pos += mapping[pos] + 1;
+   }
+}
 
+bool ReactionSubMatcher::matchReaction (QueryReaction &query_rxn, Reaction &target_rxn, ObjArray<Array<int> > *mapping)
+{
    ReactionSubstructureMatcher rsm(target_rxn);
 
    rsm.setQuery(query_rxn);
 
-   if (rsm.find())
+   if (!rsm.find())
+      return false;
+
+   if (mapping != 0)
    {
-      _mapping.resize(target_rxn.end());
+      mapping->resize(target_rxn.end());
       for (int i = target_rxn.begin(); i != target_rxn.end(); i = target_rxn.next(i))
-         _mapping[i].clear();
+         (*mapping)[i].clear();
 
       for (int i = query_rxn.begin(); i != query_rxn.end(); i = query_rxn.next(i))
       {
          int target_mol_idx = rsm.getTargetMoleculeIndex(i);
 
-         _mapping[target_mol_idx].copy(rsm.getQueryMoleculeMapping(i), query_rxn.getQueryMolecule(i).vertexCount());
+         (*mapping)[target_mol_idx].copy(rsm.getQueryMoleculeMapping(i), query_rxn.getQueryMolecule(i).vertexCount());
       }
-
-      return true;
    }
 
-   return false;
+   return true;
+}
+
+bool ReactionSubMatcher::_tryCurrent ()// const
+{
+   SubstructureReactionQuery &query = (SubstructureReactionQuery &)_query_data->getQueryObject();
+   QueryReaction &query_rxn = (QueryReaction &)(query.getReaction());
+
+   if (!_loadCurrentObject())
+      return false;
+
+   if (_current_obj == 0)
+      throw Exception("ReactionSubMatcher: Matcher's current object was destroyed");
+
+   Reaction &target_rxn = _current_obj->getReaction();
+
+   return matchReaction(query_rxn, target_rxn, &_mapping);
+}
+
+SubstructureVerifier * ReactionSubMatcher::_createVerifier ()
+{
+   SubstructureReactionQuery &query = (SubstructureReactionQuery &)_query_data->getQueryObject();
+
+   return new ReactionSubVerifier(_index, (QueryReaction &)query.getReaction());
 }
 
 BaseSimilarityMatcher::BaseSimilarityMatcher (/*const */ BaseIndex &index, IndigoObject *& current_obj ) : BaseMatcher(index, current_obj)
@@ -597,10 +1018,15 @@ BaseSimilarityMatcher::BaseSimilarityMatcher (/*const */ BaseIndex &index, Indig
    _current_sim_value = -1;
    _fp_size = _index.getFingerprintParams().fingerprintSizeSim();
    _sim_coef.reset(new TanimotoCoef(_fp_size));
+   _top_n = -1;
+   _top_n_found = false;
 }
 
 bool BaseSimilarityMatcher::next ()
 {
+   if (_top_n > 0)
+      return _nextTopN();
+
    profTimerStart(tsimnext, "sim_next");
    
    SimStorage &sim_storage = _index.getSimStorage();
@@ -701,6 +1127,157 @@ void BaseSimilarityMatcher::setQueryData (SimilarityQueryData *query_data)
       _containers_count += sim_storage.getCellSize(i);
 }
 
+void BaseSimilarityMatcher::setTopN (int limit)
+{
+   if (limit <= 0)
+      throw Exception("BaseSimilarityMatcher: setTopN: limit should be positive");
+
+   _top_n = limit;
+   _top_n_found = false;
+}
+
+// Heap order for the top-N results: better results are "less",
+// so the worst kept result is on the top of the heap
+static bool _simResultBetter (const SimResult &r1, const SimResult &r2)
+{
+   if (r1.sim_value != r2.sim_value)
+      return r1.sim_value > r2.sim_value;
+   return r1.id < r2.id;
+}
+
+static int _cmpCellsByBound (int cell1, int cell2, void *context)
+{
+   const Array<double> &bounds = *(const Array<double> *)context;
+
+   if (bounds[cell1] != bounds[cell2])
+      return bounds[cell1] > bounds[cell2] ? -1 : 1;
+   return cell1 - cell2;
+}
+
+bool BaseSimilarityMatcher::_nextTopN ()
+{
+   if (!_top_n_found)
+   {
+      _findTopN();
+      _top_n_found = true;
+   }
+
+   if (_current_portion_id >= _current_portion.size())
+      return false;
+
+   _current_id = _current_portion[_current_portion_id].id;
+   _current_sim_value = _current_portion[_current_portion_id].sim_value;
+   _current_portion_id++;
+
+   _loadCurrentObject();
+   return true;
+}
+
+void BaseSimilarityMatcher::_findTopN ()
+{
+   profTimerStart(t, "sim_find_top_n");
+
+   SimStorage &sim_storage = _index.getSimStorage();
+
+   QS_DEF(Array<SimResult>, heap);
+   QS_DEF(Array<SimResult>, cont_results);
+   heap.clear();
+
+   bool partitioned = (_part_count != -1 && _part_id != -1);
+
+   if (sim_storage.isSmallBase())
+   {
+      // There are no cells, so the first part searches the whole base
+      if (!partitioned || _part_id == 1)
+      {
+         cont_results.clear();
+         sim_storage.getIncSimilar(_query_fp.ptr(), _sim_coef.ref(), 0, cont_results);
+         _addTopNResults(heap, cont_results);
+      }
+   }
+   else
+   {
+      int query_bit_count = bitGetOnesCount(_query_fp.ptr(), _fp_size);
+      int cell_count = sim_storage.getCellCount();
+
+      // Cells are walked in the descending order of their upper bounds.
+      // Cells of a part are selected the same way as in next().
+      QS_DEF(Array<double>, bounds);
+      QS_DEF(Array<int>, cells);
+      bounds.clear_resize(cell_count);
+      cells.clear();
+      for (int i = 0; i < cell_count; i++)
+      {
+         bounds[i] = sim_storage.getCellUpperBound(query_bit_count, _sim_coef.ref(), i);
+         if (!partitioned || i % _part_count == _part_id - 1)
+            cells.push(i);
+      }
+      cells.qsort(_cmpCellsByBound, &bounds);
+
+      bool pruned = false;
+
+      for (int i = 0; i < cells.size() && !pruned; i++)
+      {
+         int cell = cells[i];
+         int cont_count = sim_storage.getCellSize(cell);
+
+         for (int cont = 0; cont < cont_count; cont++)
+         {
+            // Threshold is tightened while the heap is full. It is lowered
+            // a bit to keep results equal to the worst one for the id order.
+            double min_coef = 0;
+            if (heap.size() == _top_n)
+               min_coef = heap[0].sim_value - EPSILON;
+
+            if (bounds[cell] < min_coef)
+            {
+               // The rest cells have lower bounds too
+               pruned = true;
+               break;
+            }
+
+            cont_results.clear();
+            sim_storage.getSimilar(_query_fp.ptr(), _sim_coef.ref(), min_coef, cont_results, cell, cont);
+            _addTopNResults(heap, cont_results);
+         }
+      }
+   }
+
+   std::sort_heap(heap.ptr(), heap.ptr() + heap.size(), _simResultBetter);
+
+   _current_portion.copy(heap);
+   _current_portion_id = 0;
+}
+
+void BaseSimilarityMatcher::_addTopNResults (Array<SimResult> &heap, const Array<SimResult> &results)
+{
+   ByteBufferStorage &cf_storage = _index.getCfStorage();
+
+   for (int i = 0; i < results.size(); i++)
+   {
+      const SimResult &res = results[i];
+
+      if (heap.size() == _top_n && !_simResultBetter(res, heap[0]))
+         continue;
+
+      // Skip deleted objects
+      int cf_len;
+      cf_storage.get(res.id, cf_len);
+      if (cf_len == -1)
+         continue;
+
+      if (heap.size() == _top_n)
+      {
+         std::pop_heap(heap.ptr(), heap.ptr() + heap.size(), _simResultBetter);
+         heap.top() = res;
+      }
+      else
+         heap.push(res);
+
+      std::push_heap(heap.ptr(), heap.ptr() + heap.size(), _simResultBetter);
+   }
+}
+
 void BaseSimilarityMatcher::_setParameters (const char *parameters)
 {
    if (_query_data.get() != 0)
@@ -766,6 +1343,12 @@ void BaseSimilarityMatcher::_initPartition ()
 
 int BaseSimilarityMatcher::esimateRemainingResultsCount (int &delta)
 {
+   if (_top_n > 0)
+   {
+      delta = 0;
+      return _top_n_found ? _current_portion.size() - _current_portion_id : _top_n;
+   }
+
    int left_cont_count = _containers_count - _match_probability_esimate.getCount();
 
    float error = _match_probability_esimate.meanEsimationError();
@@ -776,6 +1359,12 @@ int BaseSimilarityMatcher::esimateRemainingResultsCount (int &delta)
 
 float BaseSimilarityMatcher::esimateRemainingTime (float &delta)
 {
+   if (_top_n > 0)
+   {
+      delta = 0;
+      return 0;
+   }
+
    _match_time_esimate.setCount(_match_probability_esimate.getCount());
       
    int left_cont_count = _containers_count - _match_probability_esimate.getCount();
@@ -194,6 +194,9 @@ namespace bingo
       virtual int esimateRemainingResultsCount (int &delta);
       virtual float esimateRemainingTime (float &delta);
 
+      // Loads object with the specified storage id into obj. Returns false if object was removed.
+      static bool loadObject (BaseIndex &index, int id, IndigoObject &obj);
+
    protected:
       BaseIndex &_index;
       IndigoObject *& _current_obj;
@@ -201,6 +204,7 @@ namespace bingo
       int _current_id;
       int _part_id;
       int _part_count;
+      int _threads_count;
 
       // Variables used for estimation
       MeanEstimator _match_probability_esimate, _match_time_esimate;
@@ -211,14 +215,31 @@ namespace bingo
 
       virtual void _setParameters (const char * params) = 0;
       virtual void _initPartition () = 0;
+      // Only substructure search runs on several threads
+      virtual bool _isThreadsSupported () { return false; }
       
       ~BaseMatcher ();
    };
 
+   class SubstructureSearchDispatcher;
+
+   // Candidates verifier for the multithreaded substructure search.
+   // Each worker thread owns a verifier with its own copy of the query.
+   class SubstructureVerifier
+   {
+   public:
+      // Appends the packed mapping of a matched object to mappings
+      virtual bool verify (int id, Array<int> &mappings) = 0;
+
+      virtual ~SubstructureVerifier () {};
+   };
+
    class BaseSubstructureMatcher : public BaseMatcher
    {
    public:
       BaseSubstructureMatcher (/*const */ BaseIndex &index, IndigoObject *& current_obj);
+
+      ~BaseSubstructureMatcher ();
    
       virtual bool next ();
 
@@ -230,23 +251,49 @@ namespace bingo
       /*const*/ AutoPtr<SubstructureQueryData> _query_data;
       Array<byte> _query_fp;
       Array<int> _query_fp_bits_used;
+      // Empty if the query can't be screened by the property vectors
+      Array<byte> _query_props;
+
+      void _findPackCandidates (int pack_idx, Array<int> &candidates);
 
-      void _findPackCandidates (int pack_idx);
+      void _findIncCandidates (Array<int> &candidates);
 
-      void _findIncCandidates ();
+      void _filterCandidates (Array<int> &candidates);
 
       virtual bool _tryCurrent ()/* const */ = 0;
 
+      virtual SubstructureVerifier * _createVerifier () = 0;
+
+      // Sets the mapping of the current object found by a worker thread
+      virtual void _setPackedMapping (const int *mapping, int size) = 0;
+
       virtual void _setParameters (const char * params);
 
       virtual void _initPartition ();
 
+      virtual bool _isThreadsSupported () { return true; }
+
    private:
+      friend class SubstructureSearchDispatcher;
+      friend class SubstructureSearchCommand;
+
       Array<int> _candidates;
       int _current_cand_id;
       int _current_pack;
       int _final_pack;
       const TranspFpStorage &_fp_storage;
+
+      // Multithreaded mode: candidates are verified in windows and
+      // matched ids are returned in the same order as in the serial mode
+      Array<int> _parallel_found;
+      int _parallel_found_id;
+      // Packed mappings of the found ids, _parallel_mapping_ends[i] is
+      // the end of the mapping of _parallel_found[i]
+      Array<int> _parallel_mappings;
+      Array<int> _parallel_mapping_ends;
+      AutoPtr<SubstructureSearchDispatcher> _dispatcher;
+
+      bool _nextParallel ();
    };
 
    class MoleculeSubMatcher : public BaseSubstructureMatcher
@@ -255,11 +302,17 @@ namespace bingo
       MoleculeSubMatcher (/*const */ BaseIndex &index);
 
       const Array<int> & currentMapping ();
+
+      static bool matchMolecule (QueryMolecule &query_mol, Molecule &target_mol, Array<int> *mapping);
    private:
       Array<int> _mapping;
 
       virtual bool _tryCurrent () /*const*/;
 
+      virtual SubstructureVerifier * _createVerifier ();
+
+      virtual void _setPackedMapping (const int *mapping, int size);
+
       IndexCurrentMolecule *_current_mol;
    };
    
@@ -269,11 +322,17 @@ namespace bingo
       ReactionSubMatcher(/*const */ BaseIndex &index);
 
       const ObjArray<Array<int> > & currentMapping ();
+
+      static bool matchReaction (QueryReaction &query_rxn, Reaction &target_rxn, ObjArray<Array<int> > *mapping);
    private:
       ObjArray<Array<int> > _mapping;
 
       virtual bool _tryCurrent () /*const*/;
 
+      virtual SubstructureVerifier * _createVerifier ();
+
+      virtual void _setPackedMapping (const int *mapping, int size);
+
       IndexCurrentReaction *_current_rxn;
    };
 
@@ -292,6 +351,10 @@ namespace bingo
       virtual float esimateRemainingTime (float &delta);
 
       virtual float currentSimValue ();
+
+      // Switches the matcher to return the limit most similar objects
+      // in the descending order of the similarity value
+      void setTopN (int limit);
       
    private:
       /* const */ AutoPtr<SimilarityQueryData> _query_data;
@@ -316,9 +379,16 @@ namespace bingo
       const byte *_cur_loc;
       Array<byte> _query_fp;
 
+      int _top_n;
+      bool _top_n_found;
+
       virtual void _setParameters (const char * params);
 
       virtual void _initPartition ();
+
+      bool _nextTopN ();
+      void _findTopN ();
+      void _addTopNResults (Array<SimResult> &heap, const Array<SimResult> &results);
    };
 
 
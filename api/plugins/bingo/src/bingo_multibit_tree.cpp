@@ -154,8 +154,9 @@ void MultibitTree::_findLinear (_MultibitNode *node, const byte *query, int quer
    {
       const byte *fp = fingerprints + fp_indices[i] * _fp_size;
       int f_bit_number = bitGetOnesCount(fp, _fp_size);
+      int common_bits = bitCommonOnes(query, fp, _fp_size);
 
-      double coef = sim_coef.calcCoef(query, fp, query_bit_number, f_bit_number);
+      double coef = sim_coef.calcCoef(query_bit_number, f_bit_number, common_bits);
       if (coef < min_coef)
          continue;
 
@@ -1,6 +1,7 @@
 #include "bingo_object.h"
 #include "bingo_exact_storage.h"
 #include "bingo_gross_storage.h"
+#include "bingo_prop_storage.h"
 
 #include "reaction/reaction.h"
 #include "reaction/query_reaction.h"
@@ -43,6 +44,14 @@ bool BaseMoleculeQuery::buildFingerprint (const MoleculeFingerprintParameters &f
 
    return true;
 }
+
+bool BaseMoleculeQuery::buildPropertyVector (Array<byte> &vector)
+{
+   vector.clear_resize(PropertyStorage::VECTOR_SIZE);
+   PropertyStorage::calculateMolVector(_base_mol, vector.ptr());
+
+   return true;
+}
       
 const BaseMolecule & BaseMoleculeQuery::getMolecule ()
 {
@@ -69,6 +78,11 @@ bool GrossQuery::buildFingerprint (const MoleculeFingerprintParameters &fp_param
    throw Exception("GrossQuery::buildFingerprint can\t be called");
 }
 
+bool GrossQuery::buildPropertyVector (Array<byte> &vector)
+{
+   return false;
+}
+
 Array<char> &GrossQuery::getGrossString()
 {
    return _gross_str;
@@ -95,6 +109,12 @@ bool BaseReactionQuery::buildFingerprint (const MoleculeFingerprintParameters &f
    return true;
 }
 
+bool BaseReactionQuery::buildPropertyVector (Array<byte> &vector)
+{
+   // Several query molecules can match the same target molecule
+   return false;
+}
+
 const BaseReaction & BaseReactionQuery::getReaction()
 {
    return _base_rxn;
@@ -156,6 +176,14 @@ bool IndexMolecule::buildHash (dword &hash)
    return true;
 }
 
+bool IndexMolecule::buildPropertyVector (Array<byte> &vector)
+{
+   vector.clear_resize(PropertyStorage::VECTOR_SIZE);
+   PropertyStorage::calculateMolVector(_mol, vector.ptr());
+
+   return true;
+}
+
 IndexReaction::IndexReaction (/* const */ Reaction &rxn)
 {
    _rxn.clone(rxn, 0, 0, 0);
@@ -204,3 +232,13 @@ bool IndexReaction::buildHash (dword &hash)
    return true;
 }
 
+bool IndexReaction::buildPropertyVector (Array<byte> &vector)
+{
+   // Reaction queries are not screened by the property vectors,
+   // so an empty vector just keeps the storage ids aligned
+   vector.clear_resize(PropertyStorage::VECTOR_SIZE);
+   vector.zerofill();
+
+   return true;
+}
+
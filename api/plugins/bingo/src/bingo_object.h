@@ -25,6 +25,8 @@ namespace bingo
    {
    public:
       virtual bool buildFingerprint (const MoleculeFingerprintParameters &fp_params, Array<byte> *sub_fp, Array<byte> *sim_fp)/* const */ = 0;
+      // Returns false if the query can't be screened by the property vectors
+      virtual bool buildPropertyVector (Array<byte> &vector) = 0;
       virtual ~QueryObject () {};
    };
 
@@ -43,6 +45,8 @@ namespace bingo
       BaseMoleculeQuery (BaseMolecule &mol, bool needs_query_fingerprint);
 
       virtual bool buildFingerprint (const MoleculeFingerprintParameters &fp_params, Array<byte> *sub_fp, Array<byte> *sim_fp) /*const*/;
+
+      virtual bool buildPropertyVector (Array<byte> &vector);
       
       const BaseMolecule &getMolecule ();
    };
@@ -71,6 +75,8 @@ namespace bingo
       Array<char> _gross_str;
 
       virtual bool buildFingerprint (const MoleculeFingerprintParameters &fp_params, Array<byte> *sub_fp, Array<byte> *sim_fp) /*const*/;
+
+      virtual bool buildPropertyVector (Array<byte> &vector);
       
    public:
       GrossQuery (/* const */ Array<char> &str);
@@ -92,6 +98,8 @@ namespace bingo
 
       virtual bool buildFingerprint (const MoleculeFingerprintParameters &fp_params, Array<byte> *sub_fp, Array<byte> *sim_fp) /*const*/;
 
+      virtual bool buildPropertyVector (Array<byte> &vector);
+
       const BaseReaction &getReaction ();
    };
 
@@ -124,6 +132,8 @@ namespace bingo
 
       virtual bool buildHash (dword &hash)/* const */ = 0;
 
+      virtual bool buildPropertyVector (Array<byte> &vector)/* const */ = 0;
+
       virtual ~IndexObject () {};
    };
 
@@ -142,6 +152,8 @@ namespace bingo
       virtual bool buildCfString (Array<char> &cf) /*const*/;
 
       virtual bool buildHash (dword &hash)/* const */;
+
+      virtual bool buildPropertyVector (Array<byte> &vector)/* const */;
    };
 
    class IndexReaction : public IndexObject
@@ -159,6 +171,8 @@ namespace bingo
       virtual bool buildCfString (Array<char> &cf) /*const*/;
 
       virtual bool buildHash (dword &hash)/* const */;
+
+      virtual bool buildPropertyVector (Array<byte> &vector)/* const */;
    };
 };
 
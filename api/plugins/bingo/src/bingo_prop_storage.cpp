@@ -0,0 +1,155 @@
+#include "bingo_prop_storage.h"
+
+#include "base_cpp/array.h"
+#include "base_cpp/profiling.h"
+#include "molecule/elements.h"
+
+using namespace indigo;
+using namespace bingo;
+
+// Counter positions in the vector
+enum
+{
+   _HEAVY_ATOMS = 0,
+   _FIRST_ELEMENT = 1, // the elements from _elements follow
+   _OTHER_ELEMENTS = 10,
+   _BONDS = 11,
+   _BRANCHING_ATOMS = 12,
+   _RINGS = 13,
+   _POSITIVE_ATOMS = 14,
+   _NEGATIVE_ATOMS = 15
+};
+
+static const int _elements[] = {ELEM_C, ELEM_N, ELEM_O, ELEM_S, ELEM_P, ELEM_F, ELEM_Cl, ELEM_Br, ELEM_I};
+
+static const qword _high_bits = 0x8080808080808080ULL;
+
+BingoAddr PropertyStorage::create (BingoPtr<PropertyStorage> &ptr)
+{
+   ptr.allocate();
+   new (ptr.ptr()) PropertyStorage();
+
+   return (BingoAddr)ptr;
+}
+
+void PropertyStorage::load (BingoPtr<PropertyStorage> &ptr, BingoAddr offset)
+{
+   ptr = BingoPtr<PropertyStorage>(offset);
+}
+
+void PropertyStorage::add (const byte *vector)
+{
+   memcpy(_vectors.push().words, vector, VECTOR_SIZE);
+}
+
+int PropertyStorage::size () const
+{
+   return _vectors.size();
+}
+
+bool PropertyStorage::fits (const byte *query_vector, int id) const
+{
+   if (id < 0 || id >= _vectors.size())
+      return true;
+
+   return vectorFits(query_vector, (const byte *)_vectors[id].words);
+}
+
+bool PropertyStorage::vectorFits (const byte *query_vector, const byte *target_vector)
+{
+   for (int i = 0; i < VECTOR_SIZE; i += sizeof(qword))
+   {
+      qword q, t;
+
+      memcpy(&q, query_vector + i, sizeof(qword));
+      memcpy(&t, target_vector + i, sizeof(qword));
+
+      // The high bit of every byte of (t | 0x80) - q stays set iff t >= q,
+      // and there are no borrows between the bytes because q <= 127
+      if ((((t | _high_bits) - q) & _high_bits) != _high_bits)
+         return false;
+   }
+
+   return true;
+}
+
+void PropertyStorage::calculateMolVector (BaseMolecule &mol, byte *vector)
+{
+   QS_DEF(Array<int>, counts);
+   QS_DEF(Array<int>, component);
+   QS_DEF(Array<int>, heavy_degree);
+
+   counts.clear_resize(VECTOR_SIZE);
+   counts.zerofill();
+   component.clear_resize(mol.vertexEnd());
+   heavy_degree.clear_resize(mol.vertexEnd());
+
+   // Only atoms with a definite element other than hydrogen are counted.
+   // For a query it is the lower bound of the matching target atoms, and
+   // pseudoatoms, R-sites and hydrogens are skipped in both of them.
+   for (int i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
+   {
+      int number = mol.getAtomNumber(i);
+
+      heavy_degree[i] = 0;
+      if (number <= ELEM_H || number >= ELEM_MAX)
+      {
+         component[i] = -1;
+         continue;
+      }
+
+      component[i] = i;
+      counts[_HEAVY_ATOMS]++;
+
+      int k;
+
+      for (k = 0; k < NELEM(_elements); k++)
+         if (_elements[k] == number)
+            break;
+      counts[k < NELEM(_elements) ? _FIRST_ELEMENT + k : _OTHER_ELEMENTS]++;
+
+      int charge = mol.getAtomCharge(i);
+
+      if (charge != CHARGE_UNKNOWN && charge > 0)
+         counts[_POSITIVE_ATOMS]++;
+      else if (charge != CHARGE_UNKNOWN && charge < 0)
+         counts[_NEGATIVE_ATOMS]++;
+   }
+
+   // Number of independent rings is E - V + C of the counted subgraph
+   int components = counts[_HEAVY_ATOMS];
+
+   for (int i = mol.edgeBegin(); i != mol.edgeEnd(); i = mol.edgeNext(i))
+   {
+      const Edge &edge = mol.getEdge(i);
+
+      if (component[edge.beg] < 0 || component[edge.end] < 0)
+         continue;
+
+      counts[_BONDS]++;
+      heavy_degree[edge.beg]++;
+      heavy_degree[edge.end]++;
+
+      int c1 = edge.beg, c2 = edge.end;
+
+      while (component[c1] != c1)
+         c1 = component[c1] = component[component[c1]];
+      while (component[c2] != c2)
+         c2 = component[c2] = component[component[c2]];
+
+      if (c1 != c2)
+      {
+         component[c1] = c2;
+         components--;
+      }
+   }
+
+   for (int i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
+      if (heavy_degree[i] >= 3)
+         counts[_BRANCHING_ATOMS]++;
+
+   counts[_RINGS] = counts[_BONDS] - counts[_HEAVY_ATOMS] + components;
+
+   for (int i = 0; i < VECTOR_SIZE; i++)
+      vector[i] = (byte)__min(counts[i], (int)MAX_COUNT);
+}
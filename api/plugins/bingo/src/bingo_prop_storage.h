@@ -0,0 +1,51 @@
+#ifndef __bingo_prop_storage__
+#define __bingo_prop_storage__
+
+#include "molecule/base_molecule.h"
+#include "bingo_ptr.h"
+
+using namespace indigo;
+
+namespace bingo
+{
+   // Storage of small per-object counters (atoms of the common elements,
+   // bonds, rings, charges). Every counter of a substructure query can't
+   // exceed the same counter of a matching target, so the candidates
+   // passed the fingerprint screening can be rejected without loading.
+   class PropertyStorage
+   {
+   public:
+      enum
+      {
+         VECTOR_SIZE = 16,
+         // Counters are saturated to 7 bits for the comparison of all
+         // counters at once by the byte-wise subtraction
+         MAX_COUNT = 127
+      };
+
+      static BingoAddr create (BingoPtr<PropertyStorage> &ptr);
+
+      static void load (BingoPtr<PropertyStorage> &ptr, BingoAddr offset);
+
+      void add (const byte *vector);
+
+      int size () const;
+
+      // Returns false if the object with the given storage id can't contain the query
+      bool fits (const byte *query_vector, int id) const;
+
+      static bool vectorFits (const byte *query_vector, const byte *target_vector);
+
+      static void calculateMolVector (BaseMolecule &mol, byte *vector);
+
+   private:
+      struct _Vector
+      {
+         qword words[VECTOR_SIZE / sizeof(qword)];
+      };
+
+      BingoArray<_Vector> _vectors;
+   };
+};
+
+#endif // __bingo_prop_storage__
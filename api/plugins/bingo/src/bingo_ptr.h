@@ -106,7 +106,8 @@ namespace bingo
          return (_addr.offset == (size_t)-1) && (_addr.file_id == (size_t)-1);
       }
 
-      void allocate ( int count = 1 );
+      // Alignment is relative to the file start that is page-aligned
+      void allocate ( int count = 1, int alignment = 1 );
 
       operator BingoAddr() const { return _addr; }
    private:
@@ -466,7 +467,7 @@ namespace bingo
      
       static void _load (const char *filename, size_t alloc_off, ObjArray<MMFile> *mm_files, int index_id, bool read_only);
 
-      template<typename T> BingoAddr allocate ( int count = 1 )
+      template<typename T> BingoAddr allocate ( int count = 1, int alignment = 1 )
       {
          byte * mmf_ptr = (byte *)_mm_files->at(0).ptr();
 
@@ -475,15 +476,16 @@ namespace bingo
          size_t alloc_size = sizeof(T) * count;
          
          size_t file_idx = allocator_data->_cur_file_id;
-         size_t file_off = allocator_data->_free_off;
+         size_t file_off = _alignOffset(allocator_data->_free_off, alignment);
          size_t file_size = _mm_files->at((int)file_idx).size();
          
-         if (alloc_size > file_size - file_off)
+         if (file_off > file_size || alloc_size > file_size - file_off)
             _addFile(alloc_size);
 
          file_idx = allocator_data->_cur_file_id;
          file_size = _mm_files->at((int)file_idx).size();
 
+         allocator_data->_free_off = _alignOffset(allocator_data->_free_off, alignment);
          size_t res_off = allocator_data->_free_off;
          size_t res_id = allocator_data->_cur_file_id;
          allocator_data->_free_off += alloc_size;
@@ -494,6 +496,11 @@ namespace bingo
          return BingoAddr(res_id, res_off);
       }
 
+      static size_t _alignOffset (size_t offset, int alignment)
+      {
+         return (offset + alignment - 1) / alignment * alignment;
+      }
+
       static BingoAllocator *_getInstance ();
 
       byte * _get (size_t file_id, size_t offset);
@@ -525,11 +532,11 @@ namespace bingo
    }
 
    template <typename T>
-   void BingoPtr<T>::allocate ( int count )
+   void BingoPtr<T>::allocate ( int count, int alignment )
    {
       BingoAllocator *_allocator = BingoAllocator::_getInstance();
 
-      _addr = _allocator->allocate<T>(count);
+      _addr = _allocator->allocate<T>(count, alignment);
    }
 };
 
@@ -26,6 +26,9 @@ namespace bingo
 
       virtual double calcCoef (const byte *target, const byte *query, int target_bit_count, int query_bit_count ) = 0;
 
+      // Coefficient from the precomputed bit counts (e.g. by bitCommonOnesBlock)
+      virtual double calcCoef (int target_bit_count, int query_bit_count, int common_bits ) = 0;
+
       virtual double calcUpperBound (int query_bit_count, int min_target_bit_count, int max_target_bit_count ) = 0;
 
       virtual double calcUpperBound (int query_bit_count, int min_target_bit_count, int max_target_bit_count, int m10, int m01 ) = 0;
@@ -80,6 +80,13 @@ void SimStorage::getCellsInterval (const byte *query, SimCoef &sim_coef, double
    _fingerprint_table->getCellsInterval (query, sim_coef, min_coef, min_cell, max_cell);
 }
 
+double SimStorage::getCellUpperBound (int query_bit_count, SimCoef &sim_coef, int cell_idx) const
+{
+   if ((BingoAddr)_fingerprint_table == BingoAddr::bingo_null)
+      throw Exception("SimStorage: fingerptint table wasn't built");
+
+   return _fingerprint_table->getCellUpperBound(query_bit_count, sim_coef, cell_idx);
+}
       
 int SimStorage::firstFitCell (int query_bit_count, int min_cell, int max_cell) const
 {
@@ -115,9 +122,19 @@ bool SimStorage::isSmallBase ()
 
 int SimStorage::getIncSimilar (const byte *query, SimCoef &sim_coef, double min_coef, Array<SimResult> &sim_fp_indices)
 {
+   int query_bit_count = bitGetOnesCount(query, _fp_size);
+
+   QS_DEF(Array<int>, fp_bit_counts);
+   QS_DEF(Array<int>, common_bits);
+   fp_bit_counts.clear_resize(_inc_fp_count);
+   common_bits.clear_resize(_inc_fp_count);
+
+   bitGetOnesCountBlock(_inc_buffer.ptr(), _fp_size, _inc_fp_count, fp_bit_counts.ptr());
+   bitCommonOnesBlock(query, _inc_buffer.ptr(), _fp_size, _inc_fp_count, common_bits.ptr());
+
    for (int i = 0; i < _inc_fp_count; i++)
    {
-      double coef = sim_coef.calcCoef(_inc_buffer.ptr() + (i * _fp_size), query, -1, -1);
+      double coef = sim_coef.calcCoef(fp_bit_counts[i], query_bit_count, common_bits[i]);
       if (coef < min_coef)
          continue;
       size_t id = _inc_id_buffer[i];
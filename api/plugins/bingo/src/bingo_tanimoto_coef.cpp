@@ -9,9 +9,18 @@ TanimotoCoef::TanimotoCoef( int fp_size ) : _fp_size(fp_size)
 double TanimotoCoef::calcCoef (const byte *target, const byte *query, int target_bit_count, int query_bit_count )
 {
    int common_bits = bitCommonOnes(target, query, _fp_size);
-   int unique_bits = bitDifferentOnes(target, query, _fp_size);
-   
-   return (double)common_bits / (common_bits + unique_bits);
+
+   if (target_bit_count == -1)
+      target_bit_count = bitGetOnesCount(target, _fp_size);
+   if (query_bit_count == -1)
+      query_bit_count = bitGetOnesCount(query, _fp_size);
+
+   return calcCoef(target_bit_count, query_bit_count, common_bits);
+}
+
+double TanimotoCoef::calcCoef (int target_bit_count, int query_bit_count, int common_bits )
+{
+   return (double)common_bits / (target_bit_count + query_bit_count - common_bits);
 }
 
 
@@ -16,6 +16,8 @@ namespace bingo
 
       double calcCoef (const byte *target, const byte *query, int target_bit_count, int query_bit_count );
 
+      double calcCoef (int target_bit_count, int query_bit_count, int common_bits );
+
       double calcUpperBound (int query_bit_count, int min_target_bit_count, int max_target_bit_count );
 
       double calcUpperBound (int query_bit_count, int min_target_bit_count, int max_target_bit_count, int m10, int m01 );
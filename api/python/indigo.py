@@ -16,7 +16,7 @@ import sys
 import os
 import platform
 from array import array
-from ctypes import c_int, c_char_p, c_float, POINTER, pointer, CDLL, RTLD_GLOBAL, c_ulonglong, c_byte, c_double
+from ctypes import c_int, c_char_p, c_float, POINTER, pointer, CDLL, RTLD_GLOBAL, c_ulonglong, c_byte, c_ubyte, c_double
 
 DECODE_ENCODING = 'utf-8'
 ENCODE_ENCODING = 'utf-8'
@@ -1187,6 +1187,10 @@ class IndigoObject(object):
         self.dispatcher._setSessionId()
         return self.dispatcher._checkResult(Indigo._lib.indigoTell(self.id))
 
+    def buildOffsetsIndex(self, threads=0):
+        self.dispatcher._setSessionId()
+        return self.dispatcher._checkResult(Indigo._lib.indigoBuildOffsetsIndex(self.id, threads))
+
     def sdfAppend(self, item):
         self.dispatcher._setSessionId()
         return self.dispatcher._checkResult(Indigo._lib.indigoSdfAppend(self.id, item.id))
@@ -1574,6 +1578,18 @@ class Indigo(object):
         Indigo._lib.indigoClearTautomerRules.argtypes = None
         Indigo._lib.indigoUnserialize.restype = c_int
         Indigo._lib.indigoUnserialize.argtypes = [POINTER(c_byte), c_int]
+        Indigo._lib.indigoSerializedCountAtoms.restype = c_int
+        Indigo._lib.indigoSerializedCountAtoms.argtypes = [POINTER(c_byte), c_int]
+        Indigo._lib.indigoSerializedCountBonds.restype = c_int
+        Indigo._lib.indigoSerializedCountBonds.argtypes = [POINTER(c_byte), c_int]
+        Indigo._lib.indigoSerializedGrossFormula.restype = c_char_p
+        Indigo._lib.indigoSerializedGrossFormula.argtypes = [POINTER(c_byte), c_int]
+        Indigo._lib.indigoSerializedXYZ.restype = POINTER(c_float)
+        Indigo._lib.indigoSerializedXYZ.argtypes = [POINTER(c_byte), c_int, c_int]
+        Indigo._lib.indigoSerializedName.restype = c_char_p
+        Indigo._lib.indigoSerializedName.argtypes = [POINTER(c_byte), c_int]
+        Indigo._lib.indigoSerializedGetProperty.restype = c_char_p
+        Indigo._lib.indigoSerializedGetProperty.argtypes = [POINTER(c_byte), c_int, c_char_p]
         Indigo._lib.indigoCommonBits.restype = c_int
         Indigo._lib.indigoCommonBits.argtypes = [c_int, c_int]
         Indigo._lib.indigoSimilarity.restype = c_float
@@ -2114,12 +2130,18 @@ class Indigo(object):
         Indigo._lib.indigoCheckAmbiguousH.argtypes = [c_int]
         Indigo._lib.indigoFingerprint.restype = c_int
         Indigo._lib.indigoFingerprint.argtypes = [c_int, c_char_p]
+        Indigo._lib.indigoFingerprintBatchRowSize.restype = c_int
+        Indigo._lib.indigoFingerprintBatchRowSize.argtypes = None
+        Indigo._lib.indigoFingerprintBatch.restype = c_int
+        Indigo._lib.indigoFingerprintBatch.argtypes = [c_int, c_char_p, c_int, POINTER(c_ubyte), c_int, POINTER(c_ubyte)]
         Indigo._lib.indigoCountBits.restype = c_int
         Indigo._lib.indigoCountBits.argtypes = [c_int]
         Indigo._lib.indigoRawData.restype = c_char_p
         Indigo._lib.indigoRawData.argtypes = [c_int]
         Indigo._lib.indigoTell.restype = c_int
         Indigo._lib.indigoTell.argtypes = [c_int]
+        Indigo._lib.indigoBuildOffsetsIndex.restype = c_int
+        Indigo._lib.indigoBuildOffsetsIndex.argtypes = [c_int, c_int]
         Indigo._lib.indigoSdfAppend.restype = c_int
         Indigo._lib.indigoSdfAppend.argtypes = [c_int, c_int]
         Indigo._lib.indigoSmilesAppend.restype = c_int
@@ -2215,6 +2237,45 @@ class Indigo(object):
         res = Indigo._lib.indigoUnserialize(values, len(arr))
         return self.IndigoObject(self, self._checkResult(res))
 
+    def _serializedBuffer(self, arr):
+        values = (c_byte * len(arr))()
+        for i in range(len(arr)):
+            values[i] = arr[i]
+        return values
+
+    def serializedCountAtoms(self, arr):
+        values = self._serializedBuffer(arr)
+        self._setSessionId()
+        return self._checkResult(Indigo._lib.indigoSerializedCountAtoms(values, len(arr)))
+
+    def serializedCountBonds(self, arr):
+        values = self._serializedBuffer(arr)
+        self._setSessionId()
+        return self._checkResult(Indigo._lib.indigoSerializedCountBonds(values, len(arr)))
+
+    def serializedGrossFormula(self, arr):
+        values = self._serializedBuffer(arr)
+        self._setSessionId()
+        return self._checkResultString(Indigo._lib.indigoSerializedGrossFormula(values, len(arr)))
+
+    def serializedXYZ(self, arr, atom):
+        values = self._serializedBuffer(arr)
+        self._setSessionId()
+        xyz = Indigo._lib.indigoSerializedXYZ(values, len(arr), atom)
+        if not xyz:
+            raise IndigoException(Indigo._lib.indigoGetLastError())
+        return [xyz[0], xyz[1], xyz[2]]
+
+    def serializedName(self, arr):
+        values = self._serializedBuffer(arr)
+        self._setSessionId()
+        return self._checkResultString(Indigo._lib.indigoSerializedName(values, len(arr)))
+
+    def serializedGetProperty(self, arr, prop):
+        values = self._serializedBuffer(arr)
+        self._setSessionId()
+        return self._checkResultString(Indigo._lib.indigoSerializedGetProperty(values, len(arr), prop.encode(ENCODE_ENCODING)))
+
     def setOption(self, option, value1, value2=None, value3=None):
         self._setSessionId()
         if (type(value1).__name__ == 'str' or type(value1).__name__ == 'unicode') and value2 is None and value3 is None:
@@ -2454,6 +2515,27 @@ class Indigo(object):
         self._setSessionId()
         return self._checkResultFloat(Indigo._lib.indigoSimilarity(item1.id, item2.id, metrics.encode(ENCODE_ENCODING)))
 
+    def fingerprintBatch(self, items, type='', threads=0, maxRows=1024):
+        """Computes fingerprints of the next molecules from an array or an iterator.
+
+        Returns a list of at most maxRows fingerprints as bytearray objects, with None
+        for the molecules that failed to load. An empty list means the molecules are over.
+        """
+        if type is None:
+            type = ''
+        self._setSessionId()
+        row_size = self._checkResult(Indigo._lib.indigoFingerprintBatchRowSize())
+        buffer = (c_ubyte * (row_size * maxRows))()
+        status = (c_ubyte * maxRows)()
+        rows = self._checkResult(Indigo._lib.indigoFingerprintBatch(items.id, type.encode(ENCODE_ENCODING), threads, buffer, len(buffer), status))
+        res = []
+        for i in range(rows):
+            if status[i]:
+                res.append(bytearray(buffer[i * row_size:(i + 1) * row_size]))
+            else:
+                res.append(None)
+        return res
+
     def iterateSDFile(self, filename):
         self._setSessionId()
         return self.IndigoObject(self, self._checkResult(Indigo._lib.indigoIterateSDFile(filename.encode(ENCODE_ENCODING))))
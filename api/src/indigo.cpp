@@ -16,7 +16,10 @@
 
 #include "base_cpp/output.h"
 #include "base_cpp/profiling.h"
+#include "base_cpp/scanner.h"
 #include "base_cpp/temporary_thread_obj.h"
+#include "base_cpp/os_thread_wrapper.h"
+#include "gzip/gzip_output.h"
 #include "molecule/molecule_fingerprint.h"
 #include "reaction/rxnfile_saver.h"
 #include "molecule/molfile_saver.h"
@@ -37,7 +40,6 @@ void Indigo::init ()
 {
    error_handler = 0;
    error_handler_context = 0;
-   _next_id = 1001;
 
    stereochemistry_options.reset();
    ignore_noncritical_query_features = false;
@@ -50,6 +52,13 @@ void Indigo::init ()
    molfile_saving_mode = 0;
    molfile_saving_no_chiral = false;
    filename_encoding = ENCODING_ASCII;
+   file_memory_mapping = true;
+   file_read_ahead = 1 << 20;
+   parsing_threads = 1;
+   saving_threads = 1;
+   file_offsets_index = false;
+   gzip_threads = 1;
+   gzip_file_output = false;
    fp_params.any_qwords = 15;
    fp_params.sim_qwords = 8;
    fp_params.tau_qwords = 10;
@@ -59,6 +68,8 @@ void Indigo::init ()
    embedding_edges_uniqueness = false;
    find_unique_embeddings = true;
    max_embeddings = 10000;
+   substructure_candidate_sets = false;
+   frozen_graphs = false;
 
    layout_max_iterations = 0;
 
@@ -75,6 +86,7 @@ void Indigo::init ()
    cancellation_timeout = 0;
 
    preserve_ordering_in_serialize = false;
+   serialize_fixed_layout = false;
 
    unique_dearomatization = false;
 
@@ -100,12 +112,6 @@ Indigo::Indigo ()
 
 void Indigo::removeAllObjects ()
 {
-   OsLocker lock(_objects_lock);
-   int i;
-
-   for (i = _objects.begin(); i != _objects.end(); i = _objects.next(i))
-      delete _objects.value(i);
-
    _objects.clear();
 }
 
@@ -118,6 +124,64 @@ void Indigo::updateCancellationHandler ()
     }
 }
 
+Scanner * Indigo::createFileScanner (const char *filename)
+{
+   if (file_memory_mapping)
+   {
+      try
+      {
+         return new MappedFileScanner(filename_encoding, filename);
+      }
+      catch (Exception &)
+      {
+         // Fall back to reading the file if it can't be mapped
+      }
+   }
+
+   return new FileScanner(filename_encoding, filename, file_read_ahead);
+}
+
+// Output file that owns the file and the gzip stream. The gzip stream is
+// finished before the file is closed.
+class IndigoGZipFileOutput : public Output
+{
+public:
+   IndigoGZipFileOutput (Encoding filename_encoding, const char *filename, int threads) :
+      _file(filename_encoding, filename), _gzip(_file, Z_DEFAULT_COMPRESSION, threads)
+   {
+   }
+
+   virtual void write (const void *data, int size) { _gzip.write(data, size); }
+   virtual void seek  (long long offset, int from) { _gzip.seek(offset, from); }
+   virtual long long tell  () { return _gzip.tell(); }
+   virtual void flush () { _gzip.flush(); }
+
+private:
+   FileOutput _file;
+   GZipOutput _gzip;
+};
+
+Output * Indigo::createFileOutput (const char *filename)
+{
+   size_t len = strlen(filename);
+
+   if (gzip_file_output && len > 3 && strcasecmp(filename + len - 3, ".gz") == 0)
+      return new IndigoGZipFileOutput(filename_encoding, filename, getGZipThreads());
+
+   return new FileOutput(filename_encoding, filename);
+}
+
+int Indigo::getGZipThreads ()
+{
+   int threads = gzip_threads;
+
+   if (threads <= 0)
+      threads = osGetProcessorsCount();
+
+   // Zero threads keep the synchronous gzip streams without background threads
+   return threads > 1 ? threads : 0;
+}
+
 void Indigo::initMolfileSaver (MolfileSaver &saver)
 {
    saver.mode = molfile_saving_mode;
@@ -217,40 +281,26 @@ CEXPORT void indigoSetErrorMessage (const char *message)
 
 int Indigo::addObject (IndigoObject *obj)
 {
-   OsLocker lock(_objects_lock);
-   int id = _next_id++;
-   _objects.insert(id, obj);
-   return id;
+   return _objects.add(obj);
 }
 
 void Indigo::removeObject (int id)
 {
-   OsLocker lock(_objects_lock);
-   if (_objects.at2(id) == 0)
-      return;
-   delete _objects.at(id);
-   _objects.remove(id);
+   delete _objects.remove(id);
 }
 
 IndigoObject & Indigo::getObject (int handle)
 {
-   OsLocker lock(_objects_lock);
+   IndigoObject *obj = _objects.get(handle);
 
-   try
-   {
-      return *_objects.at(handle);
-   }
-   catch (RedBlackMap<int, IndigoObject *>::Error &e)
-   {
-      throw IndigoError("can not access object #%d: %s", handle, e.message());
-   }
+   if (obj == 0)
+      throw IndigoError("can not access object #%d: no such object", handle);
+   return *obj;
 }
 
 int Indigo::countObjects ()
 {
-   OsLocker lock(_objects_lock);
-
-   return _objects.size();
+   return _objects.count();
 }
 
 static TemporaryThreadObjManager<Indigo::TmpData> _indigo_temporary_obj_manager;
@@ -1,7 +1,9 @@
 #include "indigo_molecule.h"
 #include "indigo_reaction.h"
+#include "indigo_loaders.h"
 #include "base_cpp/output.h"
 #include "molecule/molecule_gross_formula.h"
+#include "molecule/flat_molecule.h"
 #include "molecule/molecule_mass.h"
 #include "reaction/reaction_gross_formula.h"
 
@@ -40,6 +42,20 @@ CEXPORT int indigoGrossFormula (int object)
    INDIGO_BEGIN
    {
       IndigoObject & indigoObject = self.getObject(object);
+      if (indigoObject.type == IndigoObject::SMILES_MOLECULE)
+      {
+         // Plain SMILES from a file are not loaded into Molecule if possible
+         QS_DEF(FlatMolecule, flat);
+
+         if (((IndigoSmilesMolecule &)indigoObject).loadFlatMolecule(flat))
+         {
+            AutoPtr<IndigoMoleculeGross> grossptr(new IndigoMoleculeGross());
+
+            grossptr->gross = MoleculeGrossFormula::collect(flat);
+            return self.addObject(grossptr.release());
+         }
+      }
+
       if (IndigoBaseMolecule::is(indigoObject))
       {
           BaseMolecule &mol = self.getObject(object).getBaseMolecule();
@@ -24,6 +24,8 @@
 #include "indigo_molecule.h"
 #include "indigo_reaction.h"
 #include "base_cpp/scanner.h"
+#include "base_cpp/os_thread_wrapper.h"
+#include "indigo_array.h"
 
 IndigoFingerprint::IndigoFingerprint () : IndigoObject(FINGERPRINT)
 {
@@ -150,6 +152,209 @@ CEXPORT int indigoFingerprint (int item, const char *type)
    INDIGO_END(-1);
 }
 
+//
+// Batch fingerprints
+//
+
+namespace
+{
+   class FingerprintBatchCommand : public OsCommand
+   {
+   public:
+      virtual void clear ()
+      {
+         items.clear();
+         owned_items.clear();
+         first_row = 0;
+      }
+
+      virtual void execute (OsCommandResult &result)
+      {
+         AutoPtr<MoleculeFingerprintBuilder> builder;
+
+         for (int i = 0; i < items.size(); i++)
+         {
+            byte *row = buffer + (size_t)(first_row + i) * row_size;
+
+            try
+            {
+               // Molecules from the iterators are parsed here, in the worker thread
+               BaseMolecule &mol = items[i]->getBaseMolecule();
+
+               // One builder is reused for the whole chunk
+               if (builder.get() == 0)
+                  builder.reset(new MoleculeFingerprintBuilder(mol, *fp_params));
+
+               _indigoParseMoleculeFingerprintType(builder.ref(), type, mol.isQueryMolecule());
+               builder->process(mol);
+               memcpy(row, builder->get(), row_size);
+               if (status != 0)
+                  status[first_row + i] = 1;
+            }
+            catch (Exception &)
+            {
+               // A bad molecule gets a zero row and does not stop the batch
+               memset(row, 0, row_size);
+               if (status != 0)
+                  status[first_row + i] = 0;
+            }
+         }
+      }
+
+      Array<IndigoObject *> items;
+      PtrArray<IndigoObject> owned_items;
+      int first_row;
+
+      const MoleculeFingerprintParameters *fp_params;
+      const char *type;
+      byte *buffer;
+      byte *status;
+      int row_size;
+   };
+
+   // Takes molecules from an array or an iterator in the main thread and
+   // computes their fingerprints on the worker threads. Each command
+   // writes its own rows of the matrix, so results need no handling.
+   class FingerprintBatchDispatcher : public OsCommandDispatcher
+   {
+   public:
+      FingerprintBatchDispatcher (IndigoObject &source, const MoleculeFingerprintParameters &fp_params,
+                                  const char *type, byte *buffer, byte *status, int max_rows) :
+         OsCommandDispatcher(HANDLING_ORDER_ANY, true), _source(source), _fp_params(fp_params),
+         _type(type), _buffer(buffer), _status(status), _max_rows(max_rows), _rows(0), _array_index(0), _finished(false)
+      {
+         _array = IndigoArray::is(source) ? &IndigoArray::cast(source) : 0;
+      }
+
+      void compute (int threads)
+      {
+         run(threads > 1 ? threads : 0);
+
+         // Errors of the source are raised after the workers are finished.
+         // Rows written before the error are returned first; the next call
+         // meets the error again with no rows and raises it.
+         if (_source_error.get() != 0 && _rows == 0)
+            _source_error->throwSelf();
+      }
+
+      int rows () const
+      {
+         return _rows;
+      }
+
+   protected:
+      enum { _CHUNK_SIZE = 64 };
+
+      virtual OsCommand * _allocateCommand ()
+      {
+         return new FingerprintBatchCommand();
+      }
+
+      virtual bool _setupCommand (OsCommand &command)
+      {
+         FingerprintBatchCommand &cmd = (FingerprintBatchCommand &)command;
+
+         cmd.first_row = _rows;
+         cmd.fp_params = &_fp_params;
+         cmd.type = _type;
+         cmd.buffer = _buffer;
+         cmd.status = _status;
+         cmd.row_size = _fp_params.fingerprintSize();
+
+         while (!_finished && cmd.items.size() < _CHUNK_SIZE && _rows < _max_rows)
+         {
+            IndigoObject *item;
+
+            try
+            {
+               item = _nextItem();
+            }
+            catch (Exception &e)
+            {
+               _source_error.reset(e.clone());
+               item = 0;
+            }
+
+            if (item == 0)
+               _finished = true;
+            else
+            {
+               // Iterator items are owned by the command
+               if (_array == 0)
+                  cmd.owned_items.add(item);
+               cmd.items.push(item);
+               _rows++;
+            }
+         }
+
+         return cmd.items.size() > 0;
+      }
+
+   private:
+      IndigoObject &_source;
+      IndigoArray *_array;
+      const MoleculeFingerprintParameters &_fp_params;
+      const char *_type;
+      byte *_buffer;
+      byte *_status;
+      int _max_rows;
+      int _rows;
+      int _array_index;
+      bool _finished;
+      AutoPtr<Exception> _source_error;
+
+      IndigoObject * _nextItem ()
+      {
+         if (_array != 0)
+         {
+            if (_array_index >= _array->objects.size())
+               return 0;
+            return _array->objects[_array_index++];
+         }
+
+         return _source.next();
+      }
+   };
+}
+
+CEXPORT int indigoFingerprintBatchRowSize (void)
+{
+   INDIGO_BEGIN
+   {
+      return self.fp_params.fingerprintSize();
+   }
+   INDIGO_END(-1);
+}
+
+CEXPORT int indigoFingerprintBatch (int items, const char *type, int threads, byte *buffer, int buffer_size,
+                                    byte *status)
+{
+   INDIGO_BEGIN
+   {
+      IndigoObject &source = self.getObject(items);
+      int max_rows = buffer_size / self.fp_params.fingerprintSize();
+
+      if (buffer == 0 || max_rows < 1)
+         throw IndigoError("indigoFingerprintBatch(): buffer is too small for a fingerprint of %d bytes",
+            self.fp_params.fingerprintSize());
+
+      // Check the fingerprint type before the threads are started
+      Molecule empty;
+      MoleculeFingerprintBuilder builder(empty, self.fp_params);
+
+      _indigoParseMoleculeFingerprintType(builder, type, false);
+
+      if (threads <= 0)
+         threads = osGetProcessorsCount();
+
+      FingerprintBatchDispatcher dispatcher(source, self.fp_params, type, buffer, status, max_rows);
+
+      dispatcher.compute(threads);
+      return dispatcher.rows();
+   }
+   INDIGO_END(-1);
+}
+
 void IndigoFingerprint::toString (Array<char> &str)
 {
    ArrayOutput output(str);
@@ -0,0 +1,212 @@
+/****************************************************************************
+ * Copyright (C) 2009-2017 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#include <functional>
+#include <thread>
+
+#include "indigo_handle_table.h"
+#include "indigo_internal.h"
+
+IndigoHandleTable::Shard::Shard () : count(0), size(0), first_free(-1), last_free(-1)
+{
+   for (int i = 0; i < PAGES_COUNT; i++)
+      pages[i].store(0, std::memory_order_relaxed);
+}
+
+IndigoHandleTable::IndigoHandleTable ()
+{
+}
+
+IndigoHandleTable::~IndigoHandleTable ()
+{
+   for (int i = 0; i < SHARDS_COUNT; i++)
+      for (int j = 0; j < PAGES_COUNT; j++)
+         delete[] _shards[i].pages[j].load(std::memory_order_relaxed);
+}
+
+int IndigoHandleTable::_currentShard ()
+{
+   static thread_local int shard = (int)(std::hash<std::thread::id>()(std::this_thread::get_id()) % SHARDS_COUNT);
+
+   return shard;
+}
+
+IndigoHandleTable::Slot * IndigoHandleTable::_findSlot (const Shard &shard, int index)
+{
+   Slot *page = shard.pages[index >> PAGE_BITS].load(std::memory_order_acquire);
+
+   if (page == 0)
+      return 0;
+   return page + (index & (PAGE_SIZE - 1));
+}
+
+int IndigoHandleTable::add (IndigoObject *obj)
+{
+   int current = _currentShard();
+
+   for (int i = 0; i < SHARDS_COUNT; i++)
+   {
+      int handle = _add((current + i) % SHARDS_COUNT, obj);
+
+      if (handle != 0)
+         return handle;
+   }
+
+   throw IndigoError("can not create object: too many objects");
+}
+
+int IndigoHandleTable::_add (int shard_idx, IndigoObject *obj)
+{
+   Shard &shard = _shards[shard_idx];
+   OsLocker locker(shard.lock);
+   Slot *slot;
+   int index;
+
+   if (shard.first_free >= 0)
+   {
+      index = shard.first_free;
+      slot = _findSlot(shard, index);
+      shard.first_free = slot->next_free;
+      if (shard.first_free < 0)
+         shard.last_free = -1;
+   }
+   else
+   {
+      if (shard.size >= PAGES_COUNT * PAGE_SIZE)
+         return 0;
+
+      index = shard.size;
+      slot = _findSlot(shard, index);
+      if (slot == 0)
+      {
+         Slot *page = new Slot[PAGE_SIZE];
+
+         for (int i = 0; i < PAGE_SIZE; i++)
+         {
+            page[i].object.store(0, std::memory_order_relaxed);
+            page[i].generation.store(1, std::memory_order_relaxed);
+            page[i].next_free = -1;
+         }
+         shard.pages[index >> PAGE_BITS].store(page, std::memory_order_release);
+         slot = page;
+      }
+      shard.size++;
+   }
+
+   slot->object.store(obj, std::memory_order_release);
+   shard.count.fetch_add(1, std::memory_order_relaxed);
+
+   int generation = slot->generation.load(std::memory_order_relaxed);
+
+   return (generation << (SLOT_BITS + SHARD_BITS)) | (index << SHARD_BITS) | shard_idx;
+}
+
+IndigoObject * IndigoHandleTable::get (int handle) const
+{
+   if (handle <= 0)
+      return 0;
+
+   int generation = handle >> (SLOT_BITS + SHARD_BITS);
+   int index = (handle >> SHARD_BITS) & ((1 << SLOT_BITS) - 1);
+   const Slot *slot = _findSlot(_shards[handle & (SHARDS_COUNT - 1)], index);
+
+   if (slot == 0 || slot->generation.load(std::memory_order_acquire) != generation)
+      return 0;
+
+   IndigoObject *obj = slot->object.load(std::memory_order_acquire);
+
+   // The slot could be freed and reused while the object was read
+   if (slot->generation.load(std::memory_order_acquire) != generation)
+      return 0;
+   return obj;
+}
+
+IndigoObject * IndigoHandleTable::_detach (Shard &shard, int index)
+{
+   Slot *slot = _findSlot(shard, index);
+   IndigoObject *obj = slot->object.load(std::memory_order_relaxed);
+
+   if (obj == 0)
+      return 0;
+
+   // Invalidate the handle before the slot is released. Zero generation
+   // is never used in handles, so it marks a retired slot.
+   int generation = slot->generation.load(std::memory_order_relaxed);
+
+   generation = (generation == GENERATION_MASK) ? 0 : generation + 1;
+   slot->generation.store(generation, std::memory_order_release);
+   slot->object.store(0, std::memory_order_release);
+   shard.count.fetch_sub(1, std::memory_order_relaxed);
+
+   // The slot is not reused if its generation wraps
+   if (generation == 0)
+      return obj;
+
+   slot->next_free = -1;
+   if (shard.last_free >= 0)
+      _findSlot(shard, shard.last_free)->next_free = index;
+   else
+      shard.first_free = index;
+   shard.last_free = index;
+   return obj;
+}
+
+IndigoObject * IndigoHandleTable::remove (int handle)
+{
+   if (handle <= 0)
+      return 0;
+
+   int generation = handle >> (SLOT_BITS + SHARD_BITS);
+   int index = (handle >> SHARD_BITS) & ((1 << SLOT_BITS) - 1);
+   Shard &shard = _shards[handle & (SHARDS_COUNT - 1)];
+   OsLocker locker(shard.lock);
+   Slot *slot = _findSlot(shard, index);
+
+   if (slot == 0 || slot->generation.load(std::memory_order_relaxed) != generation)
+      return 0;
+   return _detach(shard, index);
+}
+
+void IndigoHandleTable::clear ()
+{
+   for (int i = 0; i < SHARDS_COUNT; i++)
+   {
+      Shard &shard = _shards[i];
+      Array<IndigoObject *> objects;
+
+      {
+         OsLocker locker(shard.lock);
+
+         for (int index = 0; index < shard.size; index++)
+         {
+            IndigoObject *obj = _detach(shard, index);
+
+            if (obj != 0)
+               objects.push(obj);
+         }
+      }
+
+      for (int j = 0; j < objects.size(); j++)
+         delete objects[j];
+   }
+}
+
+int IndigoHandleTable::count () const
+{
+   int count = 0;
+
+   for (int i = 0; i < SHARDS_COUNT; i++)
+      count += _shards[i].count.load(std::memory_order_relaxed);
+   return count;
+}
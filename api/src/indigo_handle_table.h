@@ -0,0 +1,117 @@
+/****************************************************************************
+ * Copyright (C) 2009-2017 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#ifndef __indigo_handle_table__
+#define __indigo_handle_table__
+
+#include <atomic>
+
+#include "base_c/defs.h"
+#include "base_cpp/os_sync_wrapper.h"
+
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+class IndigoObject;
+
+//
+// Table of the objects referenced by the Indigo API handles.
+//
+// A handle packs a shard number, a slot index inside the shard and the
+// generation of the slot. Lookups do not take any locks: the slot is found
+// by index and the generation check rejects handles of freed objects even
+// if the slot has been reused. Insertions and removals lock only one shard,
+// and every thread inserts into its own shard (chosen by thread id) while
+// the shard has room, and into the other shards after that.
+//
+// Freed slots are reused in FIFO order, and a slot whose generation would
+// wrap is retired, so a handle of a freed object never resolves to another
+// object.
+//
+class DLLEXPORT IndigoHandleTable
+{
+public:
+   IndigoHandleTable ();
+   ~IndigoHandleTable ();
+
+   int add (IndigoObject *obj);
+
+   // Returns NULL if there is no object with such handle
+   IndigoObject * get (int handle) const;
+
+   // Detaches the object from the table and returns it or NULL
+   // if there is no object with such handle
+   IndigoObject * remove (int handle);
+
+   // Deletes all objects
+   void clear ();
+
+   int count () const;
+
+   enum
+   {
+      SHARD_BITS = 3,
+      SLOT_BITS = 21,
+      GENERATION_BITS = 7,
+      PAGE_BITS = 11
+   };
+
+protected:
+   enum
+   {
+      SHARDS_COUNT = 1 << SHARD_BITS,
+      PAGE_SIZE = 1 << PAGE_BITS,
+      PAGES_COUNT = 1 << (SLOT_BITS - PAGE_BITS),
+      GENERATION_MASK = (1 << GENERATION_BITS) - 1
+   };
+
+   struct Slot
+   {
+      std::atomic<IndigoObject *> object;
+      std::atomic<int> generation;
+      int next_free;
+   };
+
+   struct Shard
+   {
+      Shard ();
+
+      indigo::OsLock lock;
+      std::atomic<Slot *> pages[PAGES_COUNT];
+      std::atomic<int> count;
+      int size;
+      // Queue of the free slots
+      int first_free;
+      int last_free;
+   };
+
+   Shard _shards[SHARDS_COUNT];
+
+   static int _currentShard ();
+   static Slot * _findSlot (const Shard &shard, int index);
+   // Returns 0 if the shard is full
+   int _add (int shard_idx, IndigoObject *obj);
+   IndigoObject * _detach (Shard &shard, int index);
+
+private:
+   IndigoHandleTable (const IndigoHandleTable &); // no implicit copy
+};
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif
@@ -30,6 +30,7 @@
 #include "base_cpp/cancellation_handler.h"
 
 #include "option_manager.h"
+#include "indigo_handle_table.h"
 #include "molecule/molecule_fingerprint.h"
 #include "molecule/molecule_tautomer.h"
 #include "molecule/molecule_stereocenter_options.h"
@@ -308,9 +309,18 @@ public:
    bool smiles_saving_smarts_mode;
 
    Encoding filename_encoding;
+   bool file_memory_mapping; // map input files into memory when possible
+   int file_read_ahead; // read-ahead size in bytes when files are not mapped
+   int parsing_threads; // threads parsing records of the file iterators ahead of the consumer
+   int saving_threads; // threads serializing records appended to SDF savers
+   bool file_offsets_index; // load and save sidecar indices of record offsets for SDF/RDF files
+   int gzip_threads; // threads inflating and deflating gzip files in the background, 1 means in the calling thread
+   bool gzip_file_output; // write gzip for output file names ending with ".gz"
 
    bool embedding_edges_uniqueness, find_unique_embeddings;
    int max_embeddings;
+   bool substructure_candidate_sets;
+   bool frozen_graphs; // freeze the prepared targets of substructure matching, see Graph::freeze()
 
    int layout_max_iterations; // default is zero -- no limit
    bool smart_layout = false;
@@ -324,10 +334,20 @@ public:
 
    void updateCancellationHandler ();
 
+   // Opens an input file of molecules for sequential reading
+   Scanner * createFileScanner (const char *filename);
+   // Creates an output file, gzipped if the name ends with ".gz" and
+   // "gzip-file-output" option is enabled
+   Output * createFileOutput (const char *filename);
+   // Number of background threads for gzip files, see "gzip-threads" option.
+   // Zero means that gzip files are processed in the calling thread.
+   int getGZipThreads ();
+
    void initMolfileSaver (MolfileSaver &saver);
    void initRxnfileSaver (RxnfileSaver &saver);
 
    bool preserve_ordering_in_serialize;
+   bool serialize_fixed_layout; // indigoSerialize() saves molecules in IFM format, see IfmSaver
 
    AromaticityOptions arom_options;
    // This option is moved out of arom_options because it should be used only in indigoDearomatize method
@@ -341,10 +361,7 @@ public:
 
 protected:
 
-   RedBlackMap<int, IndigoObject *> _objects;
-
-   int    _next_id;
-   OsLock _objects_lock;
+   IndigoHandleTable _objects;
 
    int _indigo_id;
 };
@@ -131,7 +131,7 @@ CEXPORT int indigoWriteFile (const char *filename)
 {
    INDIGO_BEGIN
    {
-      return self.addObject(new IndigoOutput(new FileOutput(filename)));
+      return self.addObject(new IndigoOutput(self.createFileOutput(filename)));
    }
    INDIGO_END(-1)
 }
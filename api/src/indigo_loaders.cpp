@@ -20,6 +20,7 @@
 #include "molecule/rdf_loader.h"
 #include "molecule/molfile_loader.h"
 #include "molecule/smiles_loader.h"
+#include "molecule/smiles_flat_loader.h"
 #include "reaction/rsmiles_loader.h"
 #include "base_cpp/scanner.h"
 #include "reaction/rxnfile_loader.h"
@@ -30,21 +31,485 @@
 #include "molecule/multiple_cdx_loader.h"
 #include "molecule/molecule_cdx_loader.h"
 #include "reaction/reaction_cdx_loader.h"
+#include "base_cpp/os_thread_wrapper.h"
+#include "base_cpp/output.h"
+#include "base_cpp/crc32.h"
 
 #include <limits>
 
+// Number of records parsed by one command of the records loaders
+static const int _parsing_chunk_size = 16;
+// Number of records read ahead per parsing thread
+static const int _parsing_window_per_thread = 64;
+
+namespace
+{
+   class RecordsParsingCommand : public OsCommand
+   {
+   public:
+      virtual void clear ()
+      {
+         first = last = 0;
+      }
+
+      virtual void execute (OsCommandResult &result)
+      {
+         for (int i = first; i < last; i++)
+         {
+            IndigoObject &record = *(*records)[i];
+
+            try
+            {
+               if (IndigoBaseMolecule::is(record))
+                  record.getBaseMolecule();
+               else
+                  record.getBaseReaction();
+            }
+            catch (Exception &)
+            {
+               // The record is left unparsed, and the same error is
+               // raised when the consumer accesses it
+            }
+         }
+      }
+
+      PtrArray<IndigoRdfData> *records;
+      int first, last;
+   };
+
+   // Parses records read ahead on the worker threads. Each record is
+   // parsed in place, so results need no handling.
+   class RecordsParsingDispatcher : public OsCommandDispatcher
+   {
+   public:
+      RecordsParsingDispatcher (PtrArray<IndigoRdfData> &records) :
+         OsCommandDispatcher(HANDLING_ORDER_ANY, true), _records(records), _next(0)
+      {
+      }
+
+   protected:
+      virtual OsCommand * _allocateCommand ()
+      {
+         return new RecordsParsingCommand();
+      }
+
+      virtual bool _setupCommand (OsCommand &command)
+      {
+         if (_next >= _records.size())
+            return false;
+
+         RecordsParsingCommand &cmd = (RecordsParsingCommand &)command;
+
+         cmd.records = &_records;
+         cmd.first = _next;
+         cmd.last = __min(_next + _parsing_chunk_size, _records.size());
+
+         _next = cmd.last;
+         return true;
+      }
+
+   private:
+      PtrArray<IndigoRdfData> &_records;
+      int _next;
+   };
+}
+
+//
+// IndigoOffsetsIndex
+//
+
+static const char _offsets_index_signature[] = "INDIGOIX";
+static const int _offsets_index_version = 1;
+// Size of the file head and tail included into the checksum
+static const int _offsets_index_checked_size = 65536;
+// Minimal size of the file part scanned by one command
+static const long long _offsets_index_min_chunk = 1 << 24;
+// Number of offsets written or read at once
+static const int _offsets_index_block = 1 << 16;
+
+namespace
+{
+   class OffsetsIndexResult : public OsCommandResult
+   {
+   public:
+      virtual void clear ()
+      {
+         boundaries.clear();
+      }
+
+      Array<long long> boundaries;
+   };
+
+   class OffsetsIndexCommand : public OsCommand
+   {
+   public:
+      virtual void clear ()
+      {
+         first = last = 0;
+      }
+
+      virtual void execute (OsCommandResult &result)
+      {
+         OffsetsIndexResult &res = (OffsetsIndexResult &)result;
+         AutoPtr<Scanner> scanner(indigoGetInstance().createFileScanner(filename));
+
+         // Lines starting in [first, last) belong to this part
+         if (first > 0)
+         {
+            scanner->seek(first - 1, SEEK_SET);
+
+            char c = scanner->readChar();
+
+            if (c == '\r')
+            {
+               if (!scanner->isEOF() && scanner->lookNext() == '\n')
+                  scanner->skip(1);
+            }
+            else if (c != '\n' && !scanner->isEOF())
+            {
+               QS_DEF(Array<char>, line);
+               scanner->readLine(line, false);
+            }
+         }
+
+         finder(scanner.ref(), last, res.boundaries);
+      }
+
+      const char *filename;
+      IndigoOffsetsIndex::BoundariesFinder finder;
+      long long first, last;
+   };
+
+   // Scans parts of the file on the worker threads. Boundaries are
+   // appended in the order of the parts.
+   class OffsetsIndexDispatcher : public OsCommandDispatcher
+   {
+   public:
+      OffsetsIndexDispatcher (const char *filename, IndigoOffsetsIndex::BoundariesFinder finder,
+                              long long size, long long chunk, Array<long long> &boundaries) :
+         OsCommandDispatcher(HANDLING_ORDER_SERIAL, true), _filename(filename), _finder(finder),
+         _size(size), _chunk(chunk), _next(0), _boundaries(boundaries)
+      {
+      }
+
+   protected:
+      virtual OsCommand * _allocateCommand ()
+      {
+         return new OffsetsIndexCommand();
+      }
+
+      virtual OsCommandResult * _allocateResult ()
+      {
+         return new OffsetsIndexResult();
+      }
+
+      virtual bool _setupCommand (OsCommand &command)
+      {
+         if (_next >= _size)
+            return false;
+
+         OffsetsIndexCommand &cmd = (OffsetsIndexCommand &)command;
+
+         cmd.filename = _filename;
+         cmd.finder = _finder;
+         cmd.first = _next;
+         cmd.last = __min(_next + _chunk, _size);
+
+         _next = cmd.last;
+         return true;
+      }
+
+      virtual void _handleResult (OsCommandResult &result)
+      {
+         _boundaries.concat(((OffsetsIndexResult &)result).boundaries);
+      }
+
+   private:
+      const char *_filename;
+      IndigoOffsetsIndex::BoundariesFinder _finder;
+      long long _size, _chunk, _next;
+      Array<long long> &_boundaries;
+   };
+}
+
+IndigoOffsetsIndex::IndigoOffsetsIndex (const char *filename, int format)
+{
+   _filename.readString(filename, true);
+   _index_filename.readString(filename, false);
+   _index_filename.appendString(".idx", true);
+   _format = format;
+   _saved = false;
+}
+
+void IndigoOffsetsIndex::_getFileStamp (long long &size, long long &mtime, dword &checksum,
+                                        bool &compressed)
+{
+   Indigo &self = indigoGetInstance();
+   FileScanner scanner(self.filename_encoding, _filename.ptr());
+   QS_DEF(Array<char>, data);
+
+   size = scanner.length();
+   mtime = getFileModificationTime(self.filename_encoding, _filename.ptr());
+
+   int head = (int)__min(size, (long long)_offsets_index_checked_size);
+   int tail = (int)__min(size - head, (long long)_offsets_index_checked_size);
+
+   data.clear_resize(head + tail);
+   scanner.read(head, data.ptr());
+   scanner.seek(size - tail, SEEK_SET);
+   scanner.read(tail, data.ptr() + head);
+
+   checksum = CRC32::get(data.ptr(), data.size());
+
+   // Offsets in gzipped files are positions in the inflated data
+   compressed = head >= 2 && (byte)data[0] == 0x1F && (byte)data[1] == 0x8B;
+}
+
+bool IndigoOffsetsIndex::load (Array<long long> &offsets, long long &end_offset)
+{
+   Indigo &self = indigoGetInstance();
+   FILE *file = openFile(self.filename_encoding, _index_filename.ptr(), "rb");
+
+   if (file == NULL)
+      return false;
+   fclose(file);
+
+   try
+   {
+      FileScanner scanner(self.filename_encoding, _index_filename.ptr());
+      char signature[sizeof(_offsets_index_signature) - 1];
+      long long size, mtime, stored_size, stored_mtime;
+      dword checksum;
+      bool compressed;
+
+      scanner.read(sizeof(signature), signature);
+      if (memcmp(signature, _offsets_index_signature, sizeof(signature)) != 0)
+         return false;
+      if (scanner.readBinaryInt() != _offsets_index_version || scanner.readBinaryInt() != _format)
+         return false;
+
+      scanner.read(sizeof(stored_size), &stored_size);
+      scanner.read(sizeof(stored_mtime), &stored_mtime);
+      dword stored_checksum = scanner.readBinaryDword();
+
+      _getFileStamp(size, mtime, checksum, compressed);
+      if (size != stored_size || mtime != stored_mtime || checksum != stored_checksum)
+         return false;
+
+      scanner.read(sizeof(end_offset), &end_offset);
+
+      int count = scanner.readBinaryInt();
+
+      // The rest of the index must be exactly the offsets
+      if (count < 0 || (long long)count * sizeof(long long) != scanner.length() - scanner.tell())
+         return false;
+
+      offsets.clear_resize(count);
+      for (int i = 0; i < count; i += _offsets_index_block)
+         scanner.read(__min(count - i, _offsets_index_block) * sizeof(long long), offsets.ptr() + i);
+
+      // Records go in the file order and end at the end offset
+      long long prev = -1;
+
+      for (int i = 0; i < count; i++)
+      {
+         if (offsets[i] <= prev)
+            return false;
+         prev = offsets[i];
+      }
+      if (end_offset < prev || end_offset < 0 || (!compressed && end_offset > size))
+         return false;
+   }
+   catch (Exception &)
+   {
+      // Truncated or damaged index is not used
+      return false;
+   }
+
+   _saved = true;
+   return true;
+}
+
+void IndigoOffsetsIndex::save (const Array<long long> &offsets, long long end_offset)
+{
+   long long size, mtime;
+   dword checksum;
+   bool compressed;
+
+   _getFileStamp(size, mtime, checksum, compressed);
+
+   FileOutput output(indigoGetInstance().filename_encoding, _index_filename.ptr());
+
+   output.write(_offsets_index_signature, sizeof(_offsets_index_signature) - 1);
+   output.writeBinaryInt(_offsets_index_version);
+   output.writeBinaryInt(_format);
+   output.write(&size, sizeof(size));
+   output.write(&mtime, sizeof(mtime));
+   output.writeBinaryDword(checksum);
+   output.write(&end_offset, sizeof(end_offset));
+   output.writeBinaryInt(offsets.size());
+   for (int i = 0; i < offsets.size(); i += _offsets_index_block)
+      output.write(offsets.ptr() + i, __min(offsets.size() - i, _offsets_index_block) * sizeof(long long));
+
+   _saved = true;
+}
+
+void IndigoOffsetsIndex::saveScanned (const Array<long long> &offsets, long long end_offset)
+{
+   if (_saved || !indigoGetInstance().file_offsets_index)
+      return;
+
+   // The index is saved once even if it can't be written
+   _saved = true;
+
+   try
+   {
+      save(offsets, end_offset);
+   }
+   catch (Exception &)
+   {
+   }
+}
+
+void IndigoOffsetsIndex::build (int threads, BoundariesFinder finder, BoundariesConverter converter,
+                                Array<long long> &offsets, long long &end_offset)
+{
+   AutoPtr<Scanner> scanner(indigoGetInstance().createFileScanner(_filename.ptr()));
+   long long size = scanner->length();
+
+   if (threads <= 0)
+      threads = osGetProcessorsCount();
+
+   offsets.clear();
+
+   OffsetsIndexDispatcher dispatcher(_filename.ptr(), finder, size,
+      __max(size / (threads * 4) + 1, _offsets_index_min_chunk), offsets);
+
+   dispatcher.run(threads > 1 ? threads : 0);
+
+   converter(scanner.ref(), offsets);
+   end_offset = size;
+}
+
+//
+// IndigoRecordsLoader
+//
+
+IndigoRecordsLoader::IndigoRecordsLoader (int type) : IndigoObject(type)
+{
+   _read_ahead_pos = 0;
+}
+
+IndigoRecordsLoader::~IndigoRecordsLoader ()
+{
+}
+
+IndigoObject * IndigoRecordsLoader::next ()
+{
+   if (_read_ahead_pos < _read_ahead.size())
+      return _read_ahead.release(_read_ahead_pos++);
+
+   _read_ahead.clear();
+   _read_ahead_ends.clear();
+   _read_ahead_pos = 0;
+
+   if (_read_error.get() != 0)
+   {
+      AutoPtr<Exception> error(_read_error.release());
+      error->throwSelf();
+   }
+
+   if (_isEOF())
+   {
+      _scanned();
+      return 0;
+   }
+
+   int threads = indigoGetInstance().parsing_threads;
+
+   if (threads <= 0)
+      threads = osGetProcessorsCount();
+
+   if (threads == 1)
+      return _readRecord();
+
+   // Either some records are read or the reading error is stored
+   _readAhead(threads);
+   return next();
+}
+
+bool IndigoRecordsLoader::hasNext ()
+{
+   if (_read_ahead_pos < _read_ahead.size() || _read_error.get() != 0)
+      return true;
+
+   return !_isEOF();
+}
+
+long long IndigoRecordsLoader::tell ()
+{
+   // The scanner may be past the returned records or past the blank
+   // lines checked by _isEOF(), so the end of each record is kept
+   if (_read_ahead_pos > 0)
+      return _read_ahead_ends[_read_ahead_pos - 1];
+
+   return _tell();
+}
+
+void IndigoRecordsLoader::_clearReadAhead ()
+{
+   _read_ahead.clear();
+   _read_ahead_ends.clear();
+   _read_ahead_pos = 0;
+   _read_error.reset(0);
+}
+
+void IndigoRecordsLoader::_readAhead (int threads)
+{
+   // Records are split in the calling thread
+   try
+   {
+      while (_read_ahead.size() < threads * _parsing_window_per_thread && !_isEOF())
+      {
+         _read_ahead.add(_readRecord());
+         _read_ahead_ends.push(_tell());
+      }
+   }
+   catch (Exception &e)
+   {
+      // Records read before the error are returned first
+      _read_error.reset(e.clone());
+   }
+
+   if (_read_ahead.size() == 0)
+      return;
+
+   RecordsParsingDispatcher dispatcher(_read_ahead);
+
+   dispatcher.run(threads);
+}
+
 IndigoSdfLoader::IndigoSdfLoader (Scanner &scanner) :
-IndigoObject(SDF_LOADER)
+IndigoRecordsLoader(SDF_LOADER)
 {
-   sdf_loader.reset(new SdfLoader(scanner));
+   sdf_loader.reset(new SdfLoader(scanner, indigoGetInstance().getGZipThreads()));
 }
 
 IndigoSdfLoader::IndigoSdfLoader (const char *filename) :
-IndigoObject(SDF_LOADER)
+IndigoRecordsLoader(SDF_LOADER)
 {
    // AutoPtr guard in case of exception in SdfLoader (happens in case of empty file)
-   _own_scanner.reset(new FileScanner(indigoGetInstance().filename_encoding, filename));
-   sdf_loader.reset(new SdfLoader(_own_scanner.ref()));
+   Indigo &self = indigoGetInstance();
+
+   _own_scanner.reset(self.createFileScanner(filename));
+   sdf_loader.reset(new SdfLoader(_own_scanner.ref(), self.getGZipThreads()));
+   _index.reset(new IndigoOffsetsIndex(filename, SDF_LOADER));
+
+   QS_DEF(Array<long long>, offsets);
+   long long end_offset;
+
+   if (self.file_offsets_index && _index->load(offsets, end_offset))
+      sdf_loader->setOffsets(offsets, end_offset);
 }
 
 IndigoSdfLoader::~IndigoSdfLoader ()
@@ -205,11 +670,8 @@ IndigoRdfReaction::~IndigoRdfReaction ()
 {
 }
 
-IndigoObject * IndigoSdfLoader::next ()
+IndigoRdfData * IndigoSdfLoader::_readRecord ()
 {
-   if (sdf_loader->isEOF())
-      return 0;
-
    int counter = sdf_loader->currentNumber();
    long long offset = sdf_loader->tell();
 
@@ -221,44 +683,89 @@ IndigoObject * IndigoSdfLoader::next ()
 
 IndigoObject * IndigoSdfLoader::at (int index)
 {
+   _clearReadAhead();
    sdf_loader->readAt(index);
 
    return new IndigoRdfMolecule(sdf_loader->data, sdf_loader->properties,
                                 index, 0LL);
 }
 
-bool IndigoSdfLoader::hasNext ()
+bool IndigoSdfLoader::_isEOF ()
+{
+   return sdf_loader->isEOF();
+}
+
+void IndigoSdfLoader::_scanned ()
+{
+   // All the records are read at the end of the file
+   if (_index.get() != 0)
+      _index->saveScanned(sdf_loader->offsets(), sdf_loader->endOffset());
+}
+
+int IndigoSdfLoader::count ()
 {
-   return !sdf_loader->isEOF();
+   int res = sdf_loader->count();
+
+   if (_index.get() != 0)
+      _index->saveScanned(sdf_loader->offsets(), sdf_loader->endOffset());
+   return res;
+}
+
+int IndigoSdfLoader::buildOffsetsIndex (int threads)
+{
+   if (_index.get() == 0)
+      throw IndigoError("offsets index can be built only for files");
+
+   // Parts of gzipped files can't be scanned independently
+   if (sdf_loader->isCompressed())
+      sdf_loader->count();
+   else
+   {
+      QS_DEF(Array<long long>, offsets);
+      long long end_offset;
+
+      _index->build(threads, SdfLoader::findRecordBoundaries, SdfLoader::boundariesToOffsets,
+                    offsets, end_offset);
+      sdf_loader->setOffsets(offsets, end_offset);
+   }
+
+   _index->save(sdf_loader->offsets(), sdf_loader->endOffset());
+   return sdf_loader->offsets().size();
 }
 
-long long IndigoSdfLoader::tell ()
+long long IndigoSdfLoader::_tell ()
 {
    return sdf_loader->tell();
 }
 
 IndigoRdfLoader::IndigoRdfLoader (Scanner &scanner) :
-IndigoObject(RDF_LOADER)
+IndigoRecordsLoader(RDF_LOADER)
 {
-   rdf_loader = new RdfLoader(scanner);
+   rdf_loader = new RdfLoader(scanner, indigoGetInstance().getGZipThreads());
 }
 
 IndigoRdfLoader::IndigoRdfLoader (const char *filename) :
-IndigoObject(RDF_LOADER)
+IndigoRecordsLoader(RDF_LOADER)
 {
-   _own_scanner.reset(new FileScanner(indigoGetInstance().filename_encoding, filename));
-   rdf_loader.reset(new RdfLoader(_own_scanner.ref()));
+   Indigo &self = indigoGetInstance();
+
+   _own_scanner.reset(self.createFileScanner(filename));
+   rdf_loader.reset(new RdfLoader(_own_scanner.ref(), self.getGZipThreads()));
+   _index.reset(new IndigoOffsetsIndex(filename, RDF_LOADER));
+
+   QS_DEF(Array<long long>, offsets);
+   long long end_offset;
+
+   if (self.file_offsets_index && _index->load(offsets, end_offset))
+      rdf_loader->setOffsets(offsets, end_offset);
 }
 
 IndigoRdfLoader::~IndigoRdfLoader ()
 {
 }
 
-IndigoObject * IndigoRdfLoader::next ()
+IndigoRdfData * IndigoRdfLoader::_readRecord ()
 {
-   if (rdf_loader->isEOF())
-      return 0;
-
    int counter = rdf_loader->currentNumber();
    long long offset = rdf_loader->tell();
 
@@ -274,6 +781,7 @@ IndigoObject * IndigoRdfLoader::next ()
 
 IndigoObject * IndigoRdfLoader::at (int index)
 {
+   _clearReadAhead();
    rdf_loader->readAt(index);
 
    if (rdf_loader->isMolecule())
@@ -284,14 +792,52 @@ IndigoObject * IndigoRdfLoader::at (int index)
 }
 
 
-long long IndigoRdfLoader::tell ()
+long long IndigoRdfLoader::_tell ()
 {
    return rdf_loader->tell();
 }
 
-bool IndigoRdfLoader::hasNext ()
+bool IndigoRdfLoader::_isEOF ()
 {
-   return !rdf_loader->isEOF();
+   return rdf_loader->isEOF();
+}
+
+void IndigoRdfLoader::_scanned ()
+{
+   // All the records are read at the end of the file
+   if (_index.get() != 0)
+      _index->saveScanned(rdf_loader->offsets(), rdf_loader->endOffset());
+}
+
+int IndigoRdfLoader::count ()
+{
+   int res = rdf_loader->count();
+
+   if (_index.get() != 0)
+      _index->saveScanned(rdf_loader->offsets(), rdf_loader->endOffset());
+   return res;
+}
+
+int IndigoRdfLoader::buildOffsetsIndex (int threads)
+{
+   if (_index.get() == 0)
+      throw IndigoError("offsets index can be built only for files");
+
+   // Parts of gzipped files can't be scanned independently
+   if (rdf_loader->isCompressed())
+      rdf_loader->count();
+   else
+   {
+      QS_DEF(Array<long long>, offsets);
+      long long end_offset;
+
+      _index->build(threads, RdfLoader::findRecordBoundaries, RdfLoader::boundariesToOffsets,
+                    offsets, end_offset);
+      rdf_loader->setOffsets(offsets, end_offset);
+   }
+
+   _index->save(rdf_loader->offsets(), rdf_loader->endOffset());
+   return rdf_loader->offsets().size();
 }
 
 IndigoSmilesMolecule::IndigoSmilesMolecule (Array<char> &smiles, int index, long long offset) :
@@ -335,6 +881,16 @@ IndigoObject * IndigoSmilesMolecule::clone ()
    return IndigoMolecule::cloneFrom(*this);
 }
 
+bool IndigoSmilesMolecule::loadFlatMolecule (FlatMolecule &flat)
+{
+   if (_loaded)
+      return false;
+
+   SmilesFlatLoader loader;
+
+   return loader.load(_data.ptr(), _data.size(), flat);
+}
+
 IndigoSmilesReaction::IndigoSmilesReaction (Array<char> &smiles, int index, long long offset) :
 IndigoRdfData(SMILES_REACTION, smiles, index, offset)
 {
@@ -377,7 +933,7 @@ IndigoObject * IndigoSmilesReaction::clone ()
 CP_DEF(IndigoMultilineSmilesLoader);
 
 IndigoMultilineSmilesLoader::IndigoMultilineSmilesLoader (Scanner &scanner) :
-IndigoObject(MULTILINE_SMILES_LOADER),
+IndigoRecordsLoader(MULTILINE_SMILES_LOADER),
 CP_INIT, TL_CP_GET(_offsets)
 {
    _scanner = &scanner;
@@ -388,10 +944,10 @@ CP_INIT, TL_CP_GET(_offsets)
 }
 
 IndigoMultilineSmilesLoader::IndigoMultilineSmilesLoader (const char *filename) :
-IndigoObject(MULTILINE_SMILES_LOADER),
+IndigoRecordsLoader(MULTILINE_SMILES_LOADER),
 CP_INIT, TL_CP_GET(_offsets)
 {
-   _own_scanner.reset(new FileScanner(indigoGetInstance().filename_encoding, filename));
+   _own_scanner.reset(indigoGetInstance().createFileScanner(filename));
    _scanner = _own_scanner.get();
 
    _current_number = 0;
@@ -414,11 +970,8 @@ void IndigoMultilineSmilesLoader::_advance ()
       _max_offset = _scanner->tell();
 }
 
-IndigoObject * IndigoMultilineSmilesLoader::next ()
+IndigoRdfData * IndigoMultilineSmilesLoader::_readRecord ()
 {
-   if (_scanner->isEOF())
-      return 0;
-
    long long offset = _scanner->tell();
    int counter = _current_number;
 
@@ -430,12 +983,12 @@ IndigoObject * IndigoMultilineSmilesLoader::next ()
       return new IndigoSmilesReaction(_str, counter, offset);
 }
 
-bool IndigoMultilineSmilesLoader::hasNext ()
+bool IndigoMultilineSmilesLoader::_isEOF ()
 {
-   return !_scanner->isEOF();
+   return _scanner->isEOF();
 }
 
-long long IndigoMultilineSmilesLoader::tell ()
+long long IndigoMultilineSmilesLoader::_tell ()
 {
    return _scanner->tell();
 }
@@ -467,17 +1020,24 @@ int IndigoMultilineSmilesLoader::count ()
 
 IndigoObject * IndigoMultilineSmilesLoader::at (int index)
 {
+   _clearReadAhead();
+
    if (index < _offsets.size())
    {
       _scanner->seek(_offsets[index], SEEK_SET);
       _current_number = index;
-      return next();
    }
-   _scanner->seek(_max_offset, SEEK_SET);
-   _current_number = _offsets.size();
-   while (index > _offsets.size())
-      _advance();
-   return next();
+   else
+   {
+      _scanner->seek(_max_offset, SEEK_SET);
+      _current_number = _offsets.size();
+      while (index > _offsets.size())
+         _advance();
+   }
+
+   if (_scanner->isEOF())
+      return 0;
+   return _readRecord();
 }
 
 CEXPORT int indigoIterateSDF (int reader)
@@ -591,6 +1151,22 @@ CEXPORT long long indigoTell64(int handle)
    INDIGO_END(-1)
 }
 
+CEXPORT int indigoBuildOffsetsIndex (int iterator, int threads)
+{
+   INDIGO_BEGIN
+   {
+      IndigoObject &obj = self.getObject(iterator);
+
+      if (obj.type == IndigoObject::SDF_LOADER)
+         return ((IndigoSdfLoader &)obj).buildOffsetsIndex(threads);
+      if (obj.type == IndigoObject::RDF_LOADER)
+         return ((IndigoRdfLoader &)obj).buildOffsetsIndex(threads);
+
+      throw IndigoError("indigoBuildOffsetsIndex(): not applicable to %s", obj.debugInfo());
+   }
+   INDIGO_END(-1)
+}
+
 CEXPORT int indigoIterateSDFile (const char *filename)
 {
    INDIGO_BEGIN
@@ -21,6 +21,11 @@
 #include "reaction/reaction.h"
 #include "base_cpp/properties_map.h"
 
+namespace indigo
+{
+class FlatMolecule;
+}
+
 class IndigoRdfData : public IndigoObject
 {
 public:
@@ -78,43 +83,128 @@ protected:
 };
 
 
-class IndigoSdfLoader : public IndigoObject
+// Sidecar index with offsets of all the records of a SDF or RDF file
+// (<filename>.idx). The index is valid while the size and the modification
+// time of the file and the checksum of its head and tail are the same.
+// The index is written by indigoBuildOffsetsIndex() and, when
+// "file-offsets-index" option is enabled, after the first full scan.
+class IndigoOffsetsIndex
 {
 public:
-   IndigoSdfLoader (Scanner &scanner);
-   IndigoSdfLoader (const char *filename);
-   virtual ~IndigoSdfLoader ();
+   typedef void (*BoundariesFinder) (Scanner &scanner, long long end, Array<long long> &boundaries);
+   typedef void (*BoundariesConverter) (Scanner &scanner, Array<long long> &boundaries);
+
+   // format is the type of the loader: SDF_LOADER or RDF_LOADER
+   IndigoOffsetsIndex (const char *filename, int format);
+
+   // Loads the offsets if the index exists and is valid
+   bool load (Array<long long> &offsets, long long &end_offset);
+   void save (const Array<long long> &offsets, long long end_offset);
+
+   // Saves the offsets after the first full scan of the file if
+   // "file-offsets-index" option is enabled
+   void saveScanned (const Array<long long> &offsets, long long end_offset);
+
+   // Finds the offsets scanning the file in parallel chunks
+   void build (int threads, BoundariesFinder finder, BoundariesConverter converter,
+               Array<long long> &offsets, long long &end_offset);
+
+private:
+   Array<char> _filename;
+   Array<char> _index_filename;
+   int _format;
+   bool _saved;
+
+   void _getFileStamp (long long &size, long long &mtime, dword &checksum, bool &compressed);
+};
+
+// Base class of the iterators over records of SDF, RDF and SMILES files.
+// When "parsing-threads" option is greater than one, a window of records
+// is read ahead and parsed on the worker threads, and the records are
+// returned in the input order.
+class IndigoRecordsLoader : public IndigoObject
+{
+public:
+   explicit IndigoRecordsLoader (int type);
+   virtual ~IndigoRecordsLoader ();
 
    virtual IndigoObject * next ();
    virtual bool hasNext ();
 
+   // Offset of the end of the last record returned by next()
+   long long tell ();
+
+protected:
+   // Reads the next record without parsing it
+   virtual IndigoRdfData * _readRecord () = 0;
+   virtual bool _isEOF () = 0;
+   virtual long long _tell () = 0;
+   // Called when next() reaches the end of the input
+   virtual void _scanned () {}
+
+   // Drops the records read ahead before moving to another record
+   void _clearReadAhead ();
+
+private:
+   PtrArray<IndigoRdfData> _read_ahead;
+   // Offsets where the records read ahead end
+   Array<long long> _read_ahead_ends;
+   int _read_ahead_pos;
+   // Error of reading a record after the records read ahead
+   AutoPtr<Exception> _read_error;
+
+   void _readAhead (int threads);
+};
+
+class IndigoSdfLoader : public IndigoRecordsLoader
+{
+public:
+   IndigoSdfLoader (Scanner &scanner);
+   IndigoSdfLoader (const char *filename);
+   virtual ~IndigoSdfLoader ();
+
    IndigoObject * at (int index);
+   int count ();
 
-   long long tell ();
+   // Builds the offsets index of the file. Returns the number of records.
+   int buildOffsetsIndex (int threads);
 
    AutoPtr<SdfLoader> sdf_loader;
 
 protected:
    AutoPtr<Scanner>  _own_scanner;
+   // Offsets index of the file, if the loader reads a file
+   AutoPtr<IndigoOffsetsIndex> _index;
+
+   virtual IndigoRdfData * _readRecord ();
+   virtual bool _isEOF ();
+   virtual long long _tell ();
+   virtual void _scanned ();
 };
 
-class IndigoRdfLoader : public IndigoObject
+class IndigoRdfLoader : public IndigoRecordsLoader
 {
 public:
    IndigoRdfLoader (Scanner &scanner);
    IndigoRdfLoader (const char *filename);
    virtual ~IndigoRdfLoader ();
 
-   virtual IndigoObject * next ();
-   virtual bool hasNext ();
-
    IndigoObject * at (int index);
+   int count ();
 
-   long long tell ();
+   // Builds the offsets index of the file. Returns the number of records.
+   int buildOffsetsIndex (int threads);
 
    AutoPtr<RdfLoader> rdf_loader;
 protected:
    AutoPtr<Scanner>  _own_scanner;
+   // Offsets index of the file, if the loader reads a file
+   AutoPtr<IndigoOffsetsIndex> _index;
+
+   virtual IndigoRdfData * _readRecord ();
+   virtual bool _isEOF ();
+   virtual long long _tell ();
+   virtual void _scanned ();
 };
 
 class IndigoSmilesMolecule : public IndigoRdfData
@@ -128,6 +218,11 @@ public:
    virtual const char * getName ();
    virtual IndigoObject * clone ();
 
+   // Loads the molecule with SmilesFlatLoader without building Molecule.
+   // Returns false if the molecule is loaded already or SmilesFlatLoader
+   // can't load it, getMolecule() should be used then.
+   bool loadFlatMolecule (FlatMolecule &flat);
+
 protected:
    Molecule _mol;
 };
@@ -147,18 +242,13 @@ protected:
    Reaction _rxn;
 };
 
-class IndigoMultilineSmilesLoader : public IndigoObject
+class IndigoMultilineSmilesLoader : public IndigoRecordsLoader
 {
 public:
    IndigoMultilineSmilesLoader (Scanner &scanner);
    IndigoMultilineSmilesLoader (const char *filename);
    virtual ~IndigoMultilineSmilesLoader ();
 
-   long long tell ();
-
-   virtual IndigoObject * next ();
-   virtual bool hasNext ();
-
    IndigoObject * at (int index);
    int count ();
 
@@ -169,6 +259,10 @@ protected:
 
    void _advance ();
 
+   virtual IndigoRdfData * _readRecord ();
+   virtual bool _isEOF ();
+   virtual long long _tell ();
+
    CP_DECL;
    TL_CP_DECL(Array<long long>, _offsets);
    int _current_number;
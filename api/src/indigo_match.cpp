@@ -622,6 +622,11 @@ IndigoMoleculeSubstructureMatchIter*
       *prepared = true;
    }
 
+   // The prepared target is not changed by the matcher, except when the
+   // hydrogens are unfolded for the first time
+   if (indigoGetInstance().frozen_graphs)
+      target_prepared->freeze();
+
    AutoPtr<IndigoMoleculeSubstructureMatchIter>
       iter(new IndigoMoleculeSubstructureMatchIter(*target_prepared, query, target,
                                                   (mode == RESONANCE), max_embeddings != 1));
@@ -634,6 +639,7 @@ IndigoMoleculeSubstructureMatchIter*
 
    Indigo &indigo = indigoGetInstance();
    iter->matcher.arom_options = indigo.arom_options;
+   iter->matcher.use_candidate_sets = indigo.substructure_candidate_sets;
 
    iter->matcher.find_unique_embeddings = find_unique_embeddings;
    iter->matcher.find_unique_by_edges = embedding_edges_uniqueness;
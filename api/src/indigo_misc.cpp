@@ -27,6 +27,8 @@
 #include "indigo_array.h"
 #include "molecule/icm_saver.h"
 #include "molecule/icm_loader.h"
+#include "molecule/ifm_saver.h"
+#include "molecule/ifm_loader.h"
 #include "reaction/icr_saver.h"
 #include "reaction/icr_loader.h"
 #include "indigo_reaction.h"
@@ -626,10 +628,10 @@ CEXPORT int indigoCount (int item)
          return IndigoArray::cast(obj).objects.size();
 
       if (obj.type == IndigoObject::SDF_LOADER)
-         return ((IndigoSdfLoader &)obj).sdf_loader->count();
+         return ((IndigoSdfLoader &)obj).count();
 
       if (obj.type == IndigoObject::RDF_LOADER)
-         return ((IndigoRdfLoader &)obj).rdf_loader->count();
+         return ((IndigoRdfLoader &)obj).count();
 
       if (obj.type == IndigoObject::MULTILINE_SMILES_LOADER)
          return ((IndigoMultilineSmilesLoader &)obj).count();
@@ -647,7 +649,16 @@ CEXPORT int indigoSerialize (int item, byte **buf, int *size)
       auto &tmp = self.getThreadTmpData();
       ArrayOutput out(tmp.string);
 
-      if (IndigoBaseMolecule::is(obj))
+      if (IndigoBaseMolecule::is(obj) && self.serialize_fixed_layout)
+      {
+         IndigoObject &src = (obj.type == IndigoObject::ARRAY_ELEMENT) ?
+            ((IndigoArrayElement &)obj).get() : obj;
+
+         IfmSaver saver(out);
+         saver.gross_formula_add_rsites = self.gross_formula_options.add_rsites;
+         saver.saveMolecule(obj.getMolecule(), &src.getProperties());
+      }
+      else if (IndigoBaseMolecule::is(obj))
       {
          Molecule &mol = obj.getMolecule();
 
@@ -688,6 +699,15 @@ CEXPORT int indigoUnserialize (const byte *buf, int size)
          loader.loadMolecule(im->mol);
          return self.addObject(im.release());
       }
+      else if (size >= 3 && IfmSaver::checkVersion((const char *)buf))
+      {
+         IfmLoader loader(buf, size);
+         AutoPtr<IndigoMolecule> im(new IndigoMolecule());
+         loader.loadMolecule(im->mol);
+         for (int i = 0; i < loader.propertyCount(); i++)
+            im->getProperties().insert(loader.propertyName(i), loader.propertyValue(i));
+         return self.addObject(im.release());
+      }
       else if (IcrSaver::checkVersion((const char *)buf))
       {
          BufferScanner scanner(buf, size);
@@ -702,6 +722,91 @@ CEXPORT int indigoUnserialize (const byte *buf, int size)
    INDIGO_END(-1)
 }
 
+CEXPORT int indigoSerializedCountAtoms (const byte *buf, int size)
+{
+   INDIGO_BEGIN
+   {
+      return IfmLoader(buf, size).atomCount();
+   }
+   INDIGO_END(-1)
+}
+
+CEXPORT int indigoSerializedCountBonds (const byte *buf, int size)
+{
+   INDIGO_BEGIN
+   {
+      return IfmLoader(buf, size).bondCount();
+   }
+   INDIGO_END(-1)
+}
+
+CEXPORT const char * indigoSerializedGrossFormula (const byte *buf, int size)
+{
+   INDIGO_BEGIN
+   {
+      IfmLoader loader(buf, size);
+      const char *formula = loader.grossFormula();
+
+      if (formula == 0)
+         throw IndigoError("indigoSerializedGrossFormula(): gross formula was not saved");
+
+      // The loader may read a copy of an unaligned buffer
+      auto &tmp = self.getThreadTmpData();
+      tmp.string.readString(formula, true);
+      return tmp.string.ptr();
+   }
+   INDIGO_END(0)
+}
+
+CEXPORT const float * indigoSerializedXYZ (const byte *buf, int size, int atom)
+{
+   INDIGO_BEGIN
+   {
+      IfmLoader loader(buf, size);
+
+      if (!loader.haveXyz())
+         throw IndigoError("indigoSerializedXYZ(): molecule has no coordinates");
+
+      auto &tmp = self.getThreadTmpData();
+      memcpy(tmp.xyz, loader.getAtom(atom).xyz, sizeof(tmp.xyz));
+      return tmp.xyz;
+   }
+   INDIGO_END(0)
+}
+
+CEXPORT const char * indigoSerializedName (const byte *buf, int size)
+{
+   INDIGO_BEGIN
+   {
+      IfmLoader loader(buf, size);
+      auto &tmp = self.getThreadTmpData();
+
+      tmp.string.readString(loader.name(), true);
+      return tmp.string.ptr();
+   }
+   INDIGO_END(0)
+}
+
+CEXPORT const char * indigoSerializedGetProperty (const byte *buf, int size, const char *prop)
+{
+   INDIGO_BEGIN
+   {
+      if (prop == 0 || *prop == 0)
+         throw IndigoError("indigoSerializedGetProperty(): null or empty property name");
+
+      IfmLoader loader(buf, size);
+      const char *value = loader.findProperty(prop);
+
+      if (value == 0)
+         throw IndigoError("indigoSerializedGetProperty(): property not found: %s", prop);
+
+      auto &tmp = self.getThreadTmpData();
+      tmp.string.readString(value, true);
+      return tmp.string.ptr();
+   }
+   INDIGO_END(0)
+}
+
 CEXPORT int indigoClear (int item)
 {
    INDIGO_BEGIN
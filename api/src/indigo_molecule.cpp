@@ -15,9 +15,11 @@
 #include "indigo_molecule.h"
 #include "indigo_io.h"
 #include "indigo_array.h"
+#include "indigo_loaders.h"
 #include "molecule/molecule_auto_loader.h"
 #include "base_cpp/output.h"
 #include "molecule/molecule_gross_formula.h"
+#include "molecule/flat_molecule.h"
 #include "molecule/molecule_mass.h"
 #include "molecule/query_molecule.h"
 #include "molecule/smiles_loader.h"
@@ -3546,7 +3548,17 @@ CEXPORT int indigoCountHeavyAtoms (int molecule)
 {
    INDIGO_BEGIN
    {
-      BaseMolecule &mol = self.getObject(molecule).getBaseMolecule();
+      IndigoObject &obj = self.getObject(molecule);
+
+      if (obj.type == IndigoObject::SMILES_MOLECULE)
+      {
+         QS_DEF(FlatMolecule, flat);
+
+         if (((IndigoSmilesMolecule &)obj).loadFlatMolecule(flat))
+            return flat.countHeavyAtoms();
+      }
+
+      BaseMolecule &mol = obj.getBaseMolecule();
       int i, cnt = 0;
 
       for (i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
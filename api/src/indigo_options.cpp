@@ -225,6 +225,13 @@ _IndigoBasicOptionsHandlersSetter::_IndigoBasicOptionsHandlersSetter ()
    mgr.setOptionHandlerBool("molfile-saving-add-implicit-h", SETTER_GETTER_BOOL_OPTION(indigo.molfile_saving_add_implicit_h));
    mgr.setOptionHandlerBool("smiles-saving-write-name", SETTER_GETTER_BOOL_OPTION(indigo.smiles_saving_write_name));
    mgr.setOptionHandlerString("filename-encoding", indigoSetFilenameEncoding, indigoGetFilenameEncoding);
+   mgr.setOptionHandlerBool("file-memory-mapping", SETTER_GETTER_BOOL_OPTION(indigo.file_memory_mapping));
+   mgr.setOptionHandlerInt("file-read-ahead", SETTER_GETTER_INT_OPTION(indigo.file_read_ahead));
+   mgr.setOptionHandlerInt("parsing-threads", SETTER_GETTER_INT_OPTION(indigo.parsing_threads));
+   mgr.setOptionHandlerInt("saving-threads", SETTER_GETTER_INT_OPTION(indigo.saving_threads));
+   mgr.setOptionHandlerBool("file-offsets-index", SETTER_GETTER_BOOL_OPTION(indigo.file_offsets_index));
+   mgr.setOptionHandlerInt("gzip-threads", SETTER_GETTER_INT_OPTION(indigo.gzip_threads));
+   mgr.setOptionHandlerBool("gzip-file-output", SETTER_GETTER_BOOL_OPTION(indigo.gzip_file_output));
    mgr.setOptionHandlerInt("fp-ord-qwords", SETTER_GETTER_INT_OPTION(indigo.fp_params.ord_qwords));
    mgr.setOptionHandlerInt("fp-sim-qwords", SETTER_GETTER_INT_OPTION(indigo.fp_params.sim_qwords));
    mgr.setOptionHandlerInt("fp-any-qwords", SETTER_GETTER_INT_OPTION(indigo.fp_params.any_qwords));
@@ -235,6 +242,8 @@ _IndigoBasicOptionsHandlersSetter::_IndigoBasicOptionsHandlersSetter ()
 
    mgr.setOptionHandlerString("embedding-uniqueness", indigoSetEmbeddingUniqueness, indigoGetEmbeddingUniqueness);
    mgr.setOptionHandlerInt("max-embeddings", indigoSetMaxEmbeddings, indigoGetMaxEmbeddings);
+   mgr.setOptionHandlerBool("substructure-candidate-sets", SETTER_GETTER_BOOL_OPTION(indigo.substructure_candidate_sets));
+   mgr.setOptionHandlerBool("frozen-graphs", SETTER_GETTER_BOOL_OPTION(indigo.frozen_graphs));
 
    mgr.setOptionHandlerInt("layout-max-iterations", SETTER_GETTER_INT_OPTION(indigo.layout_max_iterations));
 
@@ -244,6 +253,7 @@ _IndigoBasicOptionsHandlersSetter::_IndigoBasicOptionsHandlersSetter ()
    mgr.setOptionHandlerInt("timeout", SETTER_GETTER_INT_OPTION(indigo.cancellation_timeout));
 
    mgr.setOptionHandlerBool("serialize-preserve-ordering", SETTER_GETTER_BOOL_OPTION(indigo.preserve_ordering_in_serialize));
+   mgr.setOptionHandlerBool("serialize-fixed-layout", SETTER_GETTER_BOOL_OPTION(indigo.serialize_fixed_layout));
 
    mgr.setOptionHandlerString("aromaticity-model", indigoSetAromaticityModel, indigoGetAromaticityModel);
    mgr.setOptionHandlerBool("dearomatize-verification", SETTER_GETTER_BOOL_OPTION(indigo.arom_options.dearomatize_check));
@@ -21,6 +21,7 @@
 #include "base_cpp/output.h"
 #include "base_cpp/scanner.h"
 #include "base_cpp/auto_ptr.h"
+#include "base_cpp/os_thread_wrapper.h"
 #include "molecule/cml_saver.h"
 #include "molecule/molfile_saver.h"
 #include "molecule/smiles_saver.h"
@@ -111,20 +112,140 @@ void IndigoSdfSaver::appendMolfile (Output &out, IndigoObject &obj)
    }
 }
 
-void IndigoSdfSaver::append (Output &out, IndigoObject &obj)
+void IndigoSdfSaver::appendRecord (Output &out, BaseMolecule &mol, PropertiesMap &props)
 {
-   appendMolfile(out, obj);
+   Indigo &indigo = indigoGetInstance();
 
-   auto& props = obj.getProperties();
+   MolfileSaver saver(out);
+   indigo.initMolfileSaver(saver);
+   saver.saveBaseMolecule(mol);
 
-      for (auto i : props.elements()) {
-         out.printf(">  <%s>\n%s\n\n", props.key(i), props.value(i));
-      }
+   for (auto i : props.elements())
+      out.printf(">  <%s>\n%s\n\n", props.key(i), props.value(i));
 
    out.printfCR("$$$$");
+}
+
+void IndigoSdfSaver::append (Output &out, IndigoObject &obj)
+{
+   if (!IndigoBaseMolecule::is(obj))
+      throw IndigoError("%s can not be converted to Molfile", obj.debugInfo());
+
+   appendRecord(out, obj.getBaseMolecule(), obj.getProperties());
    out.flush();
 }
 
+// Number of records saved by one command of the SDF saver
+static const int _saving_chunk_size = 16;
+// Number of records queued per saving thread
+static const int _saving_window_per_thread = 64;
+
+class IndigoSdfSavingRecord
+{
+public:
+   // Copy of the appended object
+   AutoPtr<BaseMolecule> mol;
+   PropertiesMap properties;
+   // Serialized record
+   Array<char> data;
+   AutoPtr<Exception> error;
+   // Index of the record in the saver
+   int index;
+};
+
+namespace
+{
+   class SdfSavingCommand : public OsCommand
+   {
+   public:
+      virtual void clear ()
+      {
+         first = last = 0;
+      }
+
+      virtual void execute (OsCommandResult &result)
+      {
+         for (int i = first; i < last; i++)
+         {
+            IndigoSdfSavingRecord &record = *(*records)[i];
+
+            try
+            {
+               ArrayOutput out(record.data);
+               IndigoSdfSaver::appendRecord(out, record.mol.ref(), record.properties);
+            }
+            catch (Exception &e)
+            {
+               record.error.reset(e.clone());
+            }
+         }
+      }
+
+      PtrArray<IndigoSdfSavingRecord> *records;
+      int first, last;
+   };
+
+   // Serializes the queued records on the worker threads. Each record is
+   // saved into its own buffer, so results need no handling.
+   class SdfSavingDispatcher : public OsCommandDispatcher
+   {
+   public:
+      SdfSavingDispatcher (PtrArray<IndigoSdfSavingRecord> &records, int count) :
+         OsCommandDispatcher(HANDLING_ORDER_ANY, true), _records(records), _count(count), _next(0)
+      {
+      }
+
+   protected:
+      virtual OsCommand * _allocateCommand ()
+      {
+         return new SdfSavingCommand();
+      }
+
+      virtual bool _setupCommand (OsCommand &command)
+      {
+         if (_next >= _count)
+            return false;
+
+         SdfSavingCommand &cmd = (SdfSavingCommand &)command;
+
+         cmd.records = &_records;
+         cmd.first = _next;
+         cmd.last = __min(_next + _saving_chunk_size, _count);
+
+         _next = cmd.last;
+         return true;
+      }
+
+   private:
+      PtrArray<IndigoSdfSavingRecord> &_records;
+      int _count;
+      int _next;
+   };
+}
+
+IndigoSdfSaver::IndigoSdfSaver (Output &output) : IndigoSaver(output),
+   _indigo(indigoGetInstance())
+{
+   _queued = 0;
+   _appended = 0;
+}
+
+IndigoSdfSaver::~IndigoSdfSaver ()
+{
+   // The base destructor can't reach _appendFooter() of this class. Errors
+   // can't be thrown from here, so they are reported like INDIGO_END does.
+   try
+   {
+      close();
+   }
+   catch (Exception &e)
+   {
+      _indigo.error_message.readString(e.message(), true);
+      if (_indigo.error_handler != 0)
+         _indigo.error_handler(e.message(), _indigo.error_handler_context);
+   }
+}
+
 const char * IndigoSdfSaver::debugInfo () 
 {
    return "<SDF saver>";
@@ -132,7 +253,92 @@ const char * IndigoSdfSaver::debugInfo ()
 
 void IndigoSdfSaver::_append (IndigoObject &object)
 {
-   append(_output, object);
+   int threads = _indigo.saving_threads;
+
+   if (threads <= 0)
+      threads = osGetProcessorsCount();
+
+   if (threads == 1)
+   {
+      // The option could have been changed after some records were queued
+      _saveQueued();
+      _appended++;
+      append(_output, object);
+      return;
+   }
+
+   if (!IndigoBaseMolecule::is(object))
+      throw IndigoError("%s can not be converted to Molfile", object.debugInfo());
+
+   BaseMolecule &mol = object.getBaseMolecule();
+   PropertiesMap &props = object.getProperties();
+
+   if (_queued == _records.size())
+      _records.add(new IndigoSdfSavingRecord());
+
+   IndigoSdfSavingRecord &record = *_records[_queued];
+
+   if (record.mol.get() == 0 || record.mol->isQueryMolecule() != mol.isQueryMolecule())
+      record.mol.reset(mol.neu());
+   record.mol->clone(mol, 0, 0);
+   record.properties.copy(props);
+   record.error.reset(0);
+   record.index = _appended++;
+   _queued++;
+
+   if (_queued >= threads * _saving_window_per_thread)
+      _saveQueued();
+}
+
+void IndigoSdfSaver::_appendFooter ()
+{
+   _saveQueued();
+}
+
+void IndigoSdfSaver::_saveQueued ()
+{
+   if (_queued == 0)
+      return;
+
+   int threads = _indigo.saving_threads;
+
+   if (threads <= 0)
+      threads = osGetProcessorsCount();
+
+   SdfSavingDispatcher dispatcher(_records, _queued);
+
+   dispatcher.run(__max(threads, 1));
+
+   // Records that failed are skipped, and the first error is raised with
+   // its record index after the rest of the batch is written
+   IndigoSdfSavingRecord *failed = 0;
+   int failed_count = 0;
+
+   for (int i = 0; i < _queued; i++)
+   {
+      IndigoSdfSavingRecord &record = *_records[i];
+
+      if (record.error.get() != 0)
+      {
+         if (failed == 0)
+            failed = &record;
+         failed_count++;
+         continue;
+      }
+      _output.write(record.data.ptr(), record.data.size());
+   }
+
+   _queued = 0;
+   _output.flush();
+
+   if (failed != 0)
+   {
+      IndigoError error("SDF saver: record #%d: %s", failed->index, failed->error->message());
+
+      if (failed_count > 1)
+         error.appendMessage(" (%d more records of the batch failed)", failed_count - 1);
+      throw error;
+   }
 }
 
 CEXPORT int indigoSdfAppend (int output, int molecule)
@@ -526,7 +732,7 @@ CEXPORT int indigoCreateFileSaver (const char *filename, const char *format)
 {
    INDIGO_BEGIN
    {
-      AutoPtr<FileOutput> output(new FileOutput(self.filename_encoding, filename));
+      AutoPtr<Output> output(self.createFileOutput(filename));
       AutoPtr<IndigoSaver> saver(IndigoSaver::create(output.ref(), format));
       saver->acquireOutput(output.release());
       return self.addObject(saver.release());
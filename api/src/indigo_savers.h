@@ -47,16 +47,40 @@ private:
    Output *_own_output;
 };
 
+class IndigoSdfSavingRecord;
+
+// When "saving-threads" option is greater than one, the appended records
+// are copied into a queue, serialized on the worker threads into reusable
+// buffers, and written in the input order with one write per record.
+// Errors of the queued records are raised by the next batch or by close(),
+// so indigoClose() has to be called to get them. A saver freed without
+// closing passes them to the session error handler.
 class IndigoSdfSaver : public IndigoSaver
 {
 public:
-   IndigoSdfSaver (Output &output) : IndigoSaver(output) {}
+   IndigoSdfSaver (Output &output);
+   virtual ~IndigoSdfSaver ();
+
    virtual const char * debugInfo ();
    static void append (Output &output, IndigoObject &object);
    static void appendMolfile (Output &output, IndigoObject &object);
+   // Writes the molfile, the properties and "$$$$" line without flushing
+   static void appendRecord (Output &output, BaseMolecule &mol, PropertiesMap &properties);
 
 protected:
    virtual void _append (IndigoObject &object);
+   virtual void _appendFooter ();
+
+private:
+   // Records are reused by the next batches
+   PtrArray<IndigoSdfSavingRecord> _records;
+   int _queued;
+   // Number of appended records, used to report the failed ones
+   int _appended;
+   // The destructor can run while the session instance is released
+   Indigo &_indigo;
+
+   void _saveQueued ();
 };
 
 class IndigoSmilesSaver : public IndigoSaver
@@ -0,0 +1,86 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "indigo.h"
+#include "base_c/nano.h"
+
+// Allocations benchmark: all molecules of a SDF file are loaded, and the
+// number of heap allocations per record is counted along with the
+// throughput. The allocator is intercepted in this executable, which is
+// possible with glibc only; elsewhere only the throughput is printed.
+
+static volatile long allocations = 0;
+
+#ifdef __GLIBC__
+extern void * __libc_malloc (size_t size);
+extern void * __libc_calloc (size_t count, size_t size);
+extern void * __libc_realloc (void *ptr, size_t size);
+
+void * malloc (size_t size)
+{
+   __sync_fetch_and_add(&allocations, 1);
+   return __libc_malloc(size);
+}
+
+void * calloc (size_t count, size_t size)
+{
+   __sync_fetch_and_add(&allocations, 1);
+   return __libc_calloc(count, size);
+}
+
+void * realloc (void *ptr, size_t size)
+{
+   __sync_fetch_and_add(&allocations, 1);
+   return __libc_realloc(ptr, size);
+}
+#endif
+
+int main (int argc, char *argv[])
+{
+   long records = 0, errors = 0, start_allocations;
+   int iter, item;
+   qword start;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <molecules.sdf>\n", argv[0]);
+      return -1;
+   }
+
+   iter = indigoIterateSDFile(argv[1]);
+   if (iter == -1)
+   {
+      printf("%s\n", indigoGetLastError());
+      return -1;
+   }
+
+   start = nanoClock();
+   start_allocations = allocations;
+
+   while ((item = indigoNext(iter)) != 0)
+   {
+      if (item == -1)
+      {
+         printf("%s\n", indigoGetLastError());
+         return -1;
+      }
+
+      if (indigoCountAtoms(item) < 0)
+         errors++;
+      records++;
+      indigoFree(item);
+   }
+
+   float sec = nanoHowManySeconds(nanoClock() - start);
+
+   printf("%10.1f records/s, %ld records, %ld errors", records / sec, records, errors);
+#ifdef __GLIBC__
+   printf(", %.1f allocations/record", records > 0 ? (double)(allocations - start_allocations) / records : 0.0);
+#endif
+   printf("\n");
+
+   indigoFree(iter);
+   return 0;
+}
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "indigo.h"
+#include "bench-items.h"
+
+int benchIterateFile (const char *filename)
+{
+   const char *ext = strrchr(filename, '.');
+
+   if (ext != NULL && (strcmp(ext, ".sdf") == 0 || strcmp(ext, ".sd") == 0))
+      return indigoIterateSDFile(filename);
+   return indigoIterateSmilesFile(filename);
+}
+
+int benchLoadItems (const char *filename, const char **defaults, int query)
+{
+   int array = indigoCreateArray();
+   int i, item, iter;
+
+   if (filename == NULL || strcmp(filename, "-") == 0)
+   {
+      for (i = 0; defaults[i] != NULL; i++)
+      {
+         item = query ? indigoLoadSmartsFromString(defaults[i]) : indigoLoadMoleculeFromString(defaults[i]);
+         if (item == -1)
+            return -1;
+         indigoArrayAdd(array, item);
+         indigoFree(item);
+      }
+      return array;
+   }
+
+   // Queries are read as SMARTS strings from the lines of the file
+   iter = query ? indigoIterateSmilesFile(filename) : benchIterateFile(filename);
+
+   if (iter == -1)
+      return -1;
+
+   while ((item = indigoNext(iter)) != 0)
+   {
+      if (item == -1)
+         continue;
+
+      if (query)
+      {
+         int q = indigoLoadSmartsFromString(indigoRawData(item));
+
+         if (q != -1)
+         {
+            indigoArrayAdd(array, q);
+            indigoFree(q);
+         }
+      }
+      else
+         indigoArrayAdd(array, item);
+      indigoFree(item);
+   }
+
+   indigoFree(iter);
+   return array;
+}
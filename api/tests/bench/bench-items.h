@@ -0,0 +1,23 @@
+#ifndef __bench_items_h__
+#define __bench_items_h__
+
+// Helpers shared by the benchmarks that load their input from files
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Iterates a SDF file (.sdf or .sd) or a SMILES file (any other extension)
+int benchIterateFile (const char *filename);
+
+// Loads molecules, or SMARTS queries if query is nonzero, into an Indigo
+// array. The items are taken from the file or, if filename is NULL or "-",
+// from the NULL-terminated list of defaults. Records that fail to load are
+// skipped. Returns -1 on error.
+int benchLoadItems (const char *filename, const char **defaults, int query);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
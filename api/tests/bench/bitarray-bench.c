@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "base_c/bitarray.h"
+#include "base_c/nano.h"
+
+// Micro-benchmark for the population count kernels used by the similarity
+// search: ones count, common ones and unique ones over blocks of fingerprints
+
+static const char *kernels[] = {"scalar", "popcnt", "avx2", "avx512"};
+
+static void benchKernel (const char *kernel, const byte *data, int fp_size, int fp_count, int repeats)
+{
+   int *counts = (int *)malloc(fp_count * sizeof(int));
+   qword start;
+   float ones_sec, common_sec, unique_sec;
+   double total_bytes = (double)fp_size * fp_count * repeats;
+   int i;
+
+   start = nanoClock();
+   for (i = 0; i < repeats; i++)
+      bitGetOnesCountBlock(data, fp_size, fp_count, counts);
+   ones_sec = nanoHowManySeconds(nanoClock() - start);
+
+   start = nanoClock();
+   for (i = 0; i < repeats; i++)
+      bitCommonOnesBlock(data + (i % fp_count) * fp_size, data, fp_size, fp_count, counts);
+   common_sec = nanoHowManySeconds(nanoClock() - start);
+
+   start = nanoClock();
+   for (i = 0; i < repeats; i++)
+      bitUniqueOnesBlock(data + (i % fp_count) * fp_size, data, fp_size, fp_count, counts);
+   unique_sec = nanoHowManySeconds(nanoClock() - start);
+
+   printf("%-8s %5d bytes: ones %8.2f GB/s, common %8.2f GB/s, unique %8.2f GB/s\n", kernel, fp_size,
+      total_bytes / ones_sec / 1e9, total_bytes / common_sec / 1e9, total_bytes / unique_sec / 1e9);
+
+   free(counts);
+}
+
+int main (int argc, char *argv[])
+{
+   static const int fp_sizes[] = {64, 467};
+   int fp_count = 1 << 16;
+   int repeats = 50;
+   int s, k, i;
+
+   if (argc > 1)
+      repeats = atoi(argv[1]);
+
+   printf("Default kernel: %s\n", bitGetKernelName());
+
+   for (s = 0; s < NELEM(fp_sizes); s++)
+   {
+      int fp_size = fp_sizes[s];
+      byte *data = (byte *)malloc(fp_size * fp_count);
+      int reference = -1;
+
+      srand(fp_size);
+      for (i = 0; i < fp_size * fp_count; i++)
+         data[i] = (byte)(rand() & rand());
+
+      for (k = 0; k < NELEM(kernels); k++)
+      {
+         int check;
+
+         if (!bitSetKernel(kernels[k]))
+         {
+            printf("%-8s is not supported by the CPU\n", kernels[k]);
+            continue;
+         }
+
+         check = bitCommonOnes(data, data + fp_size, fp_size * (fp_count - 1)) + bitGetOnesCount(data, fp_size * fp_count);
+         if (reference == -1)
+            reference = check;
+         else if (check != reference)
+         {
+            printf("%s kernel results differ from the scalar ones\n", kernels[k]);
+            return -1;
+         }
+
+         benchKernel(kernels[k], data, fp_size, fp_count, repeats);
+      }
+
+      free(data);
+   }
+
+   return 0;
+}
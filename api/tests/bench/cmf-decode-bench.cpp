@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "base_c/nano.h"
+#include "base_cpp/output.h"
+#include "base_cpp/scanner.h"
+#include "lzw/lzw_decoder.h"
+#include "molecule/cmf_loader.h"
+#include "molecule/cmf_saver.h"
+#include "molecule/molecule.h"
+#include "molecule/molfile_loader.h"
+#include "molecule/sdf_loader.h"
+
+using namespace indigo;
+
+// CMF decoding benchmark: the molecules of a SDF file are compressed with
+// a shared LZW dictionary, as Bingo indexes them, and decoded back with the
+// loader reading one symbol at a time through LzwScanner, with the loader
+// decoding the whole buffer at once and with CmfLoader::decodeMany(). The
+// throughput is printed in MB/s of compressed data, and the checksums of
+// the decoded molecules must be the same.
+
+static dword checksum (Molecule &mol, dword sum)
+{
+   sum = sum * 31 + mol.vertexCount();
+   for (int i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
+      sum = (sum * 31 + mol.getAtomNumber(i)) * 31 + mol.getAtomCharge(i);
+   for (int i = mol.edgeBegin(); i != mol.edgeEnd(); i = mol.edgeNext(i))
+      sum = (sum * 31 + mol.getEdge(i).beg) * 31 + mol.getBondOrder(i);
+   return sum * 31 + mol.stereocenters.size();
+}
+
+static void report (const char *name, qword start, long long bytes, dword sum)
+{
+   float sec = nanoHowManySeconds(nanoClock() - start);
+
+   printf("%-16s %8.2f MB/s, checksum %08x\n", name, bytes / sec / 1048576, sum);
+}
+
+int main (int argc, char *argv[])
+{
+   if (argc < 2)
+   {
+      printf("Usage: %s <molecules.sdf>\n", argv[0]);
+      return -1;
+   }
+
+   LzwDict dict;
+   ObjArray< Array<char> > buffers;
+   Array<const byte *> ptrs;
+   Array<int> sizes;
+   ObjArray<Molecule> molecules;
+   Molecule mol;
+   long long bytes = 0, symbols = 0;
+   dword sums[3] = {0, 0, 0};
+   int i;
+
+   try
+   {
+      FileScanner file(argv[1]);
+      SdfLoader sdf(file);
+
+      while (!sdf.isEOF())
+      {
+         sdf.readNext();
+
+         try
+         {
+            BufferScanner scanner(sdf.data);
+            MolfileLoader loader(scanner);
+
+            loader.loadMolecule(mol);
+         }
+         catch (Exception &)
+         {
+            continue;
+         }
+
+         ArrayOutput output(buffers.push());
+         CmfSaver saver(dict, output);
+
+         saver.saveMolecule(mol);
+         bytes += buffers.top().size();
+      }
+
+      for (i = 0; i < buffers.size(); i++)
+      {
+         ptrs.push((const byte *)buffers[i].ptr());
+         sizes.push(buffers[i].size());
+      }
+
+      printf("%d molecules, %lld bytes of CMF\n", buffers.size(), bytes);
+
+      qword start = nanoClock();
+
+      for (i = 0; i < buffers.size(); i++)
+      {
+         BufferScanner scanner(buffers[i]);
+         LzwDecoder decoder(dict, scanner);
+         CmfLoader loader(decoder);
+
+         loader.loadMolecule(mol);
+         sums[0] = checksum(mol, sums[0]);
+      }
+      report("symbol-wise", start, bytes, sums[0]);
+
+      start = nanoClock();
+      for (i = 0; i < buffers.size(); i++)
+      {
+         BufferScanner scanner(buffers[i]);
+         CmfLoader loader(dict, scanner);
+
+         loader.loadMolecule(mol);
+         sums[1] = checksum(mol, sums[1]);
+      }
+      report("whole buffer", start, bytes, sums[1]);
+
+      // The first call allocates the molecules, the second one reuses them
+      CmfLoader::decodeMany(dict, ptrs, sizes, molecules);
+      start = nanoClock();
+      CmfLoader::decodeMany(dict, ptrs, sizes, molecules);
+      for (i = 0; i < molecules.size(); i++)
+         sums[2] = checksum(molecules[i], sums[2]);
+      report("decodeMany", start, bytes, sums[2]);
+
+      // LZW decoding alone
+      start = nanoClock();
+      for (i = 0; i < buffers.size(); i++)
+      {
+         BufferScanner scanner(buffers[i]);
+         LzwDecoder decoder(dict, scanner);
+
+         while (!decoder.isEOF())
+         {
+            decoder.get();
+            symbols++;
+         }
+      }
+      report("LZW symbol-wise", start, bytes, (dword)symbols);
+
+      Array<byte> decoded;
+
+      symbols = 0;
+      start = nanoClock();
+      for (i = 0; i < buffers.size(); i++)
+      {
+         LzwDecoder::decode(dict, ptrs[i], sizes[i], decoded);
+         symbols += decoded.size();
+      }
+      report("LZW whole buffer", start, bytes, (dword)symbols);
+   }
+   catch (Exception &e)
+   {
+      printf("%s\n", e.message());
+      return -1;
+   }
+
+   return sums[0] == sums[1] && sums[0] == sums[2] ? 0 : 1;
+}
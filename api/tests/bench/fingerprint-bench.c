@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "indigo.h"
+#include "base_c/nano.h"
+#include "bench-items.h"
+
+// Fingerprint building benchmark: molecules from a SDF or SMILES file are
+// loaded into memory and then fingerprinted on a single thread, so only
+// the fingerprint builder is measured. A checksum of the fingerprints is
+// printed to compare the results of different builds.
+
+static const char *types[] = {"sim", "sub", "sub-tau", "full"};
+
+static int loadMolecules (const char *filename)
+{
+   int array = indigoCreateArray();
+   int iter = benchIterateFile(filename), item;
+
+   if (iter == -1)
+      return -1;
+
+   while ((item = indigoNext(iter)) != 0)
+   {
+      if (item == -1)
+         continue;
+      // Tautomer fingerprints need hydrogens of all atoms
+      if (indigoCountImplicitHydrogens(item) != -1)
+         indigoArrayAdd(array, item);
+      indigoFree(item);
+   }
+
+   indigoFree(iter);
+   return array;
+}
+
+int main (int argc, char *argv[])
+{
+   int repeats = 1;
+   int array, count, row_size, i, t;
+   byte *buffer;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <molecules.sdf|molecules.smi> [repeats]\n", argv[0]);
+      return -1;
+   }
+   if (argc > 2)
+      repeats = atoi(argv[2]);
+
+   qword start = nanoClock();
+
+   array = loadMolecules(argv[1]);
+   if (array == -1)
+   {
+      printf("%s\n", indigoGetLastError());
+      return -1;
+   }
+
+   count = indigoCount(array);
+   row_size = indigoFingerprintBatchRowSize();
+   buffer = (byte *)malloc((size_t)count * row_size);
+
+   printf("%d molecules loaded in %.2f sec\n", count, nanoHowManySeconds(nanoClock() - start));
+
+   for (t = 0; t < NELEM(types); t++)
+   {
+      dword checksum = 0;
+      size_t k;
+
+      start = nanoClock();
+      for (i = 0; i < repeats; i++)
+      {
+         if (indigoFingerprintBatch(array, types[t], 1, buffer, count * row_size, NULL) != count)
+         {
+            printf("%s\n", indigoGetLastError());
+            return -1;
+         }
+      }
+
+      float sec = nanoHowManySeconds(nanoClock() - start);
+
+      for (k = 0; k < (size_t)count * row_size; k++)
+         checksum = checksum * 31 + buffer[k];
+
+      printf("%-8s %8.0f molecules/sec, checksum %08x\n", types[t], (double)count * repeats / sec, checksum);
+   }
+
+   free(buffer);
+   return 0;
+}
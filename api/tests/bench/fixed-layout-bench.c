@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "indigo.h"
+#include "base_c/nano.h"
+
+// Serialized molecules benchmark: all molecules of a SDF file are serialized
+// into one buffer, like a cache file, in ICM format and in fixed-layout IFM
+// format. Atom counts and gross formulas are then read from ICM by
+// unserializing every molecule and from IFM in place. Both must be the same,
+// and the molecules unserialized from IFM must have the same canonical
+// SMILES as the original ones.
+
+typedef struct
+{
+   byte *data;
+   long size;
+   long capacity;
+   long *offsets;
+   long count;
+} Cache;
+
+static void cacheAppend (Cache *cache, const byte *buf, int size)
+{
+   if (cache->size + size > cache->capacity)
+   {
+      cache->capacity = (cache->size + size) * 2;
+      cache->data = (byte *)realloc(cache->data, cache->capacity);
+   }
+   if ((cache->count & 1023) == 0)
+      cache->offsets = (long *)realloc(cache->offsets, (cache->count + 1025) * sizeof(long));
+
+   memcpy(cache->data + cache->size, buf, size);
+   cache->offsets[cache->count++] = cache->size;
+   cache->offsets[cache->count] = cache->size += size;
+}
+
+static int fill (const char *filename, Cache *icm, Cache *ifm, long *mismatches)
+{
+   int iter = indigoIterateSDFile(filename), item;
+
+   if (iter == -1)
+      return -1;
+
+   while ((item = indigoNext(iter)) != 0)
+   {
+      byte *buf;
+      int size, mol;
+      char *smiles;
+
+      if (item == -1)
+         return -1;
+
+      indigoSetOptionBool("serialize-fixed-layout", 0);
+      if (indigoSerialize(item, &buf, &size) != 1)
+      {
+         indigoFree(item);
+         continue;
+      }
+      cacheAppend(icm, buf, size);
+
+      indigoSetOptionBool("serialize-fixed-layout", 1);
+      if (indigoSerialize(item, &buf, &size) != 1)
+         return -1;
+      cacheAppend(ifm, buf, size);
+
+      // The serialized buffer is reused by other calls, so the copy is read
+      mol = indigoUnserialize(ifm->data + ifm->offsets[ifm->count - 1], size);
+      if (mol == -1)
+         return -1;
+
+      // Molecules without canonical SMILES are not compared
+      if ((smiles = (char *)indigoCanonicalSmiles(item)) != 0)
+      {
+         const char *result;
+
+         smiles = strdup(smiles);
+         result = indigoCanonicalSmiles(mol);
+         if (result == 0 || strcmp(smiles, result) != 0)
+         {
+            if ((*mismatches)++ < 10)
+               printf("record %ld: %s != %s\n", ifm->count - 1, smiles, result ? result : indigoGetLastError());
+         }
+         free(smiles);
+      }
+      indigoFree(mol);
+      indigoFree(item);
+   }
+
+   indigoFree(iter);
+   return 0;
+}
+
+static dword hashString (dword hash, const char *str)
+{
+   while (*str != 0)
+      hash = hash * 31 + (byte)*str++;
+   return hash;
+}
+
+static int readIcm (Cache *cache, dword *checksum)
+{
+   long i;
+
+   *checksum = 0;
+   for (i = 0; i < cache->count; i++)
+   {
+      int mol = indigoUnserialize(cache->data + cache->offsets[i],
+                                  cache->offsets[i + 1] - cache->offsets[i]);
+      int gross;
+
+      if (mol == -1)
+         return -1;
+
+      *checksum = *checksum * 31 + indigoCountAtoms(mol);
+      gross = indigoGrossFormula(mol);
+      if (gross != -1)
+      {
+         *checksum = hashString(*checksum, indigoToString(gross));
+         indigoFree(gross);
+      }
+      indigoFree(mol);
+   }
+   return 0;
+}
+
+static int readIfm (Cache *cache, dword *checksum)
+{
+   long i;
+
+   *checksum = 0;
+   for (i = 0; i < cache->count; i++)
+   {
+      const byte *buf = cache->data + cache->offsets[i];
+      int size = cache->offsets[i + 1] - cache->offsets[i];
+      const char *formula;
+
+      *checksum = *checksum * 31 + indigoSerializedCountAtoms(buf, size);
+      formula = indigoSerializedGrossFormula(buf, size);
+      if (formula != 0)
+         *checksum = hashString(*checksum, formula);
+   }
+   return 0;
+}
+
+int main (int argc, char *argv[])
+{
+   Cache icm = {0}, ifm = {0};
+   long mismatches = 0;
+   dword checksum[2];
+   qword start;
+   float sec;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <molecules.sdf>\n", argv[0]);
+      return -1;
+   }
+
+   if (fill(argv[1], &icm, &ifm, &mismatches) != 0)
+   {
+      printf("%s\n", indigoGetLastError());
+      return -1;
+   }
+
+   printf("%ld molecules, ICM %ld bytes, IFM %ld bytes\n", icm.count, icm.size, ifm.size);
+
+   start = nanoClock();
+   if (readIcm(&icm, &checksum[0]) != 0)
+   {
+      printf("%s\n", indigoGetLastError());
+      return -1;
+   }
+   sec = nanoHowManySeconds(nanoClock() - start);
+   printf("ICM unserialize: %12.1f records/s, checksum %08x\n", icm.count / sec, checksum[0]);
+
+   start = nanoClock();
+   readIfm(&ifm, &checksum[1]);
+   sec = nanoHowManySeconds(nanoClock() - start);
+   printf("IFM in place:    %12.1f records/s, checksum %08x\n", ifm.count / sec, checksum[1]);
+
+   if (checksum[0] != checksum[1])
+      printf("checksums are different\n");
+   printf("%ld round trip mismatches\n", mismatches);
+   return mismatches == 0 && checksum[0] == checksum[1] ? 0 : 1;
+}
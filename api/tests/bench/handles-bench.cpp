@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+#include "base_c/nano.h"
+#include "base_cpp/os_sync_wrapper.h"
+#include "base_cpp/red_black.h"
+#include "src/indigo_internal.h"
+
+// Contention benchmark for the Indigo object table: every thread creates
+// a batch of handles, looks each of them up several times (as the API
+// calls do) and frees them. The sharded handle table is compared with a
+// map guarded by a single lock.
+
+#define BATCH 256
+#define LOOKUPS 8
+
+class LockedMapTable
+{
+public:
+   LockedMapTable () : _next_id(1001)
+   {
+   }
+
+   int add (IndigoObject *obj)
+   {
+      OsLocker locker(_lock);
+      int id = _next_id++;
+
+      _objects.insert(id, obj);
+      return id;
+   }
+
+   IndigoObject * get (int handle)
+   {
+      OsLocker locker(_lock);
+      IndigoObject **obj = _objects.at2(handle);
+
+      return obj == 0 ? 0 : *obj;
+   }
+
+   IndigoObject * remove (int handle)
+   {
+      OsLocker locker(_lock);
+      IndigoObject **ptr = _objects.at2(handle);
+
+      if (ptr == 0)
+         return 0;
+
+      IndigoObject *obj = *ptr;
+
+      _objects.remove(handle);
+      return obj;
+   }
+
+private:
+   RedBlackMap<int, IndigoObject *> _objects;
+   int _next_id;
+   OsLock _lock;
+};
+
+template <typename Table> static void worker (Table *table, IndigoObject *obj, int rounds, int *errors)
+{
+   int handles[BATCH];
+
+   for (int r = 0; r < rounds; r++)
+   {
+      for (int i = 0; i < BATCH; i++)
+         handles[i] = table->add(obj);
+
+      for (int k = 0; k < LOOKUPS; k++)
+         for (int i = 0; i < BATCH; i++)
+            if (table->get(handles[i]) != obj)
+               (*errors)++;
+
+      for (int i = 0; i < BATCH; i++)
+         if (table->remove(handles[i]) != obj)
+            (*errors)++;
+   }
+}
+
+template <typename Table> static double run (int threads_count, int rounds, int &errors)
+{
+   Table table;
+   IndigoObject obj(IndigoObject::MOLECULE);
+   std::vector<std::thread> threads;
+   std::vector<int> thread_errors(threads_count, 0);
+   qword start = nanoClock();
+
+   for (int t = 0; t < threads_count; t++)
+      threads.push_back(std::thread(worker<Table>, &table, &obj, rounds, &thread_errors[t]));
+   for (int t = 0; t < threads_count; t++)
+      threads[t].join();
+
+   float sec = nanoHowManySeconds(nanoClock() - start);
+
+   for (int t = 0; t < threads_count; t++)
+      errors += thread_errors[t];
+   return (double)threads_count * rounds * BATCH * (LOOKUPS + 2) / sec / 1e6;
+}
+
+int main (int argc, char *argv[])
+{
+   static const int threads_counts[] = {1, 2, 4, 8, 16, 32};
+   int rounds = 400;
+   int errors = 0;
+
+   if (argc > 1)
+      rounds = atoi(argv[1]);
+
+   for (int i = 0; i < NELEM(threads_counts); i++)
+   {
+      double locked = run<LockedMapTable>(threads_counts[i], rounds, errors);
+      double sharded = run<IndigoHandleTable>(threads_counts[i], rounds, errors);
+
+      printf("%2d threads: locked map %8.2f Mops/s, handle table %8.2f Mops/s\n", threads_counts[i], locked, sharded);
+   }
+
+   if (errors != 0)
+   {
+      printf("%d lookups returned wrong objects\n", errors);
+      return -1;
+   }
+   return 0;
+}
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "indigo.h"
+#include "base_c/nano.h"
+
+// File-to-molecule benchmark: all records of a SDF, RDF or SMILES file are
+// read and parsed with different values of "parsing-threads" option. The
+// throughput is printed in records/s, and a checksum of the atom and bond
+// counts must be the same for all thread counts. Gzipped SDF and RDF files
+// are inflated on "gzip-threads" background threads.
+
+static int threads[] = {1, 2, 4, 0};
+
+static int hasExtension (const char *filename, const char *ext)
+{
+   size_t len = strlen(filename), ext_len = strlen(ext);
+
+   // Gzipped files are inflated transparently
+   if (len > 3 && strcmp(filename + len - 3, ".gz") == 0)
+      len -= 3;
+
+   return len > ext_len && strncmp(filename + len - ext_len, ext, ext_len) == 0;
+}
+
+static int iterateFile (const char *filename)
+{
+   if (hasExtension(filename, ".sdf") || hasExtension(filename, ".sd"))
+      return indigoIterateSDFile(filename);
+   if (hasExtension(filename, ".rdf"))
+      return indigoIterateRDFile(filename);
+   return indigoIterateSmilesFile(filename);
+}
+
+static int parseRecords (const char *filename, long *records, long *errors, dword *checksum)
+{
+   int iter = iterateFile(filename), item;
+
+   if (iter == -1)
+      return -1;
+
+   *records = 0;
+   *errors = 0;
+   *checksum = 0;
+
+   while ((item = indigoNext(iter)) != 0)
+   {
+      int atoms, bonds;
+
+      if (item == -1)
+         return -1;
+
+      atoms = indigoCountAtoms(item);
+      bonds = indigoCountBonds(item);
+
+      // Reactions are checked by the number of molecules
+      if (atoms < 0 && indigoCountMolecules(item) >= 0)
+         atoms = bonds = indigoCountMolecules(item);
+
+      if (atoms < 0 || bonds < 0)
+         (*errors)++;
+      else
+         *checksum = (*checksum * 31 + atoms) * 31 + bonds;
+      (*records)++;
+      indigoFree(item);
+   }
+
+   indigoFree(iter);
+   return 0;
+}
+
+int main (int argc, char *argv[])
+{
+   long records, errors;
+   dword checksum;
+   int i;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <molecules.sdf[.gz]|reactions.rdf[.gz]|molecules.smi>\n", argv[0]);
+      return -1;
+   }
+
+   for (i = 0; i < NELEM(threads); i++)
+   {
+      qword start = nanoClock();
+
+      indigoSetOptionInt("parsing-threads", threads[i]);
+      if (parseRecords(argv[1], &records, &errors, &checksum) != 0)
+      {
+         printf("%s\n", indigoGetLastError());
+         return -1;
+      }
+
+      float sec = nanoHowManySeconds(nanoClock() - start);
+
+      printf("threads %d: %10.1f records/s, %ld records, %ld errors, checksum %08x\n",
+             threads[i], records / sec, records, errors, checksum);
+   }
+   return 0;
+}
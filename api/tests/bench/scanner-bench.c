@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "indigo.h"
+#include "base_c/nano.h"
+#include "bench-items.h"
+
+// File reading benchmark: all records of a SDF or SMILES file are read
+// without parsing the molecules, with the file mapped into memory and with
+// the buffered reading for several read-ahead sizes. The throughput is
+// printed in MB/s, and a checksum of the records must be the same for all
+// modes.
+
+static int read_ahead[] = {1024, 65536, 1 << 20};
+
+static int readRecords (const char *filename, long *records, long long *bytes, dword *checksum)
+{
+   int iter = benchIterateFile(filename), item;
+
+   if (iter == -1)
+      return -1;
+
+   *records = 0;
+   *bytes = 0;
+   *checksum = 0;
+
+   while ((item = indigoNext(iter)) != 0)
+   {
+      const char *data;
+
+      if (item == -1)
+         return -1;
+
+      data = indigoRawData(item);
+      if (data == NULL)
+         return -1;
+
+      for (; *data != 0; data++)
+         *checksum = *checksum * 31 + (byte)*data;
+      (*records)++;
+      indigoFree(item);
+   }
+
+   *bytes = indigoTell64(iter);
+   indigoFree(iter);
+   return 0;
+}
+
+static int run (const char *filename, const char *mode, int repeats)
+{
+   long records = 0;
+   long long bytes = 0;
+   dword checksum = 0;
+   int i;
+
+   qword start = nanoClock();
+
+   for (i = 0; i < repeats; i++)
+   {
+      if (readRecords(filename, &records, &bytes, &checksum) != 0)
+      {
+         printf("%s\n", indigoGetLastError());
+         return -1;
+      }
+   }
+
+   float sec = nanoHowManySeconds(nanoClock() - start);
+
+   printf("%-18s %8.1f MB/s, %ld records, checksum %08x\n", mode,
+          (double)bytes * repeats / sec / (1 << 20), records, checksum);
+   return 0;
+}
+
+int main (int argc, char *argv[])
+{
+   int repeats = 1;
+   char mode[32];
+   int i;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <molecules.sdf|molecules.smi> [repeats]\n", argv[0]);
+      return -1;
+   }
+   if (argc > 2)
+      repeats = atoi(argv[2]);
+
+   indigoSetOptionBool("file-memory-mapping", 1);
+   if (run(argv[1], "mapped", repeats) != 0)
+      return -1;
+
+   indigoSetOptionBool("file-memory-mapping", 0);
+   for (i = 0; i < NELEM(read_ahead); i++)
+   {
+      indigoSetOptionInt("file-read-ahead", read_ahead[i]);
+      snprintf(mode, sizeof(mode), "read-ahead %d", read_ahead[i]);
+      if (run(argv[1], mode, repeats) != 0)
+         return -1;
+   }
+   return 0;
+}
@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base_c/bitarray.h"
+#include "base_c/nano.h"
+
+// Micro-benchmark for the bit-sliced substructure screening: rows of the
+// transposed fingerprint storage are ANDed into the fit mask and the
+// remaining candidates are extracted. Byte-wise screening is compared
+// with the word kernels.
+
+#define BLOCK_SIZE 8192
+#define ROWS 15
+#define LINE_SIZE 64
+
+static const char *kernels[] = {"scalar", "popcnt", "avx2", "avx512"};
+
+static int screenBytes (byte rows[][BLOCK_SIZE], int rows_count, byte *fit_bits, int *candidates)
+{
+   int left = 0, right = BLOCK_SIZE - 1;
+   int i, k, count = 0;
+
+   memset(fit_bits, 255, BLOCK_SIZE);
+
+   for (i = 0; i < rows_count; i++)
+   {
+      for (k = left; k <= right; k++)
+         fit_bits[k] &= rows[i][k];
+
+      while (left <= right && fit_bits[left] == 0)
+         left++;
+      while (left <= right && fit_bits[right] == 0)
+         right--;
+
+      if (left > right)
+         break;
+   }
+
+   for (k = 0; k < 8 * BLOCK_SIZE; k++)
+      if (bitGetBit(fit_bits, k))
+         candidates[count++] = k;
+
+   return count;
+}
+
+static int screenWords (byte rows[][BLOCK_SIZE], int rows_count, byte *fit_bits, int *candidates)
+{
+   int left = 0, right = BLOCK_SIZE;
+   int fit_count = BLOCK_SIZE * 8;
+   int i, last_line;
+
+   memset(fit_bits, 255, BLOCK_SIZE);
+
+   for (i = 0; i < rows_count; i++)
+   {
+      fit_count = bitAndOnes(fit_bits + left, rows[i] + left, right - left);
+      if (fit_count == 0)
+         return 0;
+
+      while (bitIsAllZero(fit_bits + left, LINE_SIZE))
+         left += LINE_SIZE;
+      last_line = right - LINE_SIZE;
+      while (bitIsAllZero(fit_bits + last_line, LINE_SIZE))
+      {
+         right = last_line;
+         last_line -= LINE_SIZE;
+      }
+   }
+
+   return bitGetOnesIndices(fit_bits + left, right - left, left * 8, candidates);
+}
+
+static void fillRows (byte rows[][BLOCK_SIZE], int density_percent)
+{
+   int i, k;
+
+   for (i = 0; i < ROWS; i++)
+      for (k = 0; k < BLOCK_SIZE * 8; k++)
+         bitSetBit(rows[i], k, rand() % 100 < density_percent);
+}
+
+int main (int argc, char *argv[])
+{
+   static const int densities[] = {10, 50, 80, 95};
+   static byte rows[ROWS][BLOCK_SIZE];
+   byte *fit_bits = (byte *)malloc(BLOCK_SIZE);
+   int *candidates = (int *)malloc(BLOCK_SIZE * 8 * sizeof(int));
+   int *reference = (int *)malloc(BLOCK_SIZE * 8 * sizeof(int));
+   int repeats = 200;
+   int d, k, i;
+
+   if (argc > 1)
+      repeats = atoi(argv[1]);
+
+   printf("Default kernel: %s\n", bitGetKernelName());
+
+   for (d = 0; d < NELEM(densities); d++)
+   {
+      int ref_count = 0;
+      qword start;
+      float sec;
+
+      srand(densities[d]);
+      fillRows(rows, densities[d]);
+
+      start = nanoClock();
+      for (i = 0; i < repeats; i++)
+         ref_count = screenBytes(rows, ROWS, fit_bits, reference);
+      sec = nanoHowManySeconds(nanoClock() - start);
+
+      printf("density %2d%%, %5d candidates: bytes    %8.1f Mrows/s\n", densities[d], ref_count,
+         (double)BLOCK_SIZE * 8 * repeats / sec / 1e6);
+
+      for (k = 0; k < NELEM(kernels); k++)
+      {
+         int count = 0;
+
+         if (!bitSetKernel(kernels[k]))
+            continue;
+
+         start = nanoClock();
+         for (i = 0; i < repeats; i++)
+            count = screenWords(rows, ROWS, fit_bits, candidates);
+         sec = nanoHowManySeconds(nanoClock() - start);
+
+         if (count != ref_count || memcmp(candidates, reference, count * sizeof(int)) != 0)
+         {
+            printf("%s screening results differ from the byte-wise ones\n", kernels[k]);
+            return -1;
+         }
+
+         printf("density %2d%%, %5d candidates: %-8s %8.1f Mrows/s\n", densities[d], count, kernels[k],
+            (double)BLOCK_SIZE * 8 * repeats / sec / 1e6);
+      }
+   }
+
+   free(fit_bits);
+   free(candidates);
+   free(reference);
+   return 0;
+}
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "indigo.h"
+#include "base_c/nano.h"
+
+// Molecule-to-SDF benchmark: all molecules of a SDF file are loaded into
+// memory and saved into a SDF file in V2000 and V3000 formats. The records
+// are written with indigoMolfile() strings, and with the SDF file saver
+// with different values of "saving-threads" option. The throughput is
+// printed in records/s, and a checksum of the output file must be the same
+// for all the ways of saving.
+
+static int threads[] = {1, 2, 4, 0};
+static const char *modes[] = {"2000", "3000"};
+
+static dword fileChecksum (const char *filename)
+{
+   FILE *f = fopen(filename, "rb");
+   dword checksum = 0;
+   int c;
+
+   if (f == NULL)
+      return 0;
+
+   while ((c = fgetc(f)) != EOF)
+      checksum = checksum * 31 + c;
+
+   fclose(f);
+   return checksum;
+}
+
+static int saveStrings (int *items, int count, const char *filename)
+{
+   FILE *f = fopen(filename, "wb");
+   int i;
+
+   if (f == NULL)
+      return -1;
+
+   for (i = 0; i < count; i++)
+   {
+      const char *molfile = indigoMolfile(items[i]);
+      int prop, props;
+
+      if (molfile == NULL)
+         continue;
+      fputs(molfile, f);
+
+      props = indigoIterateProperties(items[i]);
+      while ((prop = indigoNext(props)) > 0)
+      {
+         fprintf(f, ">  <%s>\n", indigoName(prop));
+         fprintf(f, "%s\n\n", indigoGetProperty(items[i], indigoName(prop)));
+         indigoFree(prop);
+      }
+      indigoFree(props);
+      fputs("$$$$\n", f);
+   }
+
+   fclose(f);
+   return 0;
+}
+
+static int saveRecords (int *items, int count, const char *filename)
+{
+   int saver = indigoCreateFileSaver(filename, "sdf");
+   int i;
+
+   if (saver == -1)
+      return -1;
+
+   for (i = 0; i < count; i++)
+      if (indigoAppend(saver, items[i]) == -1)
+         return -1;
+
+   if (indigoClose(saver) == -1)
+      return -1;
+   indigoFree(saver);
+   return 0;
+}
+
+int main (int argc, char *argv[])
+{
+   const char *output = argc > 2 ? argv[2] : "sdf-saver-bench.sdf";
+   int *items = NULL;
+   int count = 0, capacity = 0, iter, item, i, m;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <molecules.sdf> [output.sdf]\n", argv[0]);
+      return -1;
+   }
+
+   indigoSetOption("ignore-stereochemistry-errors", "true");
+   indigoSetOption("molfile-saving-skip-date", "true");
+   // Implicit hydrogens are added to the saved molecule as data S-groups,
+   // so the molecules would change after each saving
+   indigoSetOption("molfile-saving-add-implicit-h", "false");
+
+   iter = indigoIterateSDFile(argv[1]);
+   if (iter == -1)
+   {
+      printf("%s\n", indigoGetLastError());
+      return -1;
+   }
+
+   while ((item = indigoNext(iter)) != 0)
+   {
+      if (item == -1)
+         break;
+
+      // Records that can't be parsed are not saved
+      if (indigoCountAtoms(item) < 0)
+      {
+         indigoFree(item);
+         continue;
+      }
+
+      if (count == capacity)
+      {
+         capacity = capacity * 2 + 1024;
+         items = (int *)realloc(items, capacity * sizeof(int));
+      }
+      items[count++] = item;
+   }
+
+   for (m = 0; m < NELEM(modes); m++)
+   {
+      qword start = nanoClock();
+      float sec;
+
+      indigoSetOption("molfile-saving-mode", modes[m]);
+
+      if (saveStrings(items, count, output) != 0)
+      {
+         printf("%s\n", indigoGetLastError());
+         return -1;
+      }
+
+      sec = nanoHowManySeconds(nanoClock() - start);
+      printf("V%s strings:   %10.1f records/s, %d records, checksum %08x\n",
+             modes[m], count / sec, count, fileChecksum(output));
+
+      for (i = 0; i < NELEM(threads); i++)
+      {
+         start = nanoClock();
+
+         indigoSetOptionInt("saving-threads", threads[i]);
+         if (saveRecords(items, count, output) != 0)
+         {
+            printf("%s\n", indigoGetLastError());
+            return -1;
+         }
+
+         sec = nanoHowManySeconds(nanoClock() - start);
+         printf("V%s threads %d: %10.1f records/s, %d records, checksum %08x\n",
+                modes[m], threads[i], count / sec, count, fileChecksum(output));
+      }
+   }
+
+   remove(output);
+   return 0;
+}
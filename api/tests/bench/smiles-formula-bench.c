@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "indigo.h"
+#include "base_c/nano.h"
+
+// SMILES screening benchmark: gross formula and heavy atom count are
+// calculated for all the molecules of a SMILES file. The fast path parses
+// plain SMILES without building the full molecule. The full path is forced
+// by counting the atoms first, which loads the molecule. The results of both
+// paths must be the same for every record.
+
+static int calculate (const char *filename, int full, char ***formulas, int **heavy, long *records)
+{
+   int iter = indigoIterateSmilesFile(filename), item;
+   long capacity = 0;
+
+   if (iter == -1)
+      return -1;
+
+   *records = 0;
+
+   while ((item = indigoNext(iter)) != 0)
+   {
+      int gross;
+      const char *formula = "";
+      int count = -1;
+
+      if (item == -1)
+         return -1;
+
+      if (full)
+         indigoCountAtoms(item);
+
+      gross = indigoGrossFormula(item);
+      if (gross != -1)
+      {
+         formula = indigoToString(gross);
+         indigoFree(gross);
+      }
+      count = indigoCountHeavyAtoms(item);
+
+      if (*records == capacity)
+      {
+         capacity = capacity * 2 + 1024;
+         *formulas = (char **)realloc(*formulas, capacity * sizeof(char *));
+         *heavy = (int *)realloc(*heavy, capacity * sizeof(int));
+      }
+      (*formulas)[*records] = strdup(formula);
+      (*heavy)[*records] = count;
+      (*records)++;
+      indigoFree(item);
+   }
+
+   indigoFree(iter);
+   return 0;
+}
+
+int main (int argc, char *argv[])
+{
+   char **formulas[2] = {0, 0};
+   int *heavy[2] = {0, 0};
+   long records[2], i, mismatches = 0;
+   int full;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <molecules.smi>\n", argv[0]);
+      return -1;
+   }
+
+   for (full = 0; full < 2; full++)
+   {
+      qword start = nanoClock();
+
+      if (calculate(argv[1], full, &formulas[full], &heavy[full], &records[full]) != 0)
+      {
+         printf("%s\n", indigoGetLastError());
+         return -1;
+      }
+
+      float sec = nanoHowManySeconds(nanoClock() - start);
+
+      printf("%s path: %10.1f records/s, %ld records\n",
+             full ? "full" : "fast", records[full] / sec, records[full]);
+   }
+
+   if (records[0] != records[1])
+   {
+      printf("different number of records\n");
+      return -1;
+   }
+
+   for (i = 0; i < records[0]; i++)
+      if (strcmp(formulas[0][i], formulas[1][i]) != 0 || heavy[0][i] != heavy[1][i])
+      {
+         if (mismatches++ < 10)
+            printf("record %ld: %s (%d) != %s (%d)\n", i,
+                   formulas[0][i], heavy[0][i], formulas[1][i], heavy[1][i]);
+      }
+
+   printf("%ld mismatches\n", mismatches);
+   return mismatches == 0 ? 0 : 1;
+}
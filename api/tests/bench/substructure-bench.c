@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "indigo.h"
+#include "base_c/nano.h"
+#include "bench-items.h"
+
+// Substructure matching benchmark on hard queries: every query is matched
+// against every target with and without the candidate sets of the
+// embedding enumerator ("substructure-candidate-sets" option). The number
+// of matches and embeddings must be the same in both modes.
+
+static const char *default_targets[] = {
+   // Peptides
+   "CC(C)CC(NC(=O)C(CC1=CC=CC=C1)NC(=O)C(CO)NC(=O)C(CC(N)=O)NC(=O)C(C)NC(=O)C(CCCNC(N)=N)NC(=O)C(CC(C)C)NC(=O)C(N)CC1=CC=C(O)C=C1)C(=O)NC(CCSC)C(=O)NC(CC(O)=O)C(=O)NC(C(C)O)C(=O)NC(CCC(N)=O)C(=O)NC(CC1=CNC=N1)C(O)=O",
+   "NCCCCC(NC(=O)C(CC1=CNC2=CC=CC=C12)NC(=O)C(CCC(O)=O)NC(=O)C1CCCN1C(=O)C(CS)NC(=O)C(CC(C)C)NC(=O)CN)C(=O)NC(C(C)CC)C(=O)NC(CC1=CC=CC=C1)C(=O)NC(CCCCN)C(=O)NC(CO)C(=O)NC(CC(O)=O)C(=O)NC(CC(C)C)C(O)=O",
+   // Natural products
+   "CC1C(O)C(C)C(=O)C(C)C(O)C(C)C(=O)OC(CC)C(C)(O)C(OC2CC(C)(OC)C(O)C(C)O2)C(C)C(=O)C(C)CC1(C)O",
+   "CC1=C2C(C(=O)C3(C)C(CC4OCC4(OC(C)=O)C3C(OC(=O)C3=CC=CC=C3)C(O)(CC1OC(=O)C(O)C(NC(=O)C1=CC=CC=C1)C1=CC=CC=C1)C2(C)C)O)OC(C)=O",
+   "OCC1OC(OC2C(CO)OC(OC3C(CO)OC(OC4C(CO)OC(O)C(O)C4O)C(O)C3O)C(O)C2O)C(O)C(O)C1O",
+   // Lipids
+   "CCCCCCCCCCCCCCCCCC(=O)OCC(COP(=O)(O)OCC(O)COP(=O)(O)OCC(COC(=O)CCCCCCCCCCCCCCCCC)OC(=O)CCCCCCCCCCCCCCCCC)OC(=O)CCCCCCCCCCCCCCCCC",
+   "CC(C)CCCC(C)CCCC(C)CCCC(C)CCCC(C)CCCC(C)CCCC(C)CCCC(C)CCCC(C)CCCC(C)CCCC(C)C",
+   0
+};
+
+static const char *default_queries[] = {
+   "C(=O)NC(C)C(=O)NC(C)C(=O)NC(C)C(=O)N",
+   "[#6]~[#6]~[#6]~[#6]~[#6]~[#6]~[#6]~[#6]~[#6]~[#6]",
+   "OC1CCCCO1",
+   "C1CCCCC1CC1CCCCC1",
+   "[#6]-,:[#6]-,:[#6]-,:[#6]-,:[#6]-,:[#6]-,:[#6]-,:[#6]-,:[#8]",
+   "NC(CS)C(=O)NC(C)C(O)=O",
+   "[#8]~[#6]~[#6](~[#8])~[#6](~[#8])~[#6]~[#8]",
+   "CCCCCCCCCCCCN",
+   "CCCCCCCCCC(C)(C)C",
+   "C1CCCCCCC1",
+   "OC(=O)CCCCCCCCCCS",
+   0
+};
+
+static int run (int targets, int queries, int candidate_sets, int repeats, long *matches, long *embeddings)
+{
+   int nt = indigoCount(targets), nq = indigoCount(queries);
+   int t, q, r;
+
+   indigoSetOptionBool("substructure-candidate-sets", candidate_sets);
+   *matches = 0;
+   *embeddings = 0;
+
+   for (t = 0; t < nt; t++)
+   {
+      int target = indigoAt(targets, t);
+      int matcher = indigoSubstructureMatcher(target, "");
+
+      for (q = 0; q < nq; q++)
+      {
+         int query = indigoAt(queries, q);
+
+         for (r = 0; r < repeats; r++)
+         {
+            int match = indigoMatch(matcher, query);
+            int count;
+
+            if (match == -1)
+               return -1;
+            if (match != 0)
+            {
+               (*matches)++;
+               indigoFree(match);
+            }
+
+            count = indigoCountMatchesWithLimit(matcher, query, 1000);
+            if (count == -1)
+               return -1;
+            *embeddings += count;
+         }
+         indigoFree(query);
+      }
+      indigoFree(matcher);
+      indigoFree(target);
+   }
+   return 0;
+}
+
+int main (int argc, char *argv[])
+{
+   int repeats = 1;
+   int targets, queries, mode;
+   long matches[2], embeddings[2];
+
+   if (argc > 1 && strcmp(argv[1], "-h") == 0)
+   {
+      printf("Usage: %s [targets.sdf|targets.smi|-] [queries.sma|-] [repeats]\n", argv[0]);
+      return 0;
+   }
+   if (argc > 3)
+      repeats = atoi(argv[3]);
+
+   targets = benchLoadItems(argc > 1 ? argv[1] : NULL, default_targets, 0);
+   queries = benchLoadItems(argc > 2 ? argv[2] : NULL, default_queries, 1);
+   if (targets == -1 || queries == -1)
+   {
+      printf("%s\n", indigoGetLastError());
+      return -1;
+   }
+
+   printf("%d targets, %d queries\n", indigoCount(targets), indigoCount(queries));
+
+   for (mode = 0; mode < 2; mode++)
+   {
+      qword start = nanoClock();
+
+      if (run(targets, queries, mode, repeats, &matches[mode], &embeddings[mode]) != 0)
+      {
+         printf("%s\n", indigoGetLastError());
+         return -1;
+      }
+
+      float sec = nanoHowManySeconds(nanoClock() - start);
+
+      printf("%-15s %8.3f sec, %ld matches, %ld embeddings\n",
+             mode ? "candidate sets" : "plain", sec, matches[mode], embeddings[mode]);
+   }
+
+   if (matches[0] != matches[1] || embeddings[0] != embeddings[1])
+   {
+      printf("results differ\n");
+      return -1;
+   }
+   return 0;
+}
@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "indigo.h"
+
+// Records of SDF, RDF, SMILES and CML files are iterated with the file
+// mapped into memory, with small read-ahead buffers and with parsing on
+// worker threads. All modes must return the same number of records and
+// the same indigoTell64() offsets after each record.
+
+#define RECORDS 300
+#define MAX_RECORDS 1000
+
+static const char *molecules[] = {
+   "CCO", "c1ccccc1", "CC(=O)Oc1ccccc1C(O)=O", "N[C@@H](C)C(O)=O",
+   "C1CCC2CCCCC2C1", "O=C(O)c1ccncc1", "CN1C=NC2=C1C(=O)N(C)C(=O)N2C"
+};
+
+static const char *reactions[] = {
+   "CCO>>CC=O", "C=C.BrBr>>BrCCBr", "c1ccccc1.ClCl>>Clc1ccccc1.Cl"
+};
+
+typedef struct
+{
+   const char *name;
+   const char *extension;
+   int reactions;
+   int (*iterate) (const char *filename);
+} Format;
+
+static Format formats[] = {
+   {"sdf", "sdf", 0, indigoIterateSDFile},
+   {"rdf", "rdf", 1, indigoIterateRDFile},
+   {"smiles", "smi", 0, indigoIterateSmilesFile},
+   {"cml", "cml", 0, indigoIterateCMLFile}
+};
+
+typedef struct
+{
+   const char *name;
+   int memory_mapping;
+   int read_ahead;
+   int parsing_threads;
+} Mode;
+
+static Mode modes[] = {
+   {"mapped", 1, 1 << 20, 1},
+   {"read-ahead 64", 0, 64, 1},
+   {"read-ahead 1000", 0, 1000, 1},
+   {"mapped, parsing threads", 1, 1 << 20, 4},
+   {"read-ahead 64, parsing threads", 0, 64, 4},
+};
+
+void onError (const char *message, void *context)
+{
+   fprintf(stderr, "Error: %s\n", message);
+   exit(-1);
+}
+
+static void writeFile (const Format *format, const char *filename)
+{
+   int saver = indigoCreateFileSaver(filename, format->name);
+   int i;
+
+   for (i = 0; i < RECORDS; i++)
+   {
+      int item;
+
+      if (format->reactions)
+         item = indigoLoadReactionFromString(reactions[i % (sizeof(reactions) / sizeof(reactions[0]))]);
+      else
+         item = indigoLoadMoleculeFromString(molecules[i % (sizeof(molecules) / sizeof(molecules[0]))]);
+
+      indigoAppend(saver, item);
+      indigoFree(item);
+   }
+
+   indigoClose(saver);
+   indigoFree(saver);
+}
+
+static int readFile (const Format *format, const char *filename, long long *offsets)
+{
+   int iter = format->iterate(filename), item;
+   int count = 0;
+
+   while ((item = indigoNext(iter)) != 0)
+   {
+      if (count >= MAX_RECORDS)
+      {
+         printf("%s: too many records\n", format->name);
+         exit(-1);
+      }
+
+      // Access the record so it is parsed in all modes
+      if (format->reactions)
+         indigoCountMolecules(item);
+      else
+         indigoCountAtoms(item);
+
+      offsets[count++] = indigoTell64(iter);
+      indigoFree(item);
+   }
+
+   indigoFree(iter);
+   return count;
+}
+
+int main (void)
+{
+   static long long expected[MAX_RECORDS], offsets[MAX_RECORDS];
+   int failed = 0;
+   int f, m, i;
+
+   indigoSetErrorHandler(onError, 0);
+
+   for (f = 0; f < sizeof(formats) / sizeof(formats[0]); f++)
+   {
+      const Format *format = &formats[f];
+      char filename[64];
+      int format_failed = 0;
+
+      snprintf(filename, sizeof(filename), "read-ahead-test.%s", format->extension);
+      writeFile(format, filename);
+
+      for (m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+      {
+         const Mode *mode = &modes[m];
+         int count;
+
+         indigoSetOptionBool("file-memory-mapping", mode->memory_mapping);
+         indigoSetOptionInt("file-read-ahead", mode->read_ahead);
+         indigoSetOptionInt("parsing-threads", mode->parsing_threads);
+
+         count = readFile(format, filename, m == 0 ? expected : offsets);
+
+         if (count != RECORDS)
+         {
+            printf("%s, %s: %d records instead of %d\n", format->name, mode->name, count, RECORDS);
+            format_failed = 1;
+            continue;
+         }
+
+         if (m == 0)
+         {
+            for (i = 1; i < count; i++)
+               if (expected[i] <= expected[i - 1])
+               {
+                  printf("%s, %s: offset %lld after record %d is not increasing\n",
+                         format->name, mode->name, expected[i], i);
+                  format_failed = 1;
+                  break;
+               }
+            continue;
+         }
+
+         for (i = 0; i < count; i++)
+            if (offsets[i] != expected[i])
+            {
+               printf("%s, %s: offset %lld after record %d instead of %lld\n",
+                      format->name, mode->name, offsets[i], i, expected[i]);
+               format_failed = 1;
+               break;
+            }
+      }
+
+      remove(filename);
+      printf("%s: %s\n", format->name, format_failed ? "FAILED" : "OK");
+      if (format_failed)
+         failed = 1;
+   }
+
+   return failed ? -1 : 0;
+}
@@ -3,8 +3,39 @@
 
 #include "postgres.h"
 #include "fmgr.h"
+#include "access/genam.h"
+#include "access/xact.h"
 #include "nodes/relation.h"
+#include "nodes/nodeFuncs.h"
 #include "optimizer/cost.h"
+#include "utils/datum.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/selfuncs.h"
+
+/*
+ * Number of index sections screened to estimate a query selectivity
+ */
+#define BINGO_SAMPLE_SECTIONS 4
+/*
+ * Selectivity of a query without estimation, the same as contsel()
+ */
+#define BINGO_DEFAULT_SELECTIVITY 0.001
+/*
+ * Cost of matching a structure passed the screening in cpu_operator_cost units,
+ * the same as the default cost of a function
+ */
+#define BINGO_MATCH_COST 100.0
+/*
+ * Number of estimations kept for the statement being planned
+ */
+#define BINGO_ESTIMATE_CACHE_SIZE 8
+
+/*
+ * Implemented in pg_bingo_search.cpp
+ */
+extern double bingo_estimate_selectivity(Relation index, int strategy, Datum query, int sample_sections, double* pages);
 
 /*
 #include "catalog/index.h"
@@ -568,6 +599,252 @@ genericcostestimate92(PlannerInfo *root,
 }
 #endif
 
+/*
+ * The planner estimates a qual both in bingo_sel and in bingo_costestimate,
+ * so the estimations of the current statement are kept by the index, the
+ * operator and the query constant
+ */
+typedef struct BingoEstimateCacheEntry
+{
+	Oid			indexoid;
+	Oid			opno;
+	Datum		query;
+	bool		query_byval;
+	int			query_len;
+	double		selectivity;
+	double		pages;
+} BingoEstimateCacheEntry;
+
+static BingoEstimateCacheEntry bingo_estimate_cache[BINGO_ESTIMATE_CACHE_SIZE];
+static int	bingo_estimate_cache_size = 0;
+static int	bingo_estimate_cache_next = 0;
+static TimestampTz bingo_estimate_cache_statement = 0;
+
+static void
+bingo_estimate_cache_free_entry(BingoEstimateCacheEntry *entry)
+{
+	if (!entry->query_byval)
+		pfree(DatumGetPointer(entry->query));
+}
+
+static BingoEstimateCacheEntry *
+bingo_estimate_cache_lookup(Oid indexoid, Oid opno, Const *query)
+{
+	int			i;
+
+	/*
+	 * The index could be changed since the previous statement
+	 */
+	if (bingo_estimate_cache_statement != GetCurrentStatementStartTimestamp())
+	{
+		for (i = 0; i < bingo_estimate_cache_size; i++)
+			bingo_estimate_cache_free_entry(&bingo_estimate_cache[i]);
+		bingo_estimate_cache_size = 0;
+		bingo_estimate_cache_next = 0;
+		bingo_estimate_cache_statement = GetCurrentStatementStartTimestamp();
+		return NULL;
+	}
+
+	for (i = 0; i < bingo_estimate_cache_size; i++)
+	{
+		BingoEstimateCacheEntry *entry = &bingo_estimate_cache[i];
+
+		if (entry->indexoid == indexoid && entry->opno == opno &&
+			entry->query_byval == query->constbyval && entry->query_len == query->constlen &&
+			datumIsEqual(entry->query, query->constvalue, query->constbyval, query->constlen))
+			return entry;
+	}
+	return NULL;
+}
+
+static void
+bingo_estimate_cache_add(Oid indexoid, Oid opno, Const *query, double selectivity, double pages)
+{
+	BingoEstimateCacheEntry *entry = &bingo_estimate_cache[bingo_estimate_cache_next];
+	MemoryContext old_context;
+
+	/*
+	 * The oldest estimation is replaced if the cache is full
+	 */
+	if (bingo_estimate_cache_size < BINGO_ESTIMATE_CACHE_SIZE)
+		bingo_estimate_cache_size++;
+	else
+		bingo_estimate_cache_free_entry(entry);
+	bingo_estimate_cache_next = (bingo_estimate_cache_next + 1) % BINGO_ESTIMATE_CACHE_SIZE;
+
+	old_context = MemoryContextSwitchTo(TopMemoryContext);
+	entry->query = datumCopy(query->constvalue, query->constbyval, query->constlen);
+	MemoryContextSwitchTo(old_context);
+
+	entry->indexoid = indexoid;
+	entry->opno = opno;
+	entry->query_byval = query->constbyval;
+	entry->query_len = query->constlen;
+	entry->selectivity = selectivity;
+	entry->pages = pages;
+}
+
+/*
+ * Estimates the selectivity of the bingo operator with a constant query by
+ * screening a sample of the index sections. Returns -1 if the operator does
+ * not belong to the index or can not be estimated
+ */
+static double
+bingo_index_selectivity(IndexOptInfo *index, Oid opno, Const *query, double *pages)
+{
+	int			strategy;
+	Relation	index_rel;
+	double		result;
+	BingoEstimateCacheEntry *entry;
+
+	*pages = 0;
+	strategy = get_op_opfamily_strategy(opno, index->opfamily[0]);
+	if (strategy == 0)
+		return -1;
+
+	entry = bingo_estimate_cache_lookup(index->indexoid, opno, query);
+	if (entry != NULL)
+	{
+		*pages = entry->pages;
+		return entry->selectivity;
+	}
+
+	index_rel = index_open(index->indexoid, AccessShareLock);
+	result = bingo_estimate_selectivity(index_rel, strategy, query->constvalue, BINGO_SAMPLE_SECTIONS, pages);
+	index_close(index_rel, AccessShareLock);
+
+	bingo_estimate_cache_add(index->indexoid, opno, query, result, *pages);
+
+	return result;
+}
+
+/*
+ * Restriction selectivity of the bingo operators. A bingo index on the column
+ * is used for sampling the fingerprints of the indexed structures
+ */
+#if PG_VERSION_NUM / 100 == 904
+	PGDLLEXPORT PG_FUNCTION_INFO_V1(bingo_sel);
+#else
+	PG_FUNCTION_INFO_V1(bingo_sel);
+	PGDLLEXPORT Datum bingo_sel(PG_FUNCTION_ARGS);
+#endif
+
+Datum
+bingo_sel(PG_FUNCTION_ARGS)
+{
+	PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+	Oid			operator = PG_GETARG_OID(1);
+	List	   *args = (List *) PG_GETARG_POINTER(2);
+	int			varRelid = PG_GETARG_INT32(3);
+	VariableStatData vardata;
+	Node	   *other;
+	bool		varonleft;
+	double		selec = -1;
+	double		pages;
+	ListCell   *lc;
+
+	if (!get_restriction_variable(root, args, varRelid,
+								  &vardata, &other, &varonleft))
+		PG_RETURN_FLOAT8(BINGO_DEFAULT_SELECTIVITY);
+
+	if (vardata.rel != NULL && vardata.var != NULL && IsA(vardata.var, Var) &&
+		IsA(other, Const) && !((Const *) other)->constisnull)
+	{
+		AttrNumber	attno = ((Var *) vardata.var)->varattno;
+
+		foreach(lc, vardata.rel->indexlist)
+		{
+			IndexOptInfo *index = (IndexOptInfo *) lfirst(lc);
+
+			if (index->ncolumns < 1 || index->indexkeys[0] != attno)
+				continue;
+
+			selec = bingo_index_selectivity(index, operator, (Const *) other, &pages);
+			if (selec >= 0)
+				break;
+		}
+	}
+
+	ReleaseVariableStats(vardata);
+
+	if (selec < 0)
+		selec = BINGO_DEFAULT_SELECTIVITY;
+	CLAMP_PROBABILITY(selec);
+
+	PG_RETURN_FLOAT8((float8) selec);
+}
+
+#if PG_VERSION_NUM / 100 >= 902
+/*
+ * Replaces the generic estimation with the sampled screening of the index
+ * for the quals with constant queries. Returns false if there are no such quals
+ */
+static bool
+bingo_sampled_costestimate(IndexPath *path,
+					Cost *indexTotalCost,
+					Selectivity *indexSelectivity)
+{
+	IndexOptInfo *index = path->indexinfo;
+	double		selec = 1.0;
+	double		pages = 0;
+	double		numIndexTuples;
+	bool		estimated = false;
+	ListCell   *l;
+
+	foreach(l, path->indexquals)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(l);
+		OpExpr	   *clause = (OpExpr *) rinfo->clause;
+		Node	   *query;
+		double		qual_selec, qual_pages;
+
+		if (!IsA(clause, OpExpr) || list_length(clause->args) != 2)
+			continue;
+
+		query = (Node *) lsecond(clause->args);
+		if (!IsA(query, Const) || ((Const *) query)->constisnull)
+			continue;
+
+		qual_selec = bingo_index_selectivity(index, clause->opno, (Const *) query, &qual_pages);
+		if (qual_selec < 0)
+			continue;
+
+		/*
+		 * The scan screens by the first query only, the rest are matched
+		 * for the structures passed
+		 */
+		if (!estimated)
+			pages = qual_pages;
+		selec *= qual_selec;
+		estimated = true;
+	}
+
+	if (!estimated)
+		return false;
+
+	/*
+	 * At least one structure is expected
+	 */
+	if (index->rel->tuples > 0 && selec < 1.0 / index->rel->tuples)
+		selec = 1.0 / index->rel->tuples;
+	CLAMP_PROBABILITY(selec);
+
+	numIndexTuples = selec * index->tuples;
+	if (numIndexTuples < 1.0)
+		numIndexTuples = 1.0;
+
+	*indexSelectivity = selec;
+	/*
+	 * Screening reads the fingerprint blocks of every section, and every
+	 * structure passed is matched
+	 */
+	*indexTotalCost = pages * seq_page_cost +
+		numIndexTuples * (cpu_index_tuple_cost + BINGO_MATCH_COST * cpu_operator_cost);
+
+	return true;
+}
+#endif
+
 #if PG_VERSION_NUM / 100 == 904
 	PGDLLEXPORT PG_FUNCTION_INFO_V1(bingo_costestimate);
 #else
@@ -591,6 +868,7 @@ bingo_costestimate(PG_FUNCTION_ARGS) {
 	genericcostestimate92(root, path, loop_count, 1.0,
 						indexStartupCost, indexTotalCost,
 						indexSelectivity, indexCorrelation);
+	bingo_sampled_costestimate(path, indexTotalCost, indexSelectivity);
 #else
 
    struct PlannerInfo *root;
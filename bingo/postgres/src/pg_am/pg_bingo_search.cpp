@@ -5,8 +5,10 @@ extern "C" {
 #include "fmgr.h"
 #include "access/skey.h"
 #include "access/relscan.h"
+#include "access/genam.h"
 #include "utils/rel.h"
 #include "utils/relcache.h"
+#include "nodes/tidbitmap.h"
 #include "miscadmin.h"
 }
 
@@ -23,14 +25,17 @@ extern "C" {
 BINGO_FUNCTION_EXPORT(bingo_beginscan);
 
 BINGO_FUNCTION_EXPORT(bingo_gettuple);
-/*
- * Turn off bitmap scan
- */
-// BINGO_FUNCTION_EXPORT(bingo_getbitmap);
+
+BINGO_FUNCTION_EXPORT(bingo_getbitmap);
 
 BINGO_FUNCTION_EXPORT(bingo_rescan);
 
 BINGO_FUNCTION_EXPORT(bingo_endscan);
+
+/*
+ * Selectivity estimation for the planner, see pg_bingo_costestimate.c
+ */
+double bingo_estimate_selectivity(Relation index, int strategy, Datum query, int sample_sections, double* pages);
 }
 
 //#include <signal.h>
@@ -141,42 +146,53 @@ bingo_endscan(PG_FUNCTION_ARGS) {
    PG_RETURN_VOID();
 }
 using namespace indigo;
+
+static void _addBitmapTuples(TIDBitmap *tbm, Array<ItemPointerData>& items) {
+   if (items.size() == 0)
+      return;
+   BINGO_PG_TRY {
+      tbm_add_tuples(tbm, items.ptr(), items.size(), false);
+   } BINGO_PG_HANDLE(throw BingoPgError("internal error: can not add bitmap solution: %s", message));
+}
 /*
  * Get all tuples at once
  */
-//Datum
-//bingo_getbitmap(PG_FUNCTION_ARGS) {
-//   IndexScanDesc scan = (IndexScanDesc) PG_GETARG_POINTER(0);
-//   TIDBitmap *tbm = (TIDBitmap *) PG_GETARG_POINTER(1);
-//
-//   qword item_size = 0;
-//   BingoPgSearch* search_engine = (BingoPgSearch*) scan->opaque;
-//   PG_BINGO_BEGIN
-//   {
-//      /*
-//       * Create search engine
-//       */
-//      /*
-//       * Fetch to the next item and add result to the bitmap
-//       */
-//      indigo::Array<ItemPointerData> found_items;
-//      ItemPointer item_ptr;
-//      do {
-//         item_ptr = &found_items.push();
-//      } while (search_engine->next(scan, item_ptr));
-//      /*
-//       * Pop the last element
-//       */
-//      found_items.pop();
-//      item_size = found_items.size();
-//      BINGO_PG_TRY {
-//         tbm_add_tuples(tbm, found_items.ptr(), found_items.size(), false);
-//      } BINGO_PG_HANDLE(throw BingoPgError("internal error: can not add bitmap solution: %s", message));
-//   }
-//   PG_BINGO_HANDLE(delete search_engine);
-//
-//   PG_RETURN_INT64(item_size);
-//}
+Datum
+bingo_getbitmap(PG_FUNCTION_ARGS) {
+   IndexScanDesc scan = (IndexScanDesc) PG_GETARG_POINTER(0);
+   TIDBitmap *tbm = (TIDBitmap *) PG_GETARG_POINTER(1);
+
+   int64 item_size = 0;
+   BingoPgSearch* search_engine = (BingoPgSearch*) scan->opaque;
+   if(search_engine == NULL)
+      elog(ERROR, "bingo: search error: search context was deleted");
+
+   PG_BINGO_BEGIN
+   {
+      QS_DEF(Array<ItemPointerData>, found_items);
+      found_items.clear();
+      /*
+       * Fetch verified matches and add them to the bitmap by portions of a section size.
+       * The matches do not need a recheck
+       */
+      while (search_engine->next(scan, &found_items.push())) {
+         if (found_items.size() == BINGO_MOLS_PER_SECTION) {
+            _addBitmapTuples(tbm, found_items);
+            item_size += found_items.size();
+            found_items.clear();
+         }
+      }
+      /*
+       * Pop the last element that was not filled
+       */
+      found_items.pop();
+      _addBitmapTuples(tbm, found_items);
+      item_size += found_items.size();
+   }
+   PG_BINGO_HANDLE(delete search_engine; scan->opaque=NULL);
+
+   PG_RETURN_INT64(item_size);
+}
 /*
  * Get a tuples by a chain
  */
@@ -205,3 +221,45 @@ bingo_gettuple(PG_FUNCTION_ARGS) {
     */
    PG_RETURN_BOOL(result);
 }
+
+/*
+ * Estimate the fraction of the structures passing the screening for a query.
+ * Returns -1 if there is no estimation for the query
+ */
+double
+bingo_estimate_selectivity(Relation index, int strategy, Datum query, int sample_sections, double* pages) {
+   IndexScanDescData scan_data;
+   ScanKeyData key_data;
+   double result = -1;
+
+   *pages = 0;
+   /*
+    * The search engine reads the query from the scan keys
+    */
+   memset(&scan_data, 0, sizeof(scan_data));
+   memset(&key_data, 0, sizeof(key_data));
+   key_data.sk_strategy = strategy;
+   key_data.sk_argument = query;
+   scan_data.indexRelation = index;
+   scan_data.numberOfKeys = 1;
+   scan_data.keyData = &key_data;
+
+   try {
+      BingoPgSearch search(index);
+      result = search.estimateSelectivity(&scan_data, sample_sections, *pages);
+   } catch (Exception& e) {
+      /*
+       * The planner falls back to the default estimation, the query error is
+       * reported by the scan
+       */
+      elog(DEBUG1, "bingo: search: can not estimate selectivity: %s", e.message());
+      result = -1;
+   } catch (...) {
+      /*
+       * No exception can leave the planner callback
+       */
+      elog(DEBUG1, "bingo: search: can not estimate selectivity: unknown error");
+      result = -1;
+   }
+   return result;
+}
@@ -215,9 +215,11 @@ bool BingoPgBufferCacheFp::getBit(int str_idx) {
    return result;
 }
 
-void BingoPgBufferCacheFp::andWithBitset(BingoPgExternalBitset& ext_bitset) {
+int BingoPgBufferCacheFp::andWithBitset(BingoPgExternalBitset& ext_bitset) {
+   int result;
    if(_write) {
       ext_bitset.andWith(_cache);
+      result = _cache.bitsNumber();
    } else {
       /*
        * Read data for a buffer
@@ -230,8 +232,10 @@ void BingoPgBufferCacheFp::andWithBitset(BingoPgExternalBitset& ext_bitset) {
        * And with bitset
        */
       ext_bitset.andWith(_cache);
+      result = _cache.bitsNumber();
       _buffer.changeAccess(BINGO_PG_NOLOCK);
    }
+   return result;
 }
 
 void BingoPgBufferCacheFp::getCopy(BingoPgExternalBitset& other) {
@@ -86,9 +86,9 @@ public:
    void setBit(int str_idx, bool value);
    bool getBit(int str_idx);
    /*
-    * Main bit processing
+    * Main bit processing. Returns the number of structures having the fingerprint bit
     */
-   void andWithBitset(BingoPgExternalBitset& ext_bitset);
+   int andWithBitset(BingoPgExternalBitset& ext_bitset);
 
    void getCopy(BingoPgExternalBitset& other);
 
@@ -12,8 +12,10 @@ extern "C" {
 
 #include "base_cpp/tlscont.h"
 #include "base_cpp/array.h"
+#include "base_cpp/scanner.h"
 
 #include "bingo_pg_index.h"
+#include "bingo_pg_common.h"
 
 using namespace indigo;
 
@@ -89,4 +91,32 @@ void BingoPgBuildEngine::_processErrorCb (int id, void *context) {
    int block_number = ItemPointerGetBlockNumber(item_ptr);
    int offset_number = ItemPointerGetOffsetNumber(item_ptr);
    elog(WARNING, "build engine: error while processing record with ctid='(%d,%d)'::tid: %s", block_number, offset_number, bingoGetWarning());
+}
+
+void BingoPgBuildEngine::_handleIndexProcessError(int bingo_res, const char* suffix) {
+   /*
+    * If error on structure, try to parse ids
+    */
+   if(bingo_res < 0) {
+      const char* mes = bingoGetError();
+      const char* ERR_MES = "ERROR ON id=";
+      const char* id_s = strstr(mes, ERR_MES);
+      if(id_s != NULL) {
+         BufferScanner sc(id_s);
+         sc.skip(strlen(ERR_MES));
+         int id_n = -1;
+         try {
+            id_n = sc.readInt();
+         } catch (Exception&) {
+         }
+         ObjArray<StructCache>& struct_caches = *_structCaches;
+         if (id_n < struct_caches.size() && id_n >= 0) {
+            ItemPointer item_ptr = &(struct_caches[id_n].ptr);
+            int block_number = ItemPointerGetBlockNumber(item_ptr);
+            int offset_number = ItemPointerGetOffsetNumber(item_ptr);
+            CORE_HANDLE_ERROR_TID_NO_INDEX(bingo_res, 0, suffix, block_number, offset_number, bingoGetError());
+         }
+      }
+   }
+   CORE_HANDLE_ERROR(bingo_res, 0, suffix, bingoGetError());
 }
\ No newline at end of file
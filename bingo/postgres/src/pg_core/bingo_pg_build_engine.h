@@ -63,6 +63,10 @@ protected:
 
    static int _getNextRecordCb (void *context);
    static void _processErrorCb (int id, void *context);
+   /*
+    * Raises an error of bingoIndexProcess with the ctid of the failed record if it is known
+    */
+   void _handleIndexProcessError(int bingo_res, const char* suffix);
 
    qword _bingoSession;
    BingoPgIndex* _bufferIndexPtr;
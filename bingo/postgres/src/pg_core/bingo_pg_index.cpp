@@ -448,7 +448,7 @@ void BingoPgIndex::readTidItem(int section_idx, int mol_idx, PG_OBJECT result_pt
 
 }
 
-void BingoPgIndex::andWithBitset(int section_idx, int fp_idx, BingoPgExternalBitset& ext_bitset) {
+int BingoPgIndex::andWithBitset(int section_idx, int fp_idx, BingoPgExternalBitset& ext_bitset) {
    profTimerStart(t0, "bingo_pg.read_fp_and_with");
    /*
     * Prepare info for reading
@@ -458,8 +458,7 @@ void BingoPgIndex::andWithBitset(int section_idx, int fp_idx, BingoPgExternalBit
    /*
     * And with a bitset
     */
-   fp_buffer.andWithBitset(ext_bitset);
-   
+   return fp_buffer.andWithBitset(ext_bitset);
 }
 
 int BingoPgIndex::getSectionStructuresNumber(int section_idx) {
@@ -85,7 +85,10 @@ public:
    void readCmfItem(int section_idx, int mol_idx, indigo::Array<char>& cmf_buf);
    void readXyzItem(int section_idx, int mol_idx, indigo::Array<char>& xyz_buf);
 
-   void andWithBitset(int section_idx, int fp_idx, BingoPgExternalBitset& ext_bitset);
+   /*
+    * Returns the number of the section structures having the fingerprint bit
+    */
+   int andWithBitset(int section_idx, int fp_idx, BingoPgExternalBitset& ext_bitset);
 
    int getSectionStructuresNumber(int section_idx);
    const BingoSectionInfoData& getSectionInfo (int section_idx);
@@ -32,6 +32,7 @@ IMPL_ERROR(BingoPgSearch, "bingo search engine");
 
 BingoPgSearch::BingoPgSearch(PG_OBJECT rel):
 _initSearch(true),
+_dictionaryLoaded(false),
 _indexScanDesc(0),
 _bufferIndex(rel) {
    Relation rel_idx = (Relation)rel;
@@ -61,6 +62,13 @@ bool BingoPgSearch::next(PG_OBJECT scan_desc_ptr, PG_OBJECT result_ptr) {
    if(_initSearch) {
       _initScanSearch();
    }
+   /*
+    * Dictionary is needed only for matching the structures
+    */
+   if(!_dictionaryLoaded) {
+      _fpEngine->loadDictionary(_bufferIndex);
+      _dictionaryLoaded = true;
+   }
 
    /*
     * Search and return next element
@@ -113,7 +121,33 @@ void BingoPgSearch::_initScanSearch() {
     * Process query structure with parameters
     */
    _fpEngine->prepareQuerySearch(_bufferIndex, _indexScanDesc);
-   _fpEngine->loadDictionary(_bufferIndex);
+}
+
+double BingoPgSearch::estimateSelectivity(PG_OBJECT scan_desc_ptr, int sample_sections, double& pages) {
+   IndexScanDesc scan_desc = (IndexScanDesc) scan_desc_ptr;
+   pages = 0;
+   /*
+    * Exact, gross and mass searches use the shadow tables instead of the fingerprints
+    */
+   _bufferIndex.readMetaInfo();
+   int strategy = scan_desc->keyData[0].sk_strategy;
+   int index_type = _bufferIndex.getIndexType();
+
+   if (index_type == BINGO_INDEX_TYPE_MOLECULE) {
+      if (strategy != BingoPgCommon::MOL_SUB && strategy != BingoPgCommon::MOL_SMARTS && strategy != BingoPgCommon::MOL_SIM)
+         return -1;
+   } else if (index_type == BINGO_INDEX_TYPE_REACTION) {
+      if (strategy != BingoPgCommon::REACT_SUB && strategy != BingoPgCommon::REACT_SMARTS)
+         return -1;
+   } else {
+      return -1;
+   }
+
+   _indexScanDesc = scan_desc_ptr;
+   if(_initSearch) {
+      _initScanSearch();
+   }
+   return _fpEngine->estimateSelectivity(sample_sections, pages);
 }
 
 
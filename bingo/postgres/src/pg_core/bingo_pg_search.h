@@ -39,6 +39,13 @@ public:
 
    void prepareRescan(PG_OBJECT scan_desc_ptr);
 
+   /*
+    * Estimates the fraction of the indexed structures passing the fingerprint
+    * screening for the scan keys and the number of index pages read. Returns -1
+    * if the search type has no fingerprint screening
+    */
+   double estimateSelectivity(PG_OBJECT scan_desc_ptr, int sample_sections, double& pages);
+
    DECL_ERROR;
 
 private:
@@ -48,6 +55,7 @@ private:
 //   void _defineQueryOptions();
 
    bool _initSearch;
+   bool _dictionaryLoaded;
 
    PG_OBJECT _indexScanDesc;
 
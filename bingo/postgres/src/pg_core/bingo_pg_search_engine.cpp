@@ -96,6 +96,67 @@ void BingoPgSearchEngine::prepareQuerySearch(BingoPgIndex& bingo_idx, PG_OBJECT)
    _fetchFound = false;
    _blockBegin=0;
    _blockEnd=bingo_idx.getSectionNumber();
+   _queryBits.clear();
+   _queryBitsOrder.clear();
+   _queryBitsPopulation.clear();
+   _queryBitsSections.clear();
+}
+
+double BingoPgSearchEngine::estimateSelectivity(int sample_sections, double& pages) {
+   BingoPgFpData& query_data = _queryFpData.ref();
+   BingoPgIndex& bingo_index = *_bufferIndexPtr;
+   int sections = _blockEnd - _blockBegin;
+
+   pages = 0;
+   if (sections <= 0 || sample_sections <= 0)
+      return 0;
+
+   /*
+    * Round the step up, so no more than sample_sections sections are read
+    */
+   int step = (sections + sample_sections - 1) / sample_sections;
+   int sampled = 0;
+   qword structures = 0, passed = 0, blocks = 0;
+
+   for (int section_idx = _blockBegin; section_idx < _blockEnd; section_idx += step) {
+      bingo_index.getSectionBitset(section_idx, _sectionBitset);
+      structures += _sectionBitset.bitsNumber();
+      /*
+       * Screen the section by all the query bits until no structures are left
+       */
+      for (int fp_idx = query_data.bitBegin(); fp_idx != query_data.bitEnd() && _sectionBitset.hasBits(); fp_idx = query_data.bitNext(fp_idx)) {
+         bingo_index.andWithBitset(section_idx, query_data.getBit(fp_idx), _sectionBitset);
+         ++blocks;
+      }
+      passed += _sectionBitset.bitsNumber();
+      ++sampled;
+   }
+
+   /*
+    * Section meta pages and the fingerprint blocks read
+    */
+   pages = (double)sections * (BingoPgSection::SECTION_META_PAGES + (double)blocks / sampled);
+
+   if (structures == 0)
+      return 0;
+   return (double)passed / structures;
+}
+
+void BingoPgSearchEngine::_sortQueryBits() {
+   _queryBitsOrder.qsort(_cmpQueryBits, this);
+}
+
+int BingoPgSearchEngine::_cmpQueryBits(int& i1, int& i2, void* context) {
+   BingoPgSearchEngine& self = *(BingoPgSearchEngine*) context;
+   /*
+    * Compare the average populations. Bits without statistics are screened first
+    */
+   qword p1 = self._queryBitsPopulation[i1] * __max(self._queryBitsSections[i2], 1);
+   qword p2 = self._queryBitsPopulation[i2] * __max(self._queryBitsSections[i1], 1);
+
+   if (p1 != p2)
+      return p1 < p2 ? -1 : 1;
+   return i1 - i2;
 }
 
 bool BingoPgSearchEngine::_searchNextCursor(PG_OBJECT result_ptr) {
@@ -162,16 +223,30 @@ bool BingoPgSearchEngine::_searchNextSub(PG_OBJECT result_ptr) {
        * If there is no fingerprints then check every molecule
        */
       if (query_data.bitEnd() != 0) {
+         if (_queryBits.size() == 0) {
+            for (int fp_idx = query_data.bitBegin(); fp_idx != query_data.bitEnd(); fp_idx = query_data.bitNext(fp_idx)) {
+               _queryBitsOrder.push(_queryBits.size());
+               _queryBits.push(query_data.getBit(fp_idx));
+            }
+            _queryBitsPopulation.clear_resize(_queryBits.size());
+            _queryBitsPopulation.zerofill();
+            _queryBitsSections.clear_resize(_queryBits.size());
+            _queryBitsSections.zerofill();
+         }
          /*
-          * Iterate through the query bits
+          * Iterate through the query bits from the rarest one until no structures are left
           */
-         for (int fp_idx = query_data.bitBegin(); fp_idx != query_data.bitEnd() && _sectionBitset.hasBits(); fp_idx = query_data.bitNext(fp_idx)) {
-            int fp_block = query_data.getBit(fp_idx);
+         for (int i = 0; i < _queryBitsOrder.size() && _sectionBitset.hasBits(); ++i) {
+            int bit_idx = _queryBitsOrder[i];
             /*
              * Get fingerprint buffer in the current section
              */
-            bingo_index.andWithBitset(_currentSection, fp_block, _sectionBitset);
+            _queryBitsPopulation[bit_idx] += bingo_index.andWithBitset(_currentSection, _queryBits[bit_idx], _sectionBitset);
+            ++_queryBitsSections[bit_idx];
+            profIncCounter("bingo_pg.fp_blocks_read", 1);
          }
+         profIncCounter("bingo_pg.sections_screened", 1);
+         _sortQueryBits();
       }
       /*
        * If bitset is not null then matches are found
@@ -81,6 +81,12 @@ public:
 
    virtual void prepareQuerySearch(BingoPgIndex&, PG_OBJECT scan_desc);
    virtual bool searchNext(PG_OBJECT result_ptr) {return false;}
+   /*
+    * Estimates the fraction of the structures passing the fingerprint screening
+    * by sampling up to sample_sections sections evenly. Sets the estimated number
+    * of pages read by the screening of all the sections
+    */
+   virtual double estimateSelectivity(int sample_sections, double& pages);
 
    void setItemPointer(PG_OBJECT result_ptr);
 
@@ -98,6 +104,12 @@ protected:
    bool _fetchForNext();
 
    void _getBlockParameters(indigo::Array<char>& params);
+   /*
+    * Orders the query fingerprint bits from the rarest to the most common
+    * by the population of their blocks in the sections screened so far
+    */
+   void _sortQueryBits();
+   static int _cmpQueryBits(int& i1, int& i2, void* context);
 
    qword _bingoSession;
 
@@ -111,6 +123,14 @@ protected:
    BingoPgIndex* _bufferIndexPtr;
 
    BingoPgExternalBitset _sectionBitset;
+   /*
+    * Query fingerprint bits in the screening order and their population
+    * statistics: structures having the bit and sections screened by the bit
+    */
+   indigo::Array<int> _queryBits;
+   indigo::Array<int> _queryBitsOrder;
+   indigo::Array<qword> _queryBitsPopulation;
+   indigo::Array<int> _queryBitsSections;
    indigo::AutoPtr<BingoPgFpData> _queryFpData;
    indigo::AutoPtr<BingoPgCursor> _searchCursor;
 };
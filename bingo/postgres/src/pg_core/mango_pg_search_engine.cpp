@@ -183,6 +183,52 @@ bool MangoPgSearchEngine::searchNext(PG_OBJECT result_ptr) {
    return result;
 }
 
+double MangoPgSearchEngine::estimateSelectivity(int sample_sections, double& pages) {
+   if (_searchType != BingoPgCommon::MOL_SIM)
+      return BingoPgSearchEngine::estimateSelectivity(sample_sections, pages);
+
+   BingoPgFpData& query_data = _queryFpData.ref();
+   BingoPgIndex& bingo_index = *_bufferIndexPtr;
+   QS_DEF(Array<int>, bits_count);
+   int sections = _blockEnd - _blockBegin;
+   int query_bits = query_data.bitEnd();
+   int* min_bounds, * max_bounds, bingo_res;
+
+   /*
+    * Similarity search reads the bits count pages and all the query fingerprint blocks
+    */
+   pages = (double)sections * (BingoPgSection::SECTION_META_PAGES + BingoPgSection::SECTION_BITSNUMBER_PAGES + query_bits);
+   if (sections <= 0 || sample_sections <= 0)
+      return 0;
+
+   _setBingoContext();
+
+   int step = (sections + sample_sections - 1) / sample_sections;
+   qword structures = 0, passed = 0;
+
+   for (int section_idx = _blockBegin; section_idx < _blockEnd; section_idx += step) {
+      bingo_index.getSectionBitset(section_idx, _sectionBitset);
+      bingo_index.getSectionBitsCount(section_idx, bits_count);
+
+      bingo_res = mangoSimilarityGetBitMinMaxBoundsArray(bits_count.size(), bits_count.ptr(), &min_bounds, &max_bounds);
+      CORE_HANDLE_ERROR(bingo_res, 1, "molecule search engine: error while getting similarity bounds array", bingoGetError());
+      /*
+       * Common bits can not exceed the bits count of the query or of the structure,
+       * so the structures with unreachable bounds do not pass the screening
+       */
+      for (int str_idx = _sectionBitset.begin(); str_idx != _sectionBitset.end(); str_idx = _sectionBitset.next(str_idx)) {
+         ++structures;
+         int max_common = __min(__min(max_bounds[str_idx], query_bits), bits_count[str_idx]);
+         if (min_bounds[str_idx] <= max_common)
+            ++passed;
+      }
+   }
+
+   if (structures == 0)
+      return 0;
+   return (double)passed / structures;
+}
+
 void MangoPgSearchEngine::_errorHandler(const char* message, void*) {
    throw Error("Error while searching a molecule: %s", message);
 }
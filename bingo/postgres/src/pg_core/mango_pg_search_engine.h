@@ -69,6 +69,7 @@ public:
 
    virtual void prepareQuerySearch(BingoPgIndex&, PG_OBJECT scan_desc);
    virtual bool searchNext(PG_OBJECT result_ptr);
+   virtual double estimateSelectivity(int sample_sections, double& pages);
 
    DECL_ERROR;
 
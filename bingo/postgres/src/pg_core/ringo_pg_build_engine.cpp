@@ -95,7 +95,7 @@ void RingoPgBuildEngine::processStructures(ObjArray<StructCache>& struct_caches)
     * Process target
     */
    bingo_res = bingoIndexProcess(true, _getNextRecordCb, _processResultCb, _processErrorCb, this);
-   CORE_HANDLE_ERROR(bingo_res, 0, "reaction build engine: error while processing records", bingoGetError());
+   _handleIndexProcessError(bingo_res, "reaction build engine: error while processing records");
    _setBingoContext();
 
 }
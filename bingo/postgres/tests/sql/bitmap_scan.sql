@@ -0,0 +1,20 @@
+--
+-- Bitmap scans return the matches by portions of a section size, so the
+-- result set is larger than one section (64000 molecules). Bitmap and
+-- plain index scans must return the same number of rows.
+--
+CREATE TABLE bitmap_scan_test (id serial, m text);
+INSERT INTO bitmap_scan_test (m)
+   SELECT 'C' || repeat('C', i % 8) || 'O' FROM generate_series(1, 70000) AS i;
+CREATE INDEX bitmap_scan_test_idx ON bitmap_scan_test USING bingo_idx (m bingo.molecule);
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+SET enable_indexscan = on;
+SELECT count(*) FROM bitmap_scan_test WHERE m @ ('CO', '')::bingo.sub;
+SET enable_indexscan = off;
+SET enable_bitmapscan = on;
+SELECT count(*) FROM bitmap_scan_test WHERE m @ ('CO', '')::bingo.sub;
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+RESET enable_indexscan;
+DROP TABLE bitmap_scan_test;
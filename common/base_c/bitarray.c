@@ -16,6 +16,7 @@
 #include <string.h>
 
 #include "base_c/bitarray.h"
+#include "base_c/bitarray_kernels.h"
 
 int bitGetBit (const void *bitarray, int bitno)
 {
@@ -131,17 +132,18 @@ int bitGetOnesCountDword (dword v)
    return (((v + (v >> 4)) & 0xF0F0F0F) * 0x1010101) >> 24; // count
 }
 
-int bitGetOnesCountQword (qword value)
+int bitGetOnesCountQword (qword v)
 {
-   return bitGetOnesCountDword((dword)value) + bitGetOnesCountDword((dword)(value >> 32));
+   // http://graphics.stanford.edu/~seander/bithacks.html#CountBitsSetParallel
+   v = v - ((v >> 1) & 0x5555555555555555ULL);
+   v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+   v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+   return (int)((v * 0x0101010101010101ULL) >> 56);
 }
 
 int bitGetOnesCount (const byte *data, int size)
 {
-   int count = 0;
-   while (size-- > 0)
-      count += bitGetOnesCountByte(*data++);
-   return count;
+   return bitKernelsGet()->ones(data, size);
 }
 
 int bitGetOneHOIndex  (byte value)
@@ -246,31 +248,20 @@ int bitIdecticalBits (const byte *bit1, const byte *bit2, int n_bytes)
 
 int bitCommonOnes (const byte *bit1, const byte *bit2, int n_bytes)
 {
-   int qwords_count = n_bytes / sizeof(qword);
-   int bytes_left = n_bytes - qwords_count * sizeof(qword);
-
-   int count = 0;
-   const qword *bit1_ptr = (const qword *)bit1;
-   const qword *bit2_ptr = (const qword *)bit2;
-   while (qwords_count-- > 0)
-   {
-      qword id = *bit1_ptr & *bit2_ptr;
-      count += bitGetOnesCountQword(id);
+   return bitKernelsGet()->common(bit1, bit2, n_bytes);
+}
 
-      bit1_ptr++;
-      bit2_ptr++;
-   }
+int bitUniqueOnes (const byte *bit1, const byte *bit2, int n_bytes)
+{
+   return bitKernelsGet()->andnot(bit1, bit2, n_bytes);
+}
 
-   if (bytes_left != 0)
-   {
-      qword mask = ~(qword)0 >> (64 - 8 * bytes_left);
-      qword id = *bit1_ptr & *bit2_ptr & mask;
-      count += bitGetOnesCountQword(id);
-   }
-   return count;
+int bitDifferentOnes (const byte *bit1, const byte *bit2, int n_bytes)
+{
+   return bitKernelsGet()->different(bit1, bit2, n_bytes);
 }
 
-int bitUniqueOnes (const byte *bit1, const byte *bit2, int n_bytes)
+int bitUnionOnes (const byte *bit1, const byte *bit2, int n_bytes)
 {
    int qwords_count = n_bytes / sizeof(qword);
    int bytes_left = n_bytes - qwords_count * sizeof(qword);
@@ -280,7 +271,7 @@ int bitUniqueOnes (const byte *bit1, const byte *bit2, int n_bytes)
    const qword *bit2_ptr = (const qword *)bit2;
    while (qwords_count-- > 0)
    {
-      qword id = *bit1_ptr & ~*bit2_ptr;
+      qword id = *bit1_ptr | *bit2_ptr;
       count += bitGetOnesCountQword(id);
 
       bit1_ptr++;
@@ -290,67 +281,68 @@ int bitUniqueOnes (const byte *bit1, const byte *bit2, int n_bytes)
    if (bytes_left != 0)
    {
       qword mask = ~(qword)0 >> (64 - 8 * bytes_left);
-      qword id = *bit1_ptr & ~*bit2_ptr & mask;
+      qword id = (*bit1_ptr | *bit2_ptr) & mask;
       count += bitGetOnesCountQword(id);
    }
    return count;
 }
 
-int bitDifferentOnes (const byte *bit1, const byte *bit2, int n_bytes)
+void bitGetOnesCountBlock (const byte *data, int n_bytes, int count, int *counts)
 {
-   int qwords_count = n_bytes / sizeof(qword);
-   int bytes_left = n_bytes - qwords_count * sizeof(qword);
+   const BitKernels *kernels = bitKernelsGet();
+   int i;
 
-   int count = 0;
-   const qword *bit1_ptr = (const qword *)bit1;
-   const qword *bit2_ptr = (const qword *)bit2;
-   while (qwords_count-- > 0)
-   {
-      qword id = *bit1_ptr ^ *bit2_ptr;
-      count += bitGetOnesCount((byte*)&id, sizeof(qword));
+   for (i = 0; i < count; i++, data += n_bytes)
+      counts[i] = kernels->ones(data, n_bytes);
+}
 
-      bit1_ptr++;
-      bit2_ptr++;
-   }
+void bitCommonOnesBlock (const byte *query, const byte *data, int n_bytes, int count, int *counts)
+{
+   const BitKernels *kernels = bitKernelsGet();
+   int i;
 
-   if (bytes_left != 0)
-   {
-      qword mask = ~(qword)0 >> (64 - 8 * bytes_left);
-      qword id = (*bit1_ptr ^ *bit2_ptr) & mask;
-      count += bitGetOnesCountQword(id);
-   }
-   return count;
+   for (i = 0; i < count; i++, data += n_bytes)
+      counts[i] = kernels->common(query, data, n_bytes);
 }
 
-int bitUnionOnes (const byte *bit1, const byte *bit2, int n_bytes)
+void bitUniqueOnesBlock (const byte *query, const byte *data, int n_bytes, int count, int *counts)
 {
-   int qwords_count = n_bytes / sizeof(qword);
-   int bytes_left = n_bytes - qwords_count * sizeof(qword);
+   const BitKernels *kernels = bitKernelsGet();
+   int i;
 
-   int count = 0;
-   const qword *bit1_ptr = (const qword *)bit1;
-   const qword *bit2_ptr = (const qword *)bit2;
-   while (qwords_count-- > 0)
-   {
-      qword id = *bit1_ptr | *bit2_ptr;
-      count += bitGetOnesCountQword(id);
+   for (i = 0; i < count; i++, data += n_bytes)
+      counts[i] = kernels->andnot(query, data, n_bytes);
+}
 
-      bit1_ptr++;
-      bit2_ptr++;
-   }
+const char * bitGetKernelName (void)
+{
+   return bitKernelsGet()->name;
+}
 
-   if (bytes_left != 0)
-   {
-      qword mask = ~(qword)0 >> (64 - 8 * bytes_left);
-      qword id = (*bit1_ptr | *bit2_ptr) & mask;
-      count += bitGetOnesCountQword(id);
-   }
-   return count;
+int bitSetKernel (const char *name)
+{
+   const BitKernels *kernels = bitKernelsFind(name);
+
+   if (kernels == 0)
+      return 0;
+
+   bitKernelsSet(kernels);
+   return 1;
 }
 
 // a &= b
 void bitAnd (byte *a, const byte *b, int nbytes)
 {
+   qword x, y;
+
+   for (; nbytes >= 8; a += 8, b += 8, nbytes -= 8)
+   {
+      memcpy(&x, a, sizeof(qword));
+      memcpy(&y, b, sizeof(qword));
+      x &= y;
+      memcpy(a, &x, sizeof(qword));
+   }
+
    while (nbytes-- > 0)
    {
       *a = *a & *b;
@@ -359,6 +351,42 @@ void bitAnd (byte *a, const byte *b, int nbytes)
    }
 }
 
+int bitAndOnes (byte *a, const byte *b, int n_bytes)
+{
+   return bitKernelsGet()->and_ones(a, b, n_bytes);
+}
+
+int bitGetOnesIndices (const byte *data, int n_bytes, int offset, int *indices)
+{
+   int count = 0, i = 0;
+   qword word;
+   byte value;
+
+   while (i < n_bytes)
+   {
+      if (n_bytes - i >= 8)
+      {
+         // Skip zero words at once
+         memcpy(&word, data + i, sizeof(qword));
+         if (word == 0)
+         {
+            i += 8;
+            continue;
+         }
+      }
+
+      value = data[i];
+      while (value != 0)
+      {
+         indices[count++] = offset + i * 8 + bitGetOneLOIndex(value);
+         value &= value - 1;
+      }
+      i++;
+   }
+
+   return count;
+}
+
 // a |= b
 void bitOr (byte *a, const byte *b, int nbytes)
 {
@@ -373,6 +401,14 @@ void bitOr (byte *a, const byte *b, int nbytes)
 int bitIsAllZero (const void *bits, int nbytes)
 {
    const byte *a = (const byte *)bits;
+   qword word;
+
+   for (; nbytes >= 8; a += 8, nbytes -= 8)
+   {
+      memcpy(&word, a, sizeof(qword));
+      if (word != 0)
+         return 0;
+   }
 
    while (nbytes-- > 0)
    {
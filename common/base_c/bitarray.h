@@ -52,7 +52,22 @@ DLLEXPORT int bitUniqueOnes    (const byte *bit1, const byte *bit2, int n_bytes)
 DLLEXPORT int bitDifferentOnes (const byte *bit1, const byte *bit2, int n_bytes);
 DLLEXPORT int bitUnionOnes     (const byte *bit1, const byte *bit2, int n_bytes);
 
+// Block versions for count fingerprints of n_bytes stored one after another:
+// counts[i] = ones(data_i), ones(query & data_i), ones(query & ~data_i)
+DLLEXPORT void bitGetOnesCountBlock (const byte *data, int n_bytes, int count, int *counts);
+DLLEXPORT void bitCommonOnesBlock   (const byte *query, const byte *data, int n_bytes, int count, int *counts);
+DLLEXPORT void bitUniqueOnesBlock   (const byte *query, const byte *data, int n_bytes, int count, int *counts);
+
+// Name of the population count kernels in use: "scalar", "popcnt", "avx2" or "avx512"
+DLLEXPORT const char * bitGetKernelName (void);
+// Select kernels by name. Returns 0 if they are not supported by the CPU.
+DLLEXPORT int bitSetKernel (const char *name);
+
 DLLEXPORT void bitAnd (byte *a, const byte *b, int n_bytes);
+// a &= b, returns number of ones in the result
+DLLEXPORT int  bitAndOnes (byte *a, const byte *b, int n_bytes);
+// Writes offset + index of each 1-bit into indices and returns their number
+DLLEXPORT int  bitGetOnesIndices (const byte *data, int n_bytes, int offset, int *indices);
 DLLEXPORT void bitOr (byte *a, const byte *b, int nbytes);
 
 // Check whether bit array is zero
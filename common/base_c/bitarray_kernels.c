@@ -0,0 +1,435 @@
+/****************************************************************************
+ * Copyright (C) 2009-2015 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#include <string.h>
+
+#include "base_c/bitarray_kernels.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+   #define BIT_KERNELS_X86_GNUC
+   #include <cpuid.h>
+   #include <immintrin.h>
+   #if defined(__clang__)
+      #if __clang_major__ >= 6
+         #define BIT_KERNELS_AVX2
+         #define BIT_KERNELS_AVX512
+      #endif
+   #else
+      #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+         #define BIT_KERNELS_AVX2
+      #endif
+      #if __GNUC__ >= 7
+         #define BIT_KERNELS_AVX512
+      #endif
+   #endif
+#elif defined(_MSC_VER) && defined(_M_X64)
+   // Only hardware POPCNT is used with MSVC: it doesn't allow to compile
+   // single functions for a different instruction set
+   #define BIT_KERNELS_X86_MSVC
+   #include <intrin.h>
+#endif
+
+static qword _load64 (const byte *p)
+{
+   qword v;
+   memcpy(&v, p, sizeof(qword));
+   return v;
+}
+
+// Loads last n < 8 bytes padding them with zeros
+static qword _loadTail (const byte *p, int n)
+{
+   qword v = 0;
+   memcpy(&v, p, n);
+   return v;
+}
+
+static int _popcnt64Scalar (qword v)
+{
+   // http://graphics.stanford.edu/~seander/bithacks.html#CountBitsSetParallel
+   v = v - ((v >> 1) & 0x5555555555555555ULL);
+   v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+   v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+   return (int)((v * 0x0101010101010101ULL) >> 56);
+}
+
+// Kernel bodies are shared between the scalar and the POPCNT variants. They
+// differ only in the population count instruction and in the target
+// attribute of the enclosing function.
+#define BIT_KERNEL_BODY_1(a, n, popcnt)                              \
+   {                                                                 \
+      int count = 0;                                                 \
+      for (; n >= 8; a += 8, n -= 8)                                 \
+         count += popcnt(_load64(a));                                \
+      if (n > 0)                                                     \
+         count += popcnt(_loadTail(a, n));                           \
+      return count;                                                  \
+   }
+
+#define BIT_KERNEL_BODY_2(a, b, n, op, popcnt)                       \
+   {                                                                 \
+      int count = 0;                                                 \
+      qword x, y;                                                    \
+      for (; n >= 8; a += 8, b += 8, n -= 8)                         \
+      {                                                              \
+         x = _load64(a);                                             \
+         y = _load64(b);                                             \
+         count += popcnt(op(x, y));                                  \
+      }                                                              \
+      if (n > 0)                                                     \
+      {                                                              \
+         x = _loadTail(a, n);                                        \
+         y = _loadTail(b, n);                                        \
+         count += popcnt(op(x, y));                                  \
+      }                                                              \
+      return count;                                                  \
+   }
+
+// a &= b with the population count of the result
+#define BIT_KERNEL_BODY_AND(a, b, n, popcnt)                         \
+   {                                                                 \
+      int count = 0;                                                 \
+      qword x;                                                       \
+      for (; n >= 8; a += 8, b += 8, n -= 8)                         \
+      {                                                              \
+         x = _load64(a) & _load64(b);                                \
+         memcpy(a, &x, sizeof(qword));                               \
+         count += popcnt(x);                                         \
+      }                                                              \
+      for (; n > 0; a++, b++, n--)                                   \
+      {                                                              \
+         *a &= *b;                                                   \
+         count += popcnt((qword)*a);                                 \
+      }                                                              \
+      return count;                                                  \
+   }
+
+#define BIT_OP_AND(x, y) ((x) & (y))
+#define BIT_OP_ANDNOT(x, y) ((x) & ~(y))
+#define BIT_OP_XOR(x, y) ((x) ^ (y))
+
+//
+// Scalar kernels
+//
+
+static int _onesScalar (const byte *a, int n)
+   BIT_KERNEL_BODY_1(a, n, _popcnt64Scalar)
+
+static int _commonScalar (const byte *a, const byte *b, int n)
+   BIT_KERNEL_BODY_2(a, b, n, BIT_OP_AND, _popcnt64Scalar)
+
+static int _andnotScalar (const byte *a, const byte *b, int n)
+   BIT_KERNEL_BODY_2(a, b, n, BIT_OP_ANDNOT, _popcnt64Scalar)
+
+static int _differentScalar (const byte *a, const byte *b, int n)
+   BIT_KERNEL_BODY_2(a, b, n, BIT_OP_XOR, _popcnt64Scalar)
+
+static int _andOnesScalar (byte *a, const byte *b, int n)
+   BIT_KERNEL_BODY_AND(a, b, n, _popcnt64Scalar)
+
+static const BitKernels _kernels_scalar =
+   {"scalar", _onesScalar, _commonScalar, _andnotScalar, _differentScalar, _andOnesScalar};
+
+//
+// POPCNT kernels
+//
+
+#if defined(BIT_KERNELS_X86_GNUC) || defined(BIT_KERNELS_X86_MSVC)
+
+#ifdef BIT_KERNELS_X86_GNUC
+   #define BIT_TARGET_POPCNT __attribute__((target("popcnt")))
+   #define _popcnt64Hw(v) __builtin_popcountll(v)
+#else
+   #define BIT_TARGET_POPCNT
+   #define _popcnt64Hw(v) ((int)__popcnt64(v))
+#endif
+
+BIT_TARGET_POPCNT static int _onesPopcnt (const byte *a, int n)
+   BIT_KERNEL_BODY_1(a, n, _popcnt64Hw)
+
+BIT_TARGET_POPCNT static int _commonPopcnt (const byte *a, const byte *b, int n)
+   BIT_KERNEL_BODY_2(a, b, n, BIT_OP_AND, _popcnt64Hw)
+
+BIT_TARGET_POPCNT static int _andnotPopcnt (const byte *a, const byte *b, int n)
+   BIT_KERNEL_BODY_2(a, b, n, BIT_OP_ANDNOT, _popcnt64Hw)
+
+BIT_TARGET_POPCNT static int _differentPopcnt (const byte *a, const byte *b, int n)
+   BIT_KERNEL_BODY_2(a, b, n, BIT_OP_XOR, _popcnt64Hw)
+
+BIT_TARGET_POPCNT static int _andOnesPopcnt (byte *a, const byte *b, int n)
+   BIT_KERNEL_BODY_AND(a, b, n, _popcnt64Hw)
+
+static const BitKernels _kernels_popcnt =
+   {"popcnt", _onesPopcnt, _commonPopcnt, _andnotPopcnt, _differentPopcnt, _andOnesPopcnt};
+
+#endif
+
+//
+// AVX2 kernels
+//
+
+#ifdef BIT_KERNELS_AVX2
+
+#define BIT_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+
+// Per-nibble lookup with vpshufb summed by vpsadbw into four 64-bit counters
+// (W. Mula, N. Kurz, D. Lemire, "Faster Population Counts Using AVX2 Instructions")
+BIT_TARGET_AVX2 static __m256i _popcnt256 (__m256i v)
+{
+   const __m256i lookup = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+   const __m256i low_mask = _mm256_set1_epi8(0x0F);
+
+   __m256i lo = _mm256_and_si256(v, low_mask);
+   __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+   __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+
+   return _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+}
+
+BIT_TARGET_AVX2 static int _sum256 (__m256i acc)
+{
+   __m128i s = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+   s = _mm_add_epi64(s, _mm_unpackhi_epi64(s, s));
+   return (int)_mm_cvtsi128_si32(s);
+}
+
+#define BIT_KERNEL_AVX2_2(name, vop, tail)                                       \
+   BIT_TARGET_AVX2 static int name (const byte *a, const byte *b, int n)         \
+   {                                                                             \
+      __m256i acc = _mm256_setzero_si256();                                      \
+      for (; n >= 32; a += 32, b += 32, n -= 32)                                 \
+      {                                                                          \
+         __m256i x = _mm256_loadu_si256((const __m256i *)a);                     \
+         __m256i y = _mm256_loadu_si256((const __m256i *)b);                     \
+         acc = _mm256_add_epi64(acc, _popcnt256(vop(x, y)));                     \
+      }                                                                          \
+      return _sum256(acc) + tail(a, b, n);                                       \
+   }
+
+BIT_TARGET_AVX2 static int _onesAvx2 (const byte *a, int n)
+{
+   __m256i acc = _mm256_setzero_si256();
+   for (; n >= 32; a += 32, n -= 32)
+      acc = _mm256_add_epi64(acc, _popcnt256(_mm256_loadu_si256((const __m256i *)a)));
+   return _sum256(acc) + _onesPopcnt(a, n);
+}
+
+#define BIT_VOP_AVX2_ANDNOT(x, y) _mm256_andnot_si256(y, x)
+
+BIT_KERNEL_AVX2_2(_commonAvx2, _mm256_and_si256, _commonPopcnt)
+BIT_KERNEL_AVX2_2(_andnotAvx2, BIT_VOP_AVX2_ANDNOT, _andnotPopcnt)
+BIT_KERNEL_AVX2_2(_differentAvx2, _mm256_xor_si256, _differentPopcnt)
+
+BIT_TARGET_AVX2 static int _andOnesAvx2 (byte *a, const byte *b, int n)
+{
+   __m256i acc = _mm256_setzero_si256();
+   for (; n >= 32; a += 32, b += 32, n -= 32)
+   {
+      __m256i x = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)a), _mm256_loadu_si256((const __m256i *)b));
+      _mm256_storeu_si256((__m256i *)a, x);
+      acc = _mm256_add_epi64(acc, _popcnt256(x));
+   }
+   return _sum256(acc) + _andOnesPopcnt(a, b, n);
+}
+
+static const BitKernels _kernels_avx2 =
+   {"avx2", _onesAvx2, _commonAvx2, _andnotAvx2, _differentAvx2, _andOnesAvx2};
+
+#endif
+
+//
+// AVX-512 VPOPCNTDQ kernels
+//
+
+#ifdef BIT_KERNELS_AVX512
+
+#define BIT_TARGET_AVX512 __attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+
+#define BIT_KERNEL_AVX512_2(name, vop, tail)                                     \
+   BIT_TARGET_AVX512 static int name (const byte *a, const byte *b, int n)       \
+   {                                                                             \
+      __m512i acc = _mm512_setzero_si512();                                      \
+      for (; n >= 64; a += 64, b += 64, n -= 64)                                 \
+      {                                                                          \
+         __m512i x = _mm512_loadu_si512((const void *)a);                        \
+         __m512i y = _mm512_loadu_si512((const void *)b);                        \
+         acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(vop(x, y)));            \
+      }                                                                          \
+      return (int)_mm512_reduce_add_epi64(acc) + tail(a, b, n);                  \
+   }
+
+BIT_TARGET_AVX512 static int _onesAvx512 (const byte *a, int n)
+{
+   __m512i acc = _mm512_setzero_si512();
+   for (; n >= 64; a += 64, n -= 64)
+      acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512((const void *)a)));
+   return (int)_mm512_reduce_add_epi64(acc) + _onesPopcnt(a, n);
+}
+
+#define BIT_VOP_AVX512_ANDNOT(x, y) _mm512_andnot_si512(y, x)
+
+BIT_KERNEL_AVX512_2(_commonAvx512, _mm512_and_si512, _commonPopcnt)
+BIT_KERNEL_AVX512_2(_andnotAvx512, BIT_VOP_AVX512_ANDNOT, _andnotPopcnt)
+BIT_KERNEL_AVX512_2(_differentAvx512, _mm512_xor_si512, _differentPopcnt)
+
+BIT_TARGET_AVX512 static int _andOnesAvx512 (byte *a, const byte *b, int n)
+{
+   __m512i acc = _mm512_setzero_si512();
+   for (; n >= 64; a += 64, b += 64, n -= 64)
+   {
+      __m512i x = _mm512_and_si512(_mm512_loadu_si512((const void *)a), _mm512_loadu_si512((const void *)b));
+      _mm512_storeu_si512((void *)a, x);
+      acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(x));
+   }
+   return (int)_mm512_reduce_add_epi64(acc) + _andOnesPopcnt(a, b, n);
+}
+
+static const BitKernels _kernels_avx512 =
+   {"avx512", _onesAvx512, _commonAvx512, _andnotAvx512, _differentAvx512, _andOnesAvx512};
+
+#endif
+
+//
+// CPU features detection
+//
+
+#define BIT_CPU_POPCNT 1
+#define BIT_CPU_AVX2   2
+#define BIT_CPU_AVX512 4
+
+#if defined(BIT_KERNELS_X86_GNUC)
+
+static unsigned int _xgetbv0 (void)
+{
+   unsigned int eax, edx;
+   // xgetbv is encoded explicitly for old assemblers
+   __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0));
+   return eax;
+}
+
+static int _detectCpuFeatures (void)
+{
+   unsigned int eax, ebx, ecx, edx, xcr0;
+   int features = 0;
+
+   if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+      return 0;
+
+   if (ecx & (1 << 23))
+      features |= BIT_CPU_POPCNT;
+
+   // AVX state must be enabled by the OS (OSXSAVE + XCR0)
+   if (!(ecx & (1 << 27)) || !(ecx & (1 << 28)))
+      return features;
+
+   xcr0 = _xgetbv0();
+   if ((xcr0 & 0x6) != 0x6 || __get_cpuid_max(0, 0) < 7)
+      return features;
+
+   __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+   if (ebx & (1 << 5))
+      features |= BIT_CPU_AVX2;
+   // AVX512F and AVX512_VPOPCNTDQ with opmask and ZMM states enabled
+   if ((ebx & (1 << 16)) && (ecx & (1 << 14)) && (xcr0 & 0xE0) == 0xE0)
+      features |= BIT_CPU_AVX512;
+
+   return features;
+}
+
+#elif defined(BIT_KERNELS_X86_MSVC)
+
+static int _detectCpuFeatures (void)
+{
+   int regs[4];
+
+   __cpuid(regs, 1);
+   return (regs[2] & (1 << 23)) ? BIT_CPU_POPCNT : 0;
+}
+
+#else
+
+static int _detectCpuFeatures (void)
+{
+   return 0;
+}
+
+#endif
+
+static const BitKernels * _selectKernels (int features)
+{
+#ifdef BIT_KERNELS_AVX512
+   if ((features & BIT_CPU_AVX512) && (features & BIT_CPU_POPCNT))
+      return &_kernels_avx512;
+#endif
+#ifdef BIT_KERNELS_AVX2
+   if ((features & BIT_CPU_AVX2) && (features & BIT_CPU_POPCNT))
+      return &_kernels_avx2;
+#endif
+#if defined(BIT_KERNELS_X86_GNUC) || defined(BIT_KERNELS_X86_MSVC)
+   if (features & BIT_CPU_POPCNT)
+      return &_kernels_popcnt;
+#endif
+   return &_kernels_scalar;
+}
+
+// Selection is idempotent, so concurrent first calls may race harmlessly
+static const BitKernels * volatile _kernels = 0;
+
+const BitKernels * bitKernelsGet (void)
+{
+   const BitKernels *kernels = _kernels;
+
+   if (kernels == 0)
+   {
+      kernels = _selectKernels(_detectCpuFeatures());
+      _kernels = kernels;
+   }
+   return kernels;
+}
+
+const BitKernels * bitKernelsFind (const char *name)
+{
+   const BitKernels *all[4];
+   int count = 0, i;
+   int features = _detectCpuFeatures();
+
+   (void)features;
+   all[count++] = &_kernels_scalar;
+#if defined(BIT_KERNELS_X86_GNUC) || defined(BIT_KERNELS_X86_MSVC)
+   if (features & BIT_CPU_POPCNT)
+      all[count++] = &_kernels_popcnt;
+#endif
+#ifdef BIT_KERNELS_AVX2
+   if ((features & BIT_CPU_AVX2) && (features & BIT_CPU_POPCNT))
+      all[count++] = &_kernels_avx2;
+#endif
+#ifdef BIT_KERNELS_AVX512
+   if ((features & BIT_CPU_AVX512) && (features & BIT_CPU_POPCNT))
+      all[count++] = &_kernels_avx512;
+#endif
+
+   for (i = 0; i < count; i++)
+      if (strcmp(all[i]->name, name) == 0)
+         return all[i];
+
+   return 0;
+}
+
+void bitKernelsSet (const BitKernels *kernels)
+{
+   _kernels = kernels;
+}
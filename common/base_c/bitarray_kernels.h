@@ -0,0 +1,53 @@
+/****************************************************************************
+ * Copyright (C) 2009-2015 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#ifndef __bitarray_kernels_h__
+#define __bitarray_kernels_h__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "base_c/defs.h"
+
+// Population count kernels used by bitarray.c. One set of kernels is
+// selected at runtime according to the CPU features (scalar, POPCNT,
+// AVX2 or AVX-512 VPOPCNTDQ) and can be overriden with bitSetKernel().
+typedef struct tagBitKernels
+{
+   const char *name;
+   // popcount(a)
+   int (*ones) (const byte *a, int n_bytes);
+   // popcount(a & b)
+   int (*common) (const byte *a, const byte *b, int n_bytes);
+   // popcount(a & ~b)
+   int (*andnot) (const byte *a, const byte *b, int n_bytes);
+   // popcount(a ^ b)
+   int (*different) (const byte *a, const byte *b, int n_bytes);
+   // a &= b, returns popcount(a)
+   int (*and_ones) (byte *a, const byte *b, int n_bytes);
+} BitKernels;
+
+const BitKernels * bitKernelsGet (void);
+
+// Returns kernels by name or NULL if they are not supported by the CPU
+const BitKernels * bitKernelsFind (const char *name);
+
+void bitKernelsSet (const BitKernels *kernels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
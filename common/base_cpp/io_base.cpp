@@ -13,6 +13,8 @@
  ***************************************************************************/
 
 #include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include "base_cpp/io_base.h"
 
@@ -48,6 +50,28 @@ FILE *indigo::openFile( Encoding filename_encoding, const char *filename, const
    return file;
 }
 
+long long indigo::getFileModificationTime( Encoding filename_encoding, const char *filename )
+{
+   FILE *file = openFile(filename_encoding, filename, "rb");
+
+   if (file == 0)
+      return -1;
+
+#ifdef _WIN32
+   struct _stat64 st;
+   int res = _fstat64(_fileno(file), &st);
+#else
+   struct stat st;
+   int res = fstat(fileno(file), &st);
+#endif
+
+   fclose(file);
+
+   if (res != 0)
+      return -1;
+   return (long long)st.st_mtime;
+}
+
 #if defined(_WIN32) && !defined(__MINGW32__)
 CLocale CLocale::instance;
 
@@ -31,6 +31,10 @@ namespace indigo
 
    FILE *openFile( Encoding filename_encoding, const char *filename, const char *mode);
 
+   // Returns the modification time of the file in seconds since the epoch,
+   // or -1 if the file can't be opened
+   long long getFileModificationTime( Encoding filename_encoding, const char *filename);
+
 #if defined(_WIN32) && !defined(__MINGW32__)
    _locale_t getCLocale ();
 
@@ -104,6 +104,11 @@ public:
       return _pool.hasElement(idx);
    }
 
+   void reserve (int to_reserve)
+   {
+      _pool.reserve(to_reserve);
+   }
+
    const T & operator [] (int index) const
    {  
       return _pool[index];
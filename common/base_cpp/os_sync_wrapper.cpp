@@ -92,6 +92,11 @@ void OsMessageSystem::RecvMsg (int *message, void **result)
    _finishRecvSem.Post();
 }
 
+void OsMessageSystem::WaitSender ()
+{
+   OsLocker locker(_sendLock);
+}
+
 OsMessageSystem::OsMessageSystem() :
    _sendSem(0, 1), _finishRecvSem(0, 1)
 {
@@ -91,6 +91,8 @@ public:
 
    void SendMsg (int message, void *param = 0);
    void RecvMsg (int *message, void **result = 0);
+   // Blocks until a sender of the last received message leaves SendMsg
+   void WaitSender ();
 private:
 
    OsSemaphore _sendSem;
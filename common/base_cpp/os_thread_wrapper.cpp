@@ -88,6 +88,8 @@ void OsCommandDispatcher::_run (int nthreads)
 {
    _last_command_index = 0;
    _expected_command_index = 0;
+   // Dispatcher can be run several times
+   _storedResults.setOffset(0);
    _need_to_terminate = false;
    _exception_to_forward = NULL;
 
@@ -125,8 +127,15 @@ void OsCommandDispatcher::_mainLoop ()
          _onMsgHandleResult();
       if (msg == MSG_HANDLE_EXCEPTION)
          _onMsgHandleException((Exception *)parameter);
+      if (msg == MSG_TERMINATE)
+         // Thread doesn't access dispatcher after this message
+         _left_thread_count--;
    }
 
+   // Dispatcher can be destroyed right after the main loop,
+   // so the last thread should leave the message system
+   _baseMessageSystem.WaitSender();
+
    if (_exception_to_forward != NULL)
    {
       Exception *cur = _exception_to_forward;
@@ -179,7 +188,6 @@ void OsCommandDispatcher::_onMsgNeedTask()
    if (_need_to_terminate)
    {
       _privateMessageSystem.SendMsg(MSG_NO_TASK, NULL);
-      _left_thread_count--;
       return;
    }
 
@@ -192,7 +200,6 @@ void OsCommandDispatcher::_onMsgNeedTask()
       _availableCommands.add(command);
 
       _privateMessageSystem.SendMsg(MSG_NO_TASK, NULL);
-      _left_thread_count--;
       return;
    }
    _privateMessageSystem.SendMsg(MSG_RECV_INDEX, &_last_command_index);
@@ -403,6 +410,7 @@ void OsCommandDispatcher::_threadFunc (void)
    }
 
    _cleanupThread();
+   _baseMessageSystem.SendMsg(MSG_TERMINATE, NULL);
 
    TL_RELEASE_SESSION_ID(initial_SID);
 }
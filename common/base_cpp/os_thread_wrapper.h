@@ -62,7 +62,7 @@ public:
 
 class Exception;
 
-class OsCommandDispatcher
+class DLLEXPORT OsCommandDispatcher
 {
 public:
    enum { HANDLING_ORDER_ANY, HANDLING_ORDER_SERIAL };
@@ -140,6 +140,6 @@ private:
 
 }
 
-int osGetProcessorsCount (void);
+DLLEXPORT int osGetProcessorsCount (void);
 
 #endif // __cmd_thread_h__
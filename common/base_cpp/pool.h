@@ -117,6 +117,13 @@ public:
       _first = -1;
    }
 
+   // Reserves memory for to_reserve elements in total
+   void reserve (int to_reserve)
+   {
+      _array.reserve(to_reserve);
+      _next.reserve(to_reserve);
+   }
+
    const T & operator [] (int index) const
    {  
       if (_next[index] != -2)
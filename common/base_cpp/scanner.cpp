@@ -25,10 +25,35 @@
 
 #include <limits>
 
+#ifdef _WIN32
+   #include <windows.h>
+   #include <io.h>
+   #undef min
+   #undef max
+#else
+   #include <sys/mman.h>
+#endif
+
 using namespace indigo;
 
 enum { MAX_LINE_LENGTH = 1048576 };
 
+// Returns the length of the text before the first '\r' or '\n'
+static size_t _lineLength (const char *text, size_t size)
+{
+   const char *end = (const char *)memchr(text, '\n', size);
+
+   if (end != 0)
+      size = end - text;
+
+   end = (const char *)memchr(text, '\r', size);
+
+   if (end != 0)
+      size = end - text;
+
+   return size;
+}
+
 IMPL_ERROR(Scanner, "scanner");
 
 Scanner::~Scanner ()
@@ -506,9 +531,9 @@ bool Scanner::isSingleLine (Scanner &scanner)
 // FileScanner
 //
 
-FileScanner::FileScanner (Encoding filename_encoding, const char *filename)
+FileScanner::FileScanner (Encoding filename_encoding, const char *filename, int cache_size)
 {
-   _init(filename_encoding, filename);
+   _init(filename_encoding, filename, cache_size);
 }
 
 FileScanner::FileScanner (const char *format, ...)
@@ -521,10 +546,10 @@ FileScanner::FileScanner (const char *format, ...)
    vsnprintf(filename, sizeof(filename), format, args);
    va_end(args);
 
-   _init(ENCODING_ASCII, filename);
+   _init(ENCODING_ASCII, filename, DEFAULT_CACHE_SIZE);
 }
 
-void FileScanner::_init (Encoding filename_encoding, const char *filename)
+void FileScanner::_init (Encoding filename_encoding, const char *filename, int cache_size)
 {
    _file = 0;
    _file_len = 0LL;
@@ -532,6 +557,8 @@ void FileScanner::_init (Encoding filename_encoding, const char *filename)
    if (filename == 0)
       throw Error("null filename");
 
+   _cache.clear_resize(__max(cache_size, (int)DEFAULT_CACHE_SIZE));
+
    _file = openFile(filename_encoding, filename, "rb");
 
    if (_file == NULL)
@@ -569,7 +596,7 @@ void FileScanner::_validateCache ()
    if (_cache_pos < _max_cache)
       return;
 
-   size_t nread = fread(_cache, 1, NELEM(_cache), _file);
+   size_t nread = fread(_cache.ptr(), 1, _cache.size(), _file);
    _max_cache = static_cast<int>(nread);
    _cache_pos = 0;
 }
@@ -587,7 +614,7 @@ long long FileScanner::tell ()
 void FileScanner::read (int length, void *res)
 {
    int to_read_from_cache = __min(length, _max_cache - _cache_pos);
-   memcpy(res, _cache + _cache_pos, to_read_from_cache);
+   memcpy(res, _cache.ptr() + _cache_pos, to_read_from_cache);
    _cache_pos += to_read_from_cache;
 
    if (to_read_from_cache != length)
@@ -659,12 +686,256 @@ char FileScanner::readChar ()
    return _cache[_cache_pos++];
 }
 
+void FileScanner::appendLine (Array<char> &out, bool append_zero)
+{
+   if (isEOF())
+      throw Error("appendLine(): end of stream");
+
+   if (out.size() > 0)
+      while (out.top() == 0)
+         out.pop();
+
+   // Same as Scanner::appendLine, but the line is copied from the cache
+   // by chunks
+   while (true)
+   {
+      _validateCache();
+      if (_cache_pos == _max_cache)
+         break;
+
+      const char *chunk = (const char *)_cache.ptr() + _cache_pos;
+      int available = _max_cache - _cache_pos;
+      int len = (int)_lineLength(chunk, available);
+
+      out.concat(chunk, len);
+      _cache_pos += len;
+
+      if (out.size() > MAX_LINE_LENGTH)
+         throw Error("Line length is too long. Probably the file format is not correct.");
+
+      if (len < available)
+      {
+         if (_cache[_cache_pos++] == '\r' && lookNext() == '\n')
+            _cache_pos++;
+         break;
+      }
+   }
+
+   if (append_zero)
+      out.push(0);
+}
+
 FileScanner::~FileScanner ()
 {
    if (_file != NULL)
       fclose(_file);
 }
 
+//
+// MappedFileScanner
+//
+
+MappedFileScanner::MappedFileScanner (Encoding filename_encoding, const char *filename)
+{
+   _data = 0;
+   _size = 0LL;
+   _offset = 0LL;
+#ifdef _WIN32
+   _mapping = 0;
+#endif
+
+   if (filename == 0)
+      throw Error("null filename");
+
+   FILE *file = openFile(filename_encoding, filename, "rb");
+
+   if (file == NULL)
+      throw Error("can't open file %s. Error: %s", filename, strerror(errno));
+
+#ifdef _WIN32
+   _fseeki64(file, 0LL, SEEK_END);
+   _size = _ftelli64(file);
+#else
+   fseeko(file, 0LL, SEEK_END);
+   _size = ftello(file);
+#endif
+
+   if (_size <= 0LL)
+   {
+      // Nothing to map
+      _size = 0LL;
+      fclose(file);
+      return;
+   }
+
+   if ((unsigned long long)_size > (unsigned long long)std::numeric_limits<size_t>::max())
+   {
+      fclose(file);
+      throw Error("file %s is too large to be mapped", filename);
+   }
+
+#ifdef _WIN32
+   // The mapping object keeps the file open after fclose()
+   _mapping = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(file)), NULL, PAGE_READONLY, 0, 0, NULL);
+   fclose(file);
+
+   if (_mapping == NULL)
+      throw Error("can't map file %s. Error: %d", filename, (int)GetLastError());
+
+   _data = (const char *)MapViewOfFile((HANDLE)_mapping, FILE_MAP_READ, 0, 0, 0);
+
+   if (_data == NULL)
+   {
+      CloseHandle((HANDLE)_mapping);
+      throw Error("can't map file %s. Error: %d", filename, (int)GetLastError());
+   }
+#else
+   void *data = mmap(0, (size_t)_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+
+   fclose(file);
+
+   if (data == MAP_FAILED)
+      throw Error("can't map file %s. Error: %s", filename, strerror(errno));
+
+   // The file is read once from the beginning to the end in most cases
+   madvise(data, (size_t)_size, MADV_SEQUENTIAL);
+   _data = (const char *)data;
+#endif
+}
+
+MappedFileScanner::~MappedFileScanner ()
+{
+   if (_data == 0)
+      return;
+
+#ifdef _WIN32
+   UnmapViewOfFile(_data);
+   CloseHandle((HANDLE)_mapping);
+#else
+   munmap((void *)_data, (size_t)_size);
+#endif
+}
+
+void MappedFileScanner::read (int length, void *res)
+{
+   if (length < 0 || _offset + length > _size)
+      throw Error("MappedFileScanner::read() error");
+
+   memcpy(res, _data + _offset, length);
+   _offset += length;
+}
+
+bool MappedFileScanner::isEOF ()
+{
+   return _offset >= _size;
+}
+
+void MappedFileScanner::skip (int n)
+{
+   _offset += n;
+
+   if (_offset > _size)
+      throw Error("skip() passes after end of file");
+}
+
+int MappedFileScanner::lookNext ()
+{
+   if (_offset >= _size)
+      return -1;
+
+   return (unsigned char)_data[_offset];
+}
+
+void MappedFileScanner::seek (long long pos, int from)
+{
+   if (from == SEEK_SET)
+      _offset = pos;
+   else if (from == SEEK_CUR)
+      _offset += pos;
+   else // SEEK_END
+      _offset = _size - pos;
+
+   if (_offset < 0LL || _offset > _size)
+      throw Error("MappedFileScanner::seek() passes beyond the file");
+}
+
+long long MappedFileScanner::length ()
+{
+   return _size;
+}
+
+long long MappedFileScanner::tell ()
+{
+   return _offset;
+}
+
+byte MappedFileScanner::readByte ()
+{
+   if (_offset >= _size)
+      throw Error("readByte(): end of file");
+
+   return _data[_offset++];
+}
+
+char MappedFileScanner::readChar ()
+{
+   if (_offset >= _size)
+      throw Error("readChar() passes after end of file");
+
+   return _data[_offset++];
+}
+
+int MappedFileScanner::readLineView (const char *&line)
+{
+   if (_offset >= _size)
+      throw Error("readLineView(): end of stream");
+
+   line = _data + _offset;
+
+   size_t available = (size_t)(_size - _offset);
+   size_t len = _lineLength(line, available);
+
+   if (len > MAX_LINE_LENGTH)
+      throw Error("Line length is too long. Probably the file format is not correct.");
+
+   _offset += len;
+
+   if (len < available)
+   {
+      // "\r\n" is a single terminator
+      if (_data[_offset++] == '\r' && _offset < _size && _data[_offset] == '\n')
+         _offset++;
+   }
+
+   return (int)len;
+}
+
+void MappedFileScanner::appendLine (Array<char> &out, bool append_zero)
+{
+   if (isEOF())
+      throw Error("appendLine(): end of stream");
+
+   if (out.size() > 0)
+      while (out.top() == 0)
+         out.pop();
+
+   const char *line;
+   int len = readLineView(line);
+
+   if (out.size() + len > MAX_LINE_LENGTH)
+      throw Error("Line length is too long. Probably the file format is not correct.");
+
+   out.concat(line, len);
+
+   if (append_zero)
+      out.push(0);
+}
+
+const char * MappedFileScanner::curptr ()
+{
+   return _data + _offset;
+}
+
 //
 // BufferScanner
 //
@@ -44,7 +44,7 @@ public:
    void read (int length, Array<char> &buf);
 
    void readLine (Array<char> &out, bool append_zero);
-   void appendLine (Array<char> &out, bool append_zero);
+   virtual void appendLine (Array<char> &out, bool append_zero);
    bool skipLine ();
    
    virtual char readChar ();
@@ -86,7 +86,10 @@ protected:
 class DLLEXPORT FileScanner : public Scanner
 {
 public:
-   FileScanner (Encoding filename_encoding, const char *filename);
+   enum { DEFAULT_CACHE_SIZE = 1024 };
+
+   // cache_size is the read-ahead size in bytes
+   FileScanner (Encoding filename_encoding, const char *filename, int cache_size = DEFAULT_CACHE_SIZE);
    explicit FileScanner (const char *format, ...);
    virtual ~FileScanner ();
 
@@ -99,21 +102,62 @@ public:
    virtual long long tell ();
 
    virtual char readChar ();
+   virtual void appendLine (Array<char> &out, bool append_zero);
 private:
    FILE *_file;
    long long _file_len;
 
-   unsigned char _cache[1024];
+   Array<unsigned char> _cache;
    int _cache_pos, _max_cache;
 
    void _validateCache ();
    void _invalidateCache ();
-   void _init (Encoding filename_encoding, const char *filename);
+   void _init (Encoding filename_encoding, const char *filename, int cache_size);
 
    // no implicit copy
    FileScanner (const FileScanner &);
 };
 
+// Scanner over the whole file mapped into memory. Lines can be read
+// without copying them, and there are no system calls after opening.
+// The constructor throws if the file can't be mapped (for example, a file
+// larger than the address space), and FileScanner should be used then.
+class DLLEXPORT MappedFileScanner : public Scanner
+{
+public:
+   MappedFileScanner (Encoding filename_encoding, const char *filename);
+   virtual ~MappedFileScanner ();
+
+   virtual void read (int length, void *res);
+   virtual bool isEOF ();
+   virtual void skip (int n);
+   virtual int  lookNext ();
+   virtual void seek (long long pos, int from);
+   virtual long long length ();
+   virtual long long tell ();
+
+   virtual byte readByte ();
+   virtual char readChar ();
+   virtual void appendLine (Array<char> &out, bool append_zero);
+
+   // Sets line to the current line inside the mapped memory, moves to the
+   // next line and returns the line length without the line terminator
+   int readLineView (const char *&line);
+
+   const char * curptr ();
+private:
+   const char *_data;
+   long long _size;
+   long long _offset;
+
+#ifdef _WIN32
+   void *_mapping;
+#endif
+
+   // no implicit copy
+   MappedFileScanner (const MappedFileScanner &);
+};
+
 class DLLEXPORT BufferScanner : public Scanner
 {
 public:
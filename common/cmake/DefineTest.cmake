@@ -9,3 +9,16 @@ macro (DEFINE_TEST test files libs)
 	set_property(TARGET ${test} PROPERTY FOLDER "tests")
 	add_test(NAME ${test} COMMAND ${test})
 endmacro()
+
+macro (DEFINE_BENCHMARK bench files libs)
+	add_executable(${bench} ${files})
+	target_link_libraries(${bench} ${libs})
+
+	if(UNIX OR APPLE)
+		target_link_libraries(${bench} pthread)
+	endif()
+
+	# Static libraries require stdc++
+	set_target_properties(${bench} PROPERTIES LINKER_LANGUAGE CXX)
+	set_property(TARGET ${bench} PROPERTY FOLDER "benchmarks")
+endmacro()
@@ -14,18 +14,170 @@
 
 #include "gzip/gzip_output.h"
 
+#include "base_cpp/os_thread_wrapper.h"
+
 using namespace indigo;
 
 IMPL_ERROR(GZipOutput, "GZip output");
 
 CP_DEF(GZipOutput);
 
-GZipOutput::GZipOutput (Output &dest, int level) :
+// Empty BGZF member that marks the end of a BGZF file
+static const byte _bgzf_eof[] = {
+   0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x06, 0x00, 0x42, 0x43,
+   0x02, 0x00, 0x1b, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+//
+// Parallel compression of BGZF members
+//
+
+class _BgzfDeflateCommand : public OsCommand
+{
+public:
+   explicit _BgzfDeflateCommand (int level);
+   virtual ~_BgzfDeflateCommand ();
+
+   virtual void execute (OsCommandResult &result);
+
+   Array<char> block;
+
+private:
+   z_stream _zstream;
+};
+
+class _BgzfDeflateResult : public OsCommandResult
+{
+public:
+   Array<byte> member;
+};
+
+_BgzfDeflateCommand::_BgzfDeflateCommand (int level)
+{
+   _zstream.zalloc = Z_NULL;
+   _zstream.zfree = Z_NULL;
+   _zstream.opaque = Z_NULL;
+
+   // Raw deflate data, the header and the trailer of the member are written here
+   if (deflateInit2(&_zstream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+      throw GZipOutput::Error("can not initialize zlib");
+}
+
+_BgzfDeflateCommand::~_BgzfDeflateCommand ()
+{
+   deflateEnd(&_zstream);
+}
+
+static void _writeLE (byte *dest, dword value, int size)
+{
+   for (int i = 0; i < size; i++)
+      dest[i] = (byte)(value >> (8 * i));
+}
+
+void _BgzfDeflateCommand::execute (OsCommandResult &result)
+{
+   static const byte header[] = {
+      0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x06, 0x00, 'B', 'C', 0x02, 0x00
+   };
+   enum { HEADER_SIZE = 18, TRAILER_SIZE = 8, MAX_MEMBER_SIZE = 65536 };
+
+   Array<byte> &member = ((_BgzfDeflateResult &)result).member;
+
+   deflateReset(&_zstream);
+   member.clear_resize(HEADER_SIZE + deflateBound(&_zstream, block.size()) + TRAILER_SIZE);
+
+   _zstream.next_in = (Bytef *)block.ptr();
+   _zstream.avail_in = block.size();
+   _zstream.next_out = member.ptr() + HEADER_SIZE;
+   _zstream.avail_out = member.size() - HEADER_SIZE - TRAILER_SIZE;
+
+   if (deflate(&_zstream, Z_FINISH) != Z_STREAM_END)
+      throw GZipOutput::Error("unexpected zlib error");
+
+   int size = HEADER_SIZE + (int)_zstream.total_out + TRAILER_SIZE;
+
+   // A block of BLOCK_SIZE bytes always fits, but check it
+   if (size > MAX_MEMBER_SIZE)
+      throw GZipOutput::Error("BGZF member is too large: %d bytes", size);
+
+   memcpy(member.ptr(), header, sizeof(header));
+   _writeLE(member.ptr() + 16, size - 1, 2);
+   _writeLE(member.ptr() + size - 8, crc32(crc32(0, Z_NULL, 0), (Bytef *)block.ptr(), block.size()), 4);
+   _writeLE(member.ptr() + size - 4, block.size(), 4);
+   member.resize(size);
+}
+
+class _BgzfDeflateDispatcher : public OsCommandDispatcher
+{
+public:
+   _BgzfDeflateDispatcher (Output &dest, ObjArray< Array<char> > &blocks, int count, int level) :
+      OsCommandDispatcher(HANDLING_ORDER_SERIAL, false), _dest(dest), _blocks(blocks)
+   {
+      _count = count;
+      _level = level;
+      _next = 0;
+      written = 0;
+   }
+
+   long long written;
+
+protected:
+   virtual OsCommand * _allocateCommand ()
+   {
+      return new _BgzfDeflateCommand(_level);
+   }
+
+   virtual OsCommandResult * _allocateResult ()
+   {
+      return new _BgzfDeflateResult();
+   }
+
+   virtual bool _setupCommand (OsCommand &command)
+   {
+      if (_next == _count)
+         return false;
+
+      ((_BgzfDeflateCommand &)command).block.swap(_blocks[_next++]);
+      return true;
+   }
+
+   virtual void _handleResult (OsCommandResult &result)
+   {
+      Array<byte> &member = ((_BgzfDeflateResult &)result).member;
+
+      _dest.write(member.ptr(), member.size());
+      written += member.size();
+   }
+
+private:
+   Output &_dest;
+   ObjArray< Array<char> > &_blocks;
+   int _count;
+   int _level;
+   int _next;
+};
+
+//
+// GZipOutput
+//
+
+GZipOutput::GZipOutput (Output &dest, int level, int threads) :
 _dest(dest),
 CP_INIT,
 TL_CP_GET(_outbuf),
 TL_CP_GET(_inbuf)
 {
+   _total_written = 0;
+   _level = level;
+   _threads = threads;
+   _closed = false;
+   _blocks_count = 0;
+   _outbuf.clear();
+   _inbuf.clear();
+
+   if (_threads > 0)
+      return;
+
    _zstream.zalloc = Z_NULL;
    _zstream.zfree = Z_NULL;
    _zstream.opaque = Z_NULL;
@@ -45,20 +197,45 @@ TL_CP_GET(_inbuf)
 
    _outbuf.clear_resize(CHUNK_SIZE);
    _inbuf.clear_resize(CHUNK_SIZE);
-   _total_written = 0;
 }
 
 GZipOutput::~GZipOutput ()
 {
+   try
+   {
+      close();
+   }
+   catch (Exception &)
+   {
+      // Destructor can't report the error
+   }
+
+   if (_threads == 0)
+      deflateEnd(&_zstream);
+}
+
+void GZipOutput::close ()
+{
+   if (_closed)
+      return;
+   _closed = true;
+
+   if (_threads > 0)
+   {
+      if (_blocks_count < _blocks.size() && _blocks[_blocks_count].size() > 0)
+         _blocks_count++;
+      _compressBlocks();
+
+      _dest.write(_bgzf_eof, sizeof(_bgzf_eof));
+      _total_written += sizeof(_bgzf_eof);
+      return;
+   }
+
    _zstream.avail_in = 0;
    _zstream.next_in = Z_NULL;
-   
-   int rc = _deflate(Z_FINISH);
 
-   if (rc != Z_STREAM_END)
-      return;//throw Error("unexpected zlib error (%d)", rc);
-   
-   deflateEnd(&_zstream);
+   while (_deflate(Z_FINISH) != Z_STREAM_END)
+      ;
 }
 
 void GZipOutput::write (const void *data, int size)
@@ -66,6 +243,31 @@ void GZipOutput::write (const void *data, int size)
    if (size < 1)
       return;
 
+   if (_closed)
+      throw Error("output is closed");
+
+   if (_threads > 0)
+   {
+      const char *chars = (const char *)data;
+
+      while (size > 0)
+      {
+         if (_blocks_count == _blocks.size())
+            _blocks.push();
+
+         Array<char> &block = _blocks[_blocks_count];
+         int n = __min(size, BLOCK_SIZE - block.size());
+
+         block.concat(chars, n);
+         chars += n;
+         size -= n;
+
+         if (block.size() == BLOCK_SIZE && ++_blocks_count == _threads * 4)
+            _compressBlocks();
+      }
+      return;
+   }
+
    _zstream.avail_in = size;
    _zstream.next_in = (Bytef *)data;
 
@@ -78,11 +280,41 @@ void GZipOutput::write (const void *data, int size)
       throw Error("some data left uncompressed unexpectedly");
 }
 
+void GZipOutput::_compressBlocks ()
+{
+   if (_blocks_count == 0)
+      return;
+
+   _BgzfDeflateDispatcher dispatcher(_dest, _blocks, _blocks_count, _level);
+
+   dispatcher.run(__min(_threads, _blocks_count));
+   _total_written += dispatcher.written;
+
+   // The blocks are swapped with the buffers of the commands
+   for (int i = 0; i < _blocks_count; i++)
+      _blocks[i].clear();
+
+   // Move the partially filled block to the beginning
+   if (_blocks_count < _blocks.size())
+      _blocks[0].swap(_blocks[_blocks_count]);
+   _blocks_count = 0;
+}
+
 void GZipOutput::flush ()
 {
-   _zstream.avail_in = 0;
-   _zstream.next_in = Z_NULL;
-   _deflate(Z_FULL_FLUSH);
+   if (!_closed && _threads > 0)
+   {
+      // Pending blocks, including the partially filled one, become members
+      if (_blocks_count < _blocks.size() && _blocks[_blocks_count].size() > 0)
+         _blocks_count++;
+      _compressBlocks();
+   }
+   else if (!_closed)
+   {
+      _zstream.avail_in = 0;
+      _zstream.next_in = Z_NULL;
+      _deflate(Z_FULL_FLUSH);
+   }
    _dest.flush();
 }
 
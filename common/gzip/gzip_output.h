@@ -16,18 +16,27 @@
 #define __gzip_output__
 
 #include "base_cpp/output.h"
+#include "base_cpp/obj_array.h"
 #include "base_cpp/tlscont.h"
 
 #include <zlib.h>
 
 namespace indigo {
 
+// Writes gzip data.
+//
+// With threads > 0 the data is split into blocks that are compressed into
+// independent BGZF members in parallel batches on the given number of
+// threads. The result is a valid gzip file that GZipScanner inflates in
+// parallel too. The pending blocks are compressed when a batch is full,
+// on flush() and when the output is closed, so frequent flushes produce
+// small members.
 class GZipOutput : public Output
 {
 public:
-   enum { CHUNK_SIZE = 32768 };
+   enum { CHUNK_SIZE = 32768, BLOCK_SIZE = 0xff00 };
 
-   explicit GZipOutput (Output &dest, int level);
+   explicit GZipOutput (Output &dest, int level, int threads = 0);
    virtual ~GZipOutput ();
 
    virtual void write (const void *data, int size);
@@ -35,18 +44,30 @@ public:
    virtual long long tell  ();
    virtual void flush ();
 
+   // Finishes the gzip stream. Called by the destructor if not called before.
+   void close ();
+
    DECL_ERROR;
    
 protected:
    Output  &_dest;
    z_stream _zstream;
-   int _total_written;
+   long long _total_written;
+   int  _level;
+   int  _threads;
+   bool _closed;
 
    int _deflate (int flush);
 
    CP_DECL;
    TL_CP_DECL(Array<Bytef>, _outbuf);
    TL_CP_DECL(Array<Bytef>, _inbuf);
+
+   // Blocks waiting for compression if threads > 0
+   ObjArray< Array<char> > _blocks;
+   int _blocks_count;
+
+   void _compressBlocks ();
 };
 
 }
@@ -14,201 +14,659 @@
 
 #include "gzip/gzip_scanner.h"
 
+#include "base_c/os_thread.h"
+#include "base_cpp/obj_array.h"
+#include "base_cpp/os_thread_wrapper.h"
+#include "base_cpp/tlscont.h"
+
 using namespace indigo;
 
 IMPL_ERROR(GZipScanner, "GZip scanner");
 
-CP_DEF(GZipScanner);
+// The same limit as in Scanner::appendLine()
+enum { MAX_LINE_LENGTH = 1048576 };
 
-GZipScanner::GZipScanner (Scanner &source) :
-_source(source),
-CP_INIT,
-TL_CP_GET(_inbuf),
-TL_CP_GET(_outbuf)
+static void _checkInflateResult (int rc)
 {
-   _zstream.zalloc = Z_NULL;
-   _zstream.zfree = Z_NULL;
-   _zstream.opaque = Z_NULL;
-   _zstream.avail_in = 0;
-   _zstream.next_in = Z_NULL;
+   if (rc == Z_STREAM_ERROR)
+      throw GZipScanner::Error("inconsistent stream structure");
+   if (rc == Z_NEED_DICT)
+      throw GZipScanner::Error("need a dictionary");
+   if (rc == Z_MEM_ERROR)
+      throw GZipScanner::Error("not enough memory");
+   if (rc == Z_DATA_ERROR)
+      throw GZipScanner::Error("corrupted input data");
+   if (rc == Z_BUF_ERROR)
+      throw GZipScanner::Error("unexpected end of compressed data");
+   if (rc != Z_OK && rc != Z_STREAM_END)
+      throw GZipScanner::Error("unknown zlib error code: %d", rc);
+}
 
-   int rc = inflateInit2(&_zstream, 16 + MAX_WBITS);
+static void _initInflate (z_stream &zstream)
+{
+   zstream.zalloc = Z_NULL;
+   zstream.zfree = Z_NULL;
+   zstream.opaque = Z_NULL;
+   zstream.avail_in = 0;
+   zstream.next_in = Z_NULL;
+
+   int rc = inflateInit2(&zstream, 16 + MAX_WBITS);
 
    if (rc == Z_VERSION_ERROR)
-      throw Error("zlib version incompatible");
+      throw GZipScanner::Error("zlib version incompatible");
    if (rc == Z_MEM_ERROR)
-      throw Error("not enough memory for zlib");
+      throw GZipScanner::Error("not enough memory for zlib");
    if (rc != Z_OK)
-      throw Error("unknown zlib error code: %d", rc);
+      throw GZipScanner::Error("unknown zlib error code: %d", rc);
+}
 
-   _outbuf.clear_resize(CHUNK_SIZE);
-   _inbuf.clear_resize(CHUNK_SIZE);
-   _outbuf_start = 0;
-   _inbuf_end = 0;
-   _uncompressed_total = 0;
-   _eof = false;
+//
+// Inflater
+//
 
-   _zstream.avail_out = _outbuf.size();
-   _zstream.next_out = _outbuf.ptr();
-}
+// Inflates gzip members from the source block by block. The source is
+// positioned right after the last inflated member between the members.
+class GZipScanner::Inflater
+{
+public:
+   explicit Inflater (Scanner &source) : _source(source)
+   {
+      _initInflate(_zstream);
+      _source_end = _source.length();
+      _inbuf.clear_resize(CHUNK_SIZE);
+      _in_member = false;
+      _members = 0;
+   }
 
-GZipScanner::~GZipScanner ()
+   ~Inflater ()
+   {
+      inflateEnd(&_zstream);
+   }
+
+   // Inflates the next block. Returns false if there is no more data.
+   bool inflateBlock (Array<char> &block)
+   {
+      block.clear_resize(CHUNK_SIZE);
+      _zstream.next_out = (Bytef *)block.ptr();
+      _zstream.avail_out = block.size();
+
+      while (_zstream.avail_out > 0)
+      {
+         if (!_in_member)
+         {
+            if (atEnd())
+               break;
+            if (_members++ > 0)
+               inflateReset(&_zstream);
+            _in_member = true;
+         }
+
+         if (_zstream.avail_in == 0)
+         {
+            long long left = _source_end - _source.tell();
+
+            if (left <= 0)
+               throw Error("end of file in source stream");
+
+            int n = (int)__min(left, (long long)_inbuf.size());
+
+            _source.read(n, _inbuf.ptr());
+            _zstream.next_in = _inbuf.ptr();
+            _zstream.avail_in = n;
+         }
+
+         int rc = inflate(&_zstream, Z_NO_FLUSH);
+
+         _checkInflateResult(rc);
+
+         if (rc == Z_STREAM_END)
+         {
+            // Return the data after the member to the source
+            if (_zstream.avail_in > 0)
+               _source.seek(_source.tell() - _zstream.avail_in, SEEK_SET);
+            _zstream.avail_in = 0;
+            _in_member = false;
+         }
+      }
+
+      block.resize(block.size() - _zstream.avail_out);
+      return block.size() > 0;
+   }
+
+   // True if the source is between the members
+   bool atMemberStart ()
+   {
+      return !_in_member;
+   }
+
+   // True if there are no more members. Like gzip, data other than a gzip
+   // member after the first member is ignored.
+   bool atEnd ()
+   {
+      if (_in_member)
+         return false;
+
+      long long pos = _source.tell();
+
+      if (pos >= _source_end)
+         return true;
+      if (_members == 0 || pos + 2 > _source_end)
+         return _members > 0;
+
+      byte id[2];
+
+      _source.read(2, id);
+      _source.seek(pos, SEEK_SET);
+      return id[0] != 0x1f || id[1] != 0x8b;
+   }
+
+   long long sourceEnd ()
+   {
+      return _source_end;
+   }
+
+   void memberRead ()
+   {
+      _members++;
+   }
+
+private:
+   Scanner  &_source;
+   long long _source_end;
+   z_stream  _zstream;
+   Array<Bytef> _inbuf;
+   bool _in_member;
+   int  _members;
+};
+
+//
+// Parallel inflating of BGZF members
+//
+
+class _BgzfInflateCommand : public OsCommand
+{
+public:
+   virtual void execute (OsCommandResult &result);
+
+   Array<byte> member;
+};
+
+class _BgzfInflateResult : public OsCommandResult
 {
-   inflateEnd(&_zstream);
+public:
+   Array<char> data;
+};
+
+void _BgzfInflateCommand::execute (OsCommandResult &result)
+{
+   Array<char> &data = ((_BgzfInflateResult &)result).data;
+   int n = member.size();
+
+   // ISIZE field of the trailer is the size of the uncompressed data
+   dword isize = member[n - 4] | (member[n - 3] << 8) | (member[n - 2] << 16) | ((dword)member[n - 1] << 24);
+
+   if (isize > 65536)
+      throw GZipScanner::Error("BGZF member is too large: %u bytes", isize);
+   // One more byte keeps the output pointer valid for empty members
+   data.clear_resize(isize + 1);
+
+   z_stream zstream;
+
+   _initInflate(zstream);
+   zstream.next_in = member.ptr();
+   zstream.avail_in = n;
+   zstream.next_out = (Bytef *)data.ptr();
+   zstream.avail_out = isize;
+
+   int rc = inflate(&zstream, Z_FINISH);
+
+   inflateEnd(&zstream);
+   _checkInflateResult(rc);
+   if (rc != Z_STREAM_END || zstream.avail_in != 0 || zstream.avail_out != 0)
+      throw GZipScanner::Error("corrupted BGZF member");
+   data.resize(isize);
 }
 
-void GZipScanner::read (int length, void *res)
+class _BgzfInflateDispatcher : public OsCommandDispatcher
 {
-   if (res == 0)
-      throw Error("zero pointer given");
+public:
+   _BgzfInflateDispatcher (GZipScanner::Producer &producer, ObjArray< Array<byte> > &members) :
+      OsCommandDispatcher(HANDLING_ORDER_SERIAL, false), _producer(producer), _members(members)
+   {
+      _next = 0;
+   }
 
-   if (_outbuf_start < _outbuf.size() - (int)_zstream.avail_out)
+protected:
+   virtual OsCommand * _allocateCommand ()
    {
-      int n = __min(length, CHUNK_SIZE - (int)_zstream.avail_out - _outbuf_start);
+      return new _BgzfInflateCommand();
+   }
 
-      memcpy(res, _outbuf.ptr() + _outbuf_start, n);
-      _outbuf_start += n;
-      _uncompressed_total += n;
-      length -= n;
-      res = (char *)res + n;
+   virtual OsCommandResult * _allocateResult ()
+   {
+      return new _BgzfInflateResult();
    }
 
-   if (!_read(length, res))
-      throw Error("end of compressed data");
-}
+   virtual bool _setupCommand (OsCommand &command)
+   {
+      if (_next == _members.size())
+         return false;
 
-bool GZipScanner::_read (int length, void *res)
+      ((_BgzfInflateCommand &)command).member.swap(_members[_next++]);
+      return true;
+   }
+
+   virtual void _handleResult (OsCommandResult &result);
+
+private:
+   GZipScanner::Producer &_producer;
+   ObjArray< Array<byte> > &_members;
+   int _next;
+};
+
+//
+// Producer
+//
+
+extern "C" THREAD_RET THREAD_MOD _gzipProducerThreadFunc (void *param);
+
+// Inflates the data on a background thread into a bounded queue of blocks
+class GZipScanner::Producer
 {
-   while (length > 0)
+public:
+   Producer (Scanner &source, int threads) :
+      _inflater(source), _source(source),
+      _free_slots(QUEUE_SIZE, QUEUE_SIZE + 1), _filled_slots(0, QUEUE_SIZE + 1), _exited(0, 1)
    {
-      if (_eof)
-         return false;
+      _threads = threads;
+      for (int i = 0; i < QUEUE_SIZE; i++)
+         _queue.push();
+      _head = 0;
+      _count = 0;
+      _stop = false;
+      _done = false;
+
+      osThreadCreate(_gzipProducerThreadFunc, this);
+   }
 
-      if (_zstream.avail_in == 0)
-      {
-         _inbuf_end = 0;
+   ~Producer ()
+   {
+      _stop = true;
+      _free_slots.Post();
+      _exited.Wait();
+      // The thread leaves the lock right after posting the semaphore
+      OsLocker locker(_lock);
+   }
 
-         if (_source.isEOF())
-            throw Error("end of file in source stream");
+   // Takes the next block. Returns false if there is no more data.
+   bool pop (Array<char> &block)
+   {
+      _filled_slots.Wait();
 
-         do
-         {
-            _inbuf[_inbuf_end++] = _source.readChar();
-         } while (!_source.isEOF() && _inbuf_end < _inbuf.size());
-         _zstream.avail_in = _inbuf_end;
-         _zstream.next_in = _inbuf.ptr();
+      OsLocker locker(_lock);
+
+      if (_count == 0)
+      {
+         // The end of the data is signaled once, keep it signaled
+         _filled_slots.Post();
+         if (_error.get() != 0)
+            _error->throwSelf();
+         return false;
       }
 
-      _zstream.avail_out = _outbuf.size();
-      _zstream.next_out = _outbuf.ptr();
-      _outbuf_start = 0;
+      block.swap(_queue[_head]);
+      _head = (_head + 1) % QUEUE_SIZE;
+      _count--;
+      _free_slots.Post();
+      return true;
+   }
+
+   // Puts the block into the queue. Returns false if the producer is stopped.
+   bool push (Array<char> &block)
+   {
+      _free_slots.Wait();
+      if (_stop)
+         return false;
+
+      OsLocker locker(_lock);
 
-      int rc = inflate(&_zstream, Z_NO_FLUSH);
+      _queue[(_head + _count) % QUEUE_SIZE].swap(block);
+      _count++;
+      _filled_slots.Post();
+      return true;
+   }
 
-      if (rc == Z_STREAM_ERROR)
-         throw Error("inconsistent stream structure");
+   void threadFunc ()
+   {
+      qword initial_SID = TL_GET_SESSION_ID();
+      Exception *error = 0;
 
-      if (rc == Z_NEED_DICT)
+      try
       {
-         inflateEnd(&_zstream);
-         throw Error("need a dictionary");
+         _produce();
       }
-
-      if (rc == Z_MEM_ERROR)
+      catch (Exception &e)
       {
-         inflateEnd(&_zstream);
-         throw Error("not enough memory");
+         error = e.clone();
       }
-
-      if (rc == Z_DATA_ERROR)
+      catch (...)
       {
-         inflateEnd(&_zstream);
-         throw Error("corrupted input data");
+         error = Exception("Unknown exception").clone();
       }
 
-      if (rc == Z_BUF_ERROR)
-         throw Error("Z_BUF_ERROR (workaround not implemented)");
+      TL_RELEASE_SESSION_ID(initial_SID);
 
-      if (rc != Z_OK && rc != Z_STREAM_END)
-         throw Error("unknown zlib error code: %d", rc);
+      OsLocker locker(_lock);
 
-      int n = __min(length, CHUNK_SIZE - (int)_zstream.avail_out - _outbuf_start);
+      _error.reset(error);
+      _done = true;
+      _filled_slots.Post();
+      _exited.Post();
+   }
+
+private:
+   Inflater _inflater;
+   Scanner &_source;
+   int _threads;
+
+   ObjArray< Array<char> > _queue;
+   int _head;
+   int _count;
+
+   OsLock _lock;
+   OsSemaphore _free_slots;
+   OsSemaphore _filled_slots;
+   OsSemaphore _exited;
+
+   volatile bool _stop;
+   bool _done;
+   AutoPtr<Exception> _error;
+
+   void _produce ()
+   {
+      Array<char> block;
+      ObjArray< Array<byte> > members;
 
-      if (n > 0 && res != 0)
+      while (!_stop)
       {
-         memcpy(res, _outbuf.ptr(), n);
-         _outbuf_start += n;
-         _uncompressed_total += n;
-         res = (char *)res + n;
+         if (_threads > 1 && _inflater.atMemberStart() && _readBgzfMembers(members))
+         {
+            _BgzfInflateDispatcher dispatcher(*this, members);
+
+            dispatcher.run(__min(_threads, members.size()));
+            continue;
+         }
+
+         if (!_inflater.inflateBlock(block))
+            break;
+         if (!push(block))
+            break;
+      }
+   }
+
+   // Reads a batch of consecutive BGZF members
+   bool _readBgzfMembers (ObjArray< Array<byte> > &members)
+   {
+      members.clear();
+
+      while (members.size() < _threads * 4 && !_inflater.atEnd())
+      {
+         int size = readBgzfMemberSize(_source);
+
+         if (size < 0 || _source.tell() + size > _inflater.sourceEnd())
+            break;
+
+         Array<byte> &member = members.push();
+
+         member.clear_resize(size);
+         _source.read(size, member.ptr());
+         _inflater.memberRead();
       }
 
+      return members.size() > 0;
+   }
+};
+
+extern "C" THREAD_RET THREAD_MOD _gzipProducerThreadFunc (void *param)
+{
+   ((GZipScanner::Producer *)param)->threadFunc();
+   THREAD_END;
+}
+
+void _BgzfInflateDispatcher::_handleResult (OsCommandResult &result)
+{
+   Array<char> &data = ((_BgzfInflateResult &)result).data;
+
+   // Empty members, e.g. the BGZF end-of-file marker, are skipped
+   if (data.size() > 0 && !_producer.push(data))
+      markToTerminate();
+}
+
+//
+// GZipScanner
+//
+
+GZipScanner::GZipScanner (Scanner &source, int threads) :
+_source(source)
+{
+   _source_start = source.tell();
+   _threads = threads;
+   _start();
+}
+
+GZipScanner::~GZipScanner ()
+{
+}
+
+void GZipScanner::_start ()
+{
+   _block.clear();
+   _block_pos = 0;
+   _block_offset = 0;
+   _eof = false;
+
+   if (_threads > 0)
+      _producer.reset(new Producer(_source, _threads));
+   else
+      _inflater.reset(new Inflater(_source));
+}
+
+bool GZipScanner::_nextBlock ()
+{
+   if (_eof)
+      return false;
+
+   _block_offset += _block.size();
+   _block_pos = 0;
+
+   bool has_block;
+
+   if (_producer.get() != 0)
+      has_block = _producer->pop(_block);
+   else
+      has_block = _inflater->inflateBlock(_block);
+
+   if (!has_block)
+   {
+      _block.clear();
+      _eof = true;
+   }
+   return has_block;
+}
+
+void GZipScanner::read (int length, void *res)
+{
+   if (res == 0)
+      throw Error("zero pointer given");
+
+   while (length > 0)
+   {
+      if (_block_pos == _block.size() && !_nextBlock())
+         throw Error("end of compressed data");
+
+      int n = __min(length, _block.size() - _block_pos);
+
+      memcpy(res, _block.ptr() + _block_pos, n);
+      _block_pos += n;
       length -= n;
-      
-      if (rc == Z_STREAM_END)
-         _eof = true;
+      res = (char *)res + n;
    }
-   
-   return true;
 }
 
 void GZipScanner::readAll (Array<char> &arr)
 {
    arr.clear();
 
-   while (!isEOF())
-      arr.push(readByte());
+   while (_block_pos < _block.size() || _nextBlock())
+   {
+      arr.concat(_block.ptr() + _block_pos, _block.size() - _block_pos);
+      _block_pos = _block.size();
+   }
 }
 
+void GZipScanner::appendLine (Array<char> &out, bool append_zero)
+{
+   if (isEOF())
+      throw Error("appendLine(): end of stream");
+
+   if (out.size() > 0)
+      while (out.top() == 0)
+         out.pop();
+
+   while (_block_pos < _block.size() || _nextBlock())
+   {
+      const char *start = _block.ptr() + _block_pos;
+      int left = _block.size() - _block_pos;
+      int n = 0;
+
+      while (n < left && start[n] != '\n' && start[n] != '\r')
+         n++;
+
+      if (out.size() + n > MAX_LINE_LENGTH)
+         throw Error("Line length is too long. Probably the file format is not correct.");
+
+      out.concat(start, n);
+      _block_pos += n;
+
+      if (n < left)
+      {
+         if (_block[_block_pos++] == '\r' && lookNext() == '\n')
+            _block_pos++;
+         break;
+      }
+   }
+
+   if (append_zero)
+      out.push(0);
+}
 
 void GZipScanner::skip (int length)
 {
-   QS_DEF(Array<char>, dummy);
+   _skip(length);
+}
+
+void GZipScanner::_skip (long long length)
+{
+   while (length > 0)
+   {
+      if (_block_pos == _block.size() && !_nextBlock())
+         throw Error("end of compressed data");
 
-   dummy.clear_resize(length);
-   read(length, dummy.ptr());
+      int n = (int)__min(length, (long long)(_block.size() - _block_pos));
+
+      _block_pos += n;
+      length -= n;
+   }
 }
 
 long long GZipScanner::tell ()
 {
-   return _uncompressed_total;
+   return _block_offset + _block_pos;
 }
 
 bool GZipScanner::isEOF ()
 {
-   if ((unsigned)_outbuf_start + _zstream.avail_out == (unsigned)_outbuf.size())
+   return _block_pos == _block.size() && !_nextBlock();
+}
+
+void GZipScanner::seek (long long pos, int from)
+{
+   if (from == SEEK_CUR)
+      pos += tell();
+   else if (from != SEEK_SET)
+      throw Error("seek from the end is not supported");
+
+   if (pos < 0)
+      throw Error("seek to a negative position");
+
+   if (pos < _block_offset)
    {
-      if (_eof)
-         return true;
-      _read(1, 0);
+      // Inflate again from the beginning
+      _producer.reset(0);
+      _inflater.reset(0);
+      _source.seek(_source_start, SEEK_SET);
+      _start();
    }
-   return _eof && (unsigned)_outbuf_start + _zstream.avail_out == (unsigned)_outbuf.size();
+
+   if (pos < tell())
+      _block_pos = (int)(pos - _block_offset);
+   else
+      _skip(pos - tell());
 }
 
-void GZipScanner::seek (long long pos, int from)
+int GZipScanner::lookNext ()
+{
+   if (_block_pos == _block.size() && !_nextBlock())
+      return -1;
+
+   return (byte)_block[_block_pos];
+}
+
+long long GZipScanner::length ()
 {
    throw Error("not implemented");
 }
 
-int GZipScanner::lookNext ()
+int GZipScanner::readBgzfMemberSize (Scanner &scanner)
 {
-   if (_outbuf_start < _outbuf.size() - (int)_zstream.avail_out)
-      return _outbuf[_outbuf_start];
+   // Gzip header with FEXTRA flag (12 bytes) and the subfields
+   byte header[12];
+   long long pos = scanner.tell();
+   int size = -1;
 
-   if (_eof)
+   if (scanner.length() - pos < 18)
       return -1;
 
-   _read(1, 0);
+   scanner.read(12, header);
 
-   if (_eof)
-      return -1;
+   if (header[0] == 0x1f && header[1] == 0x8b && header[2] == 8 && (header[3] & 4) != 0)
+   {
+      int xlen = header[10] | (header[11] << 8);
+      QS_DEF(Array<byte>, extra);
 
-   if (_outbuf_start < _outbuf.size() - (int)_zstream.avail_out)
-      return _outbuf[_outbuf_start];
+      if (scanner.length() - scanner.tell() >= xlen)
+      {
+         extra.clear_resize(xlen);
+         scanner.read(xlen, extra.ptr());
 
-   throw Error("internal");
-}
+         // "BC" subfield with the total member size minus 1
+         for (int i = 0; i + 4 <= xlen; )
+         {
+            int slen = extra[i + 2] | (extra[i + 3] << 8);
+
+            if (extra[i] == 'B' && extra[i + 1] == 'C' && slen == 2 && i + 6 <= xlen)
+            {
+               size = (extra[i + 4] | (extra[i + 5] << 8)) + 1;
+               // The member should have room for the header and the trailer
+               if (size < 12 + xlen + 8)
+                  size = -1;
+               break;
+            }
+            i += 4 + slen;
+         }
+      }
+   }
 
-long long GZipScanner::length ()
-{
-   throw Error("not implemented");
+   scanner.seek(pos, SEEK_SET);
+   return size;
 }
@@ -16,18 +16,26 @@
 #define __gzip_scanner__
 
 #include "base_cpp/scanner.h"
-#include "base_cpp/tlscont.h"
+#include "base_cpp/auto_ptr.h"
 
 #include <zlib.h>
 
 namespace indigo {
 
+// Reads gzip data. Concatenated gzip members are read as a single stream.
+//
+// With threads > 0 the data is inflated on a background thread into a
+// bounded queue of blocks ahead of the reader. BGZF members (e.g. written by
+// GZipOutput with threads) are inflated in parallel batches on the given
+// number of threads, other members are inflated sequentially.
+//
+// Seeking backward restarts inflating from the beginning of the source.
 class GZipScanner : public Scanner
 {
 public:
-   enum { CHUNK_SIZE = 32768 };
+   enum { CHUNK_SIZE = 65536, QUEUE_SIZE = 16 };
 
-   explicit GZipScanner (Scanner &source);
+   explicit GZipScanner (Scanner &source, int threads = 0);
    virtual ~GZipScanner ();
 
    virtual void read  (int length, void *res);
@@ -38,21 +46,34 @@ public:
    virtual void skip (int length);
    virtual long long length ();
    virtual void readAll (Array<char> &arr);
+   virtual void appendLine (Array<char> &out, bool append_zero);
+
+   // Returns the size of the BGZF member at the current position of the
+   // scanner or -1 if there is no BGZF member. The position is not changed.
+   static int readBgzfMemberSize (Scanner &scanner);
 
    DECL_ERROR;
+
+   class Inflater;
+   class Producer;
+
 protected:
    Scanner  &_source;
-   z_stream  _zstream;
-
-   bool _read (int length, void *res);
-   
-   CP_DECL;
-   TL_CP_DECL(Array<Bytef>, _inbuf);
-   TL_CP_DECL(Array<Bytef>, _outbuf);
-   int  _outbuf_start;
-   int  _inbuf_end;
-   int  _uncompressed_total;
-   bool _eof;
+   long long _source_start;
+   int       _threads;
+
+   AutoPtr<Inflater> _inflater;
+   AutoPtr<Producer> _producer;
+
+   // Current block of the uncompressed data
+   Array<char> _block;
+   int       _block_pos;
+   long long _block_offset;
+   bool      _eof;
+
+   void _start ();
+   bool _nextBlock ();
+   void _skip (long long length);
 };
 
 }
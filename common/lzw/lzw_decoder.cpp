@@ -61,6 +61,46 @@ int LzwDecoder::get( void )
    return NextCode;
 }
 
+void LzwDecoder::decode( LzwDict &Dict, const byte *Data, int Size, Array<byte> &Output )
+{
+   const byte *End = Data + Size;
+   int Bits = Dict.getBitCodeSize();
+   int AlphabetSize = Dict.getAlphabetSize();
+   dword Mask = (1U << Bits) - 1;
+   dword BitBuffer = 0;
+   int BitCount = 0;
+
+   Output.clear();
+
+   /* Codes are stored from the most significant bit, the bits
+    * after the last whole code are padding, as in BitInWorker */
+   while (true)
+   {
+      while (BitCount < Bits && Data < End)
+      {
+         BitBuffer = (BitBuffer << 8) | *Data++;
+         BitCount += 8;
+      }
+
+      if (BitCount < Bits)
+         break;
+
+      BitCount -= Bits;
+
+      int Code = (BitBuffer >> BitCount) & Mask;
+
+      if (Code <= AlphabetSize)
+         Output.push((byte)Code);
+      else
+      {
+         int Length;
+         const byte *String = Dict.getString(Code, Length);
+
+         Output.concat(String, Length);
+      }
+   }
+}
+
 //
 // LzwScanner
 //
@@ -37,6 +37,10 @@ public:
 
    int get( void );
 
+   /* Decode the whole input at once: every code is replaced with its
+    * string from the dictionary instead of reading one symbol per call */
+   static void decode( LzwDict &Dict, const byte *Data, int Size, Array<byte> &Output );
+
 private:
 
    LzwDict &_dict;
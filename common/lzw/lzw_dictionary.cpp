@@ -32,8 +32,13 @@ LzwDict::LzwDict( void ) :
    CP_INIT,
    TL_CP_GET(_storage), 
    TL_CP_GET(_nextPointers), 
-   TL_CP_GET(_hashKeys)
+   TL_CP_GET(_hashKeys),
+   TL_CP_GET(_strings),
+   TL_CP_GET(_stringOffsets)
 {
+   _strings.clear();
+   _stringOffsets.clear();
+   _stringOffsets.push(0);
    reset();
 }
 
@@ -48,7 +53,7 @@ void LzwDict::reset ()
 
 LzwDict::LzwDict( int NewAlphabetSize, int NewBitCodeSize ) :
    _modified(false), CP_INIT, TL_CP_GET(_storage), TL_CP_GET(_nextPointers), 
-   TL_CP_GET(_hashKeys)
+   TL_CP_GET(_hashKeys), TL_CP_GET(_strings), TL_CP_GET(_stringOffsets)
 {
    init(NewAlphabetSize, NewBitCodeSize);
 }
@@ -68,6 +73,9 @@ void LzwDict::init( int NewAlphabetSize, int NewBitCodeSize )
    _maxCode = (1 << _bitcodeSize) - 1;
 
    _storage.clear();
+   _strings.clear();
+   _stringOffsets.clear();
+   _stringOffsets.push(0);
    _hashKeys.resize(SIZE);   
    _nextPointers.resize(SIZE);
 
@@ -123,6 +131,7 @@ bool LzwDict::addElem( const int NewPrefix, const byte NewChar,
       }
 
       _storage.push(D);
+      _addString(_storage.size() - 1);
 
       _freePtr++;
       
@@ -185,6 +194,49 @@ byte LzwDict::getChar( const int Code ) const
    return _storage[Code - _alphabetSize - 1].AppendChar;
 } 
 
+/* Append the string of the new element: the string of its prefix and
+ * its char. Prefixes are always added before the elements using them. */
+void LzwDict::_addString( int Index )
+{
+   int Prefix = _storage[Index].Prefix;
+   int Offset = _strings.size();
+
+   if (Prefix > _alphabetSize)
+   {
+      int PrefixIndex = Prefix - _alphabetSize - 1;
+
+      if (PrefixIndex >= Index)
+         throw Error("prefix %d of code %d is not defined", Prefix, Index + _alphabetSize + 1);
+
+      int PrefixOffset = _stringOffsets[PrefixIndex];
+      int PrefixLength = _stringOffsets[PrefixIndex + 1] - PrefixOffset;
+
+      _strings.resize(Offset + PrefixLength + 1);
+      memcpy(_strings.ptr() + Offset, _strings.ptr() + PrefixOffset, PrefixLength);
+      Offset += PrefixLength;
+   }
+   else
+   {
+      _strings.resize(Offset + 2);
+      _strings[Offset++] = (byte)Prefix;
+   }
+
+   _strings[Offset] = _storage[Index].AppendChar;
+   _stringOffsets.push(Offset + 1);
+}
+
+/* Get code string function */
+const byte * LzwDict::getString( const int Code, int &Length ) const
+{
+   int Index = Code - _alphabetSize - 1;
+
+   if (Index < 0 || Index >= _storage.size())
+      throw Error("getString(): unknown code %d", Code);
+
+   Length = _stringOffsets[Index + 1] - _stringOffsets[Index];
+   return _strings.ptr() + _stringOffsets[Index];
+}
+
 /* Get dictionary size function */
 int LzwDict::getSize( void ) const
 {
@@ -300,6 +352,13 @@ void LzwDict::load( Scanner &_scanner )
 
    _freePtr = _scanner.readBinaryInt();
 
+   _strings.clear();
+   _stringOffsets.clear();
+   _stringOffsets.push(0);
+
+   for (i = 0; i < n; i++)
+      _addString(i);
+
    _hashKeys.clear_resize(SIZE);
    _nextPointers.clear_resize(SIZE);
 
@@ -69,6 +69,10 @@ public:
 
    byte getChar( const int Index ) const;
 
+   /* Get the whole string of a code greater than the alphabet size,
+    * so the decoder doesn't need to follow the prefixes */
+   const byte * getString( const int Code, int &Length ) const;
+
    int getSize( void ) const;
 
    bool isInitialized( void ) const;
@@ -115,6 +119,14 @@ private:
 
    TL_CP_DECL(Array<int>, _hashKeys);
 
+   /* Strings of the dictionary elements: the string of the element i
+    * is _strings[_stringOffsets[i]] ... _strings[_stringOffsets[i + 1] - 1] */
+   TL_CP_DECL(Array<byte>, _strings);
+
+   TL_CP_DECL(Array<int>, _stringOffsets);
+
+   void _addString( int Index );
+
    LzwDict( const LzwDict & );
 
 };
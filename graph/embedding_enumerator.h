@@ -64,6 +64,13 @@ public:
                              int sub_idx, int super_idx, void *userdata);
    bool (*cb_allow_many_to_one) (Graph &subgraph, int sub_idx, void *userdata);
 
+   // Optional check of a pair of vertices that does not depend on the
+   // current mapping. If it is set, the candidate supergraph vertices of
+   // every subgraph vertex are found when the enumeration starts, and the
+   // pairs are checked against them before cb_match_vertex is called.
+   bool (*cb_candidate_vertex) (Graph &subgraph, Graph &supergraph,
+                                int sub_idx, int super_idx, void *userdata);
+
    void *userdata;
 
    void setSubgraph (Graph &subgraph);
@@ -91,6 +98,10 @@ public:
 
    const int * getSupergraphMapping ();
 
+   // Returns true if the candidate sets are built and contain the pair,
+   // i.e. cb_candidate_vertex has accepted it
+   bool isKnownCandidate (int sub_idx, int super_idx) const;
+
    // Update internal structures to fit all target vertices that might be added
    void validate ();
 
@@ -119,6 +130,17 @@ protected:
    TL_CP_DECL(GraphFastAccess, _g1_fast);
    TL_CP_DECL(GraphFastAccess, _g2_fast);
 
+   // Bitsets of the candidate supergraph vertices for the subgraph
+   // vertices, _candidate_words qwords per subgraph vertex
+   TL_CP_DECL(Array<qword>, _candidates);
+   int  _candidate_words;
+   bool _candidates_ready;
+   bool _no_candidates;
+
+   void _buildCandidates ();
+   bool _isCandidate (int node1, int node2) const;
+   bool _checkCandidates (int node1, int node2);
+
    void _terminatePreviousMatch ();
 
    //
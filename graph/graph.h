@@ -106,6 +106,10 @@ public:
    EdgesAuto edges ();
 
    virtual void clear ();
+
+   // Reserves memory for the vertices and edges that are going to be added,
+   // so that adding them doesn't reallocate the arrays again and again
+   virtual void reserve (int vertices, int edges);
    
    const Vertex & getVertex (int idx) const;
 
@@ -137,6 +141,16 @@ public:
 
    bool findPath (int from, int where, Array<int> &path_out) const;
 
+   // Rebuilds the neighbors pool so that the neighbors of every vertex take
+   // consecutive pool elements, in the vertex order. The order of the
+   // neighbors is kept, but their indices change, so open neighbor
+   // iterations become invalid. It pays off for graphs that are traversed
+   // many times without changes, e.g. substructure matching targets. Any
+   // change of the vertices or edges unfreezes the graph.
+   void freeze ();
+   void unfreeze ();
+   bool isFrozen () const { return _frozen; }
+
    void makeSubgraph (const Graph &other, const Array<int> &vertices, Array<int> *vertex_mapping);
    void makeSubgraph (const Graph &other, const Array<int> &vertices, Array<int> *vertex_mapping, const Array<int> *edges, Array<int> *edge_mapping);
    void makeSubgraph (const Graph &other, const Filter &filter, Array<int> *mapping_out, Array<int> *inv_mapping);
@@ -182,6 +196,8 @@ protected:
    ObjPool<Vertex>  *_vertices;
    Pool<Edge>       _edges;
 
+   bool              _frozen;
+
    Array<int> _topology; // for each edge: TOPOLOGY_RING, TOPOLOGY_CHAIN, or -1 (not calculated)
    bool       _topology_valid;
 
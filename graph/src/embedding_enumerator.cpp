@@ -36,6 +36,7 @@ EmbeddingEnumerator::EmbeddingEnumerator (Graph &supergraph) :
    TL_CP_GET(_s_pool),
    TL_CP_GET(_g1_fast),
    TL_CP_GET(_g2_fast),
+   TL_CP_GET(_candidates),
    TL_CP_GET(_query_match_state),
    TL_CP_GET(_enumerators)
 {
@@ -49,8 +50,13 @@ EmbeddingEnumerator::EmbeddingEnumerator (Graph &supergraph) :
    cb_vertex_remove = 0;
    cb_edge_add = 0;
    cb_vertex_add = 0;
+   cb_candidate_vertex = 0;
    userdata = 0;
 
+   _candidate_words = 0;
+   _candidates_ready = false;
+   _no_candidates = false;
+
    _cancellation_handler = getCancellationHandler();
    _cancellation_check_number = 0;
 
@@ -71,6 +77,7 @@ void EmbeddingEnumerator::validate ()
    // _core_2 must be preserved because there might be fixed vertices
    _core_2.expandFill(_g2->vertexEnd(), -1);
    _g2_fast.setGraph(*_g2);
+   _candidates_ready = false;
 }
 
 void EmbeddingEnumerator::setSubgraph (Graph &subgraph)
@@ -87,6 +94,7 @@ void EmbeddingEnumerator::setSubgraph (Graph &subgraph)
    _terminatePreviousMatch();
 
    _g1_fast.setGraph(*_g1);
+   _candidates_ready = false;
 }
 
 void EmbeddingEnumerator::ignoreSubgraphVertex (int idx)
@@ -197,6 +205,100 @@ void EmbeddingEnumerator::processStart ()
    _core_1.copy(core1_pre);
    _t1_len_pre = t1_len_saved;
    _enumerators[0].initForFirstSearch(_t1_len_pre);
+
+   if (cb_candidate_vertex != 0)
+      _buildCandidates();
+   else
+      _candidates_ready = false;
+}
+
+void EmbeddingEnumerator::_buildCandidates ()
+{
+   _candidate_words = (_g2->vertexEnd() + 63) / 64;
+   _candidates.clear_resize(_g1->vertexEnd() * _candidate_words);
+   _candidates.zerofill();
+   _no_candidates = false;
+
+   for (int i = _g1->vertexBegin(); i != _g1->vertexEnd(); i = _g1->vertexNext(i))
+   {
+      if (_core_1[i] != UNMAPPED && _core_1[i] != TERM_OUT)
+         continue;
+
+      qword *row = _candidates.ptr() + i * _candidate_words;
+      bool empty = true;
+
+      for (int j = _g2->vertexBegin(); j != _g2->vertexEnd(); j = _g2->vertexNext(j))
+      {
+         if (_core_2[j] == IGNORE)
+            continue;
+
+         if (cb_candidate_vertex(*_g1, *_g2, i, j, userdata))
+         {
+            row[j >> 6] |= (qword)1 << (j & 63);
+            empty = false;
+         }
+      }
+
+      if (empty)
+      {
+         // Some subgraph vertex can not be mapped at all
+         _no_candidates = true;
+         break;
+      }
+   }
+
+   _candidates_ready = true;
+}
+
+bool EmbeddingEnumerator::isKnownCandidate (int sub_idx, int super_idx) const
+{
+   return _candidates_ready && _isCandidate(sub_idx, super_idx);
+}
+
+bool EmbeddingEnumerator::_isCandidate (int node1, int node2) const
+{
+   return ((_candidates[node1 * _candidate_words + (node2 >> 6)] >> (node2 & 63)) & 1) != 0;
+}
+
+// Checks the pair by the candidate sets, and also checks that every unmapped
+// neighbor of node1 still has a candidate among free neighbors of node2
+bool EmbeddingEnumerator::_checkCandidates (int node1, int node2)
+{
+   if (!_candidates_ready)
+      return true;
+
+   if (!_isCandidate(node1, node2))
+      return false;
+
+   int node1_nei_count, node2_nei_count;
+   int *node1_nei_v = _g1_fast.getVertexNeiVertices(node1, node1_nei_count);
+   int *node2_nei_v = _g2_fast.getVertexNeiVertices(node2, node2_nei_count);
+
+   for (int i = 0; i < node1_nei_count; i++)
+   {
+      int other1 = node1_nei_v[i];
+
+      if (_core_1[other1] != UNMAPPED && _core_1[other1] != TERM_OUT)
+         continue;
+
+      int j;
+
+      for (j = 0; j < node2_nei_count; j++)
+      {
+         int other2 = node2_nei_v[j];
+
+         if (!allow_many_to_one && _core_2[other2] != UNMAPPED && _core_2[other2] != TERM_OUT)
+            continue;
+
+         if (_isCandidate(other1, other2))
+            break;
+      }
+
+      if (j == node2_nei_count)
+         return false;
+   }
+
+   return true;
 }
 
 void EmbeddingEnumerator::_fixNode1 (int node1, int node2)
@@ -558,6 +660,9 @@ int EmbeddingEnumerator::_Enumerator::nextPair ()
    if (_current_node1 == -2)
       return _NOWAY;
 
+   if (_context._candidates_ready && _context._no_candidates)
+      return _NOWAY;
+
    // check for dead state
    if (_t1_len > _t2_len && !_context.allow_many_to_one)
       return _NOWAY;
@@ -576,6 +681,9 @@ int EmbeddingEnumerator::_Enumerator::nextPair ()
          if (!_checkNode2(_current_node2, _current_node1))
             continue;
 
+         if (!_context._checkCandidates(_current_node1, _current_node2))
+            continue;
+
          if (!_checkPair(_current_node1, _current_node2))
             continue;
 
@@ -613,6 +721,9 @@ int EmbeddingEnumerator::_Enumerator::nextPair ()
          if (!_checkNode2(_current_node2, _current_node1))
             continue;
 
+         if (!_context._checkCandidates(_current_node1, _current_node2))
+            continue;
+
          if (!_checkPair(_current_node1, _current_node2))
             continue;
 
@@ -55,6 +55,7 @@ Graph::Graph ()
    _neighbors_pool = new Pool<List<VertexEdge>::Elem>();
    _sssr_pool = 0;
    _components_valid = false;
+   _frozen = false;
 }
 
 Graph::~Graph ()
@@ -71,6 +72,7 @@ Graph::~Graph ()
 
 int Graph::addVertex ()
 {
+   unfreeze();
    return _vertices->add(*_neighbors_pool);
 }
 
@@ -117,7 +119,9 @@ int Graph::addEdge (int beg, int end)
 
    if (findEdgeIndex(beg, end) != -1)
       throw Error("already have edge between vertices %d and %d", beg, end);
-   
+
+   unfreeze();
+
    int edge_idx = _edges.add();
 
    Vertex &vbeg = _vertices->at(beg);
@@ -153,6 +157,8 @@ void Graph::swapEdgeEnds (int edge_idx)
 
 void Graph::removeEdge (int idx)
 {
+   unfreeze();
+
    Edge edge = _edges[idx];
 
    Vertex &beg = _vertices->at(edge.beg);
@@ -170,6 +176,8 @@ void Graph::removeEdge (int idx)
 
 void Graph::removeAllEdges ()
 {
+   unfreeze();
+
    for (int i = _vertices->begin(); i != _vertices->end(); i = _vertices->next(i))
       _vertices->at(i).neighbors_list.clear();
 
@@ -183,6 +191,8 @@ void Graph::removeVertex (int idx)
 {
    QS_DEF(Array<int>, edges);
 
+   unfreeze();
+
    const Vertex &vertex = getVertex(idx);
 
    int i;
@@ -203,6 +213,50 @@ void Graph::removeVertex (int idx)
 }
 
 
+void Graph::freeze ()
+{
+   if (_frozen)
+      return;
+
+   QS_DEF(Array<VertexEdge>, neighbors);
+   QS_DEF(Array<int>, degrees);
+   int i, j;
+
+   neighbors.clear();
+   degrees.clear_resize(vertexEnd());
+   for (i = vertexBegin(); i != vertexEnd(); i = vertexNext(i))
+   {
+      const Vertex &vertex = getVertex(i);
+
+      for (j = vertex.neiBegin(); j != vertex.neiEnd(); j = vertex.neiNext(j))
+         neighbors.push(vertex.neighbors_list[j]);
+      degrees[i] = vertex.degree();
+   }
+
+   // The cleared pool gives consecutive indices
+   for (i = vertexBegin(); i != vertexEnd(); i = vertexNext(i))
+      _vertices->at(i).neighbors_list.clear();
+   _neighbors_pool->clear();
+
+   int offset = 0;
+
+   for (i = vertexBegin(); i != vertexEnd(); i = vertexNext(i))
+   {
+      Vertex &vertex = _vertices->at(i);
+
+      for (j = 0; j < degrees[i]; j++)
+         vertex.neighbors_list.add(neighbors[offset + j]);
+      offset += degrees[i];
+   }
+
+   _frozen = true;
+}
+
+void Graph::unfreeze ()
+{
+   _frozen = false;
+}
+
 const Vertex & Graph::getVertex (int idx) const
 {
    return _vertices->at(idx);
@@ -297,6 +351,7 @@ EdgesAuto Graph::edges ()
 
 void Graph::clear ()
 {
+   unfreeze();
    _vertices->clear();
    _edges.clear();
    _topology_valid = false;
@@ -304,6 +359,18 @@ void Graph::clear ()
    _components_valid = false;
 }
 
+void Graph::reserve (int vertices, int edges)
+{
+   if (vertices > 0)
+      _vertices->reserve(vertexEnd() + vertices);
+
+   if (edges > 0)
+   {
+      _edges.reserve(edgeEnd() + edges);
+      _neighbors_pool->reserve(_neighbors_pool->end() + edges * 2);
+   }
+}
+
 bool Graph::isChain_AssumingConnected (const Graph &graph)
 {
    // ensure it is a tree
@@ -104,6 +104,9 @@ public:
 
    virtual void clear ();
 
+   // Reserves memory of the per-atom and per-bond arrays
+   virtual void reserve (int atoms, int bonds);
+
    // 'neu' means 'new' in German
    virtual BaseMolecule * neu () = 0;
 
@@ -19,6 +19,7 @@
 #include "lzw/lzw_dictionary.h"
 #include "lzw/lzw_decoder.h"
 #include "base_cpp/obj.h"
+#include "base_cpp/obj_array.h"
 #include "molecule/cmf_saver.h"
 
 #ifdef _WIN32
@@ -36,9 +37,13 @@ class DLLEXPORT CmfLoader
 {
 public:
 
-   // external dictionary, internal decoder
+   // external dictionary, internal decoder; the rest of the scanner
+   // is decoded at once, see LzwDecoder::decode()
    explicit CmfLoader (LzwDict &dict, Scanner &scanner);
 
+   // external dictionary, encoded buffer
+   explicit CmfLoader (LzwDict &dict, const byte *data, int size);
+
    // external dictionary, external decoder
    explicit CmfLoader (LzwDecoder &decoder);
 
@@ -50,6 +55,12 @@ public:
    void loadMolecule (Molecule &mol);
    void loadXyz (Scanner &scanner);
 
+   // Decodes a batch of CMF buffers compressed with the dictionary.
+   // The molecules are added to the array if it is smaller than the batch,
+   // and the molecules already in the array are reused.
+   static void decodeMany (LzwDict &dict, const Array<const byte *> &buffers,
+                           const Array<int> &sizes, ObjArray<Molecule> &molecules);
+
    bool skip_cistrans;
    bool skip_stereocenters;
    bool skip_valence;
@@ -115,6 +126,7 @@ protected:
    };
 
    void _init ();
+   void _decode (LzwDict &dict, const byte *data, int size);
    
    bool _getNextCode (int &code);
 
@@ -139,9 +151,12 @@ protected:
 
    Scanner *_scanner;
    
-   Obj<LzwDecoder> _decoder_obj;
    LzwDecoder     *_ext_decoder;
    Obj<LzwScanner> _lzw_scanner;
+   Obj<BufferScanner> _decoded_scanner;
+
+   TL_CP_DECL(Array<char>, _encoded);
+   TL_CP_DECL(Array<byte>, _decoded);
 
    TL_CP_DECL(Array<_AtomDesc>, _atoms);
    TL_CP_DECL(Array<_BondDesc>, _bonds);
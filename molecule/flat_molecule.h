@@ -0,0 +1,83 @@
+/****************************************************************************
+ * Copyright (C) 2009-2015 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#ifndef __flat_molecule__
+#define __flat_molecule__
+
+#include "base_cpp/array.h"
+
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+namespace indigo {
+
+// Compact molecule for bulk tasks like atom counting or gross formula that
+// don't need the full Molecule. Atoms and bonds are kept in flat arrays and
+// neighbors are kept in compressed sparse rows: the neighbors of atom i are
+// nei_atoms[nei_offsets[i]] ... nei_atoms[nei_offsets[i + 1] - 1] connected by
+// the bonds with the same positions in nei_bonds. Clearing the molecule keeps
+// the memory, so refilling it doesn't allocate memory.
+class DLLEXPORT FlatMolecule
+{
+public:
+   struct Atom
+   {
+      int  number;
+      int  charge;
+      int  isotope;
+      int  implicit_h;
+      bool aromatic;
+   };
+
+   struct Bond
+   {
+      int beg;
+      int end;
+      int order; // BOND_SINGLE, BOND_DOUBLE, BOND_TRIPLE or BOND_AROMATIC
+   };
+
+   void clear ()
+   {
+      atoms.clear();
+      bonds.clear();
+      nei_offsets.clear();
+      nei_atoms.clear();
+      nei_bonds.clear();
+   }
+
+   int atomCount () const { return atoms.size(); }
+   int bondCount () const { return bonds.size(); }
+   int degree (int idx) const { return nei_offsets[idx + 1] - nei_offsets[idx]; }
+
+   int countHeavyAtoms () const;
+
+   // Fills the neighbor arrays from the bonds
+   void buildNeighbors ();
+
+   Array<Atom> atoms;
+   Array<Bond> bonds;
+   Array<int>  nei_offsets;
+   Array<int>  nei_atoms;
+   Array<int>  nei_bonds;
+};
+
+}
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif
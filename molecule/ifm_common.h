@@ -0,0 +1,130 @@
+/****************************************************************************
+ * Copyright (C) 2009-2015 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#ifndef __ifm_common__
+#define __ifm_common__
+
+#include "base_c/defs.h"
+
+namespace indigo
+{
+
+// IFM is a fixed-layout molecule format that is read in place, without
+// decoding: a buffer, e.g. a part of a mmapped file, starts with IfmHeader
+// followed by the arrays of the structures below. Offsets are counted from
+// the buffer start and are multiples of 8, the buffer size is a multiple of 8
+// too, so buffers saved one after another stay aligned. Numbers are in the
+// byte order of the machine that saved the buffer, see IFM_BYTE_ORDER.
+
+enum
+{
+   IFM_VERSION = 1,
+   IFM_BYTE_ORDER = 0x01020304,
+   IFM_ALIGNMENT = 8
+};
+
+// IfmHeader::flags
+enum
+{
+   IFM_XYZ = 1
+};
+
+// IfmAtom::flags
+enum
+{
+   IFM_ATOM_AROMATIC = 1,
+   IFM_ATOM_H_COUNT = 2  // implicit_h is set on loading, see Molecule::shouldWriteHCount()
+};
+
+struct IfmHeader
+{
+   char  signature[3];  // "IFM"
+   byte  version;
+   dword byte_order;
+   dword size;
+   dword flags;
+
+   dword atom_count;
+   dword bond_count;
+   dword stereocenter_count;
+   dword cis_trans_count;
+   dword property_count;
+   dword string_count;
+
+   int   name;          // string index or -1
+   int   gross_formula; // string index or -1
+
+   dword atoms;
+   dword bonds;
+   dword stereocenters;
+   dword cis_trans;
+   dword properties;
+   dword strings;
+   dword chars;
+   dword chars_size;
+};
+
+struct IfmAtom
+{
+   short number;
+   short isotope;
+   short charge;
+   signed char radical;
+   signed char implicit_h;     // -1 if can not be calculated
+   signed char valence;        // explicit valence or -1
+   byte  flags;
+   short reserved;
+   int   label;                // pseudoatom string index or R-site bits
+   float xyz[3];
+};
+
+struct IfmBond
+{
+   int  beg;
+   int  end;
+   byte order;
+   byte direction;
+   short reserved;
+};
+
+struct IfmStereocenter
+{
+   int atom;
+   int type;
+   int group;
+   int pyramid[4];
+};
+
+struct IfmCisTrans
+{
+   int bond;
+   int parity;
+   int substituents[4];
+};
+
+struct IfmProperty
+{
+   int name;
+   int value;
+};
+
+struct IfmString
+{
+   dword offset;  // in the chars array, the string is zero-terminated
+   dword length;
+};
+
+}
+
+#endif
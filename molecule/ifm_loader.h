@@ -0,0 +1,88 @@
+/****************************************************************************
+ * Copyright (C) 2009-2015 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#ifndef __ifm_loader__
+#define __ifm_loader__
+
+#include "base_cpp/array.h"
+#include "base_cpp/exception.h"
+#include "molecule/ifm_common.h"
+
+namespace indigo {
+
+class Molecule;
+
+// Reads a molecule saved by IfmSaver in place. The constructor checks only
+// the header, so it takes constant time, and the accessors return pointers
+// into the buffer, which must outlive the loader. A buffer that is not
+// aligned to 4 bytes is copied, and the pointers are valid while the
+// loader exists.
+class IfmLoader
+{
+public:
+   IfmLoader (const byte *buf, int size);
+
+   // Size of the saved molecule, may be less than the buffer size
+   int size () const;
+
+   int atomCount () const;
+   int bondCount () const;
+   int stereocenterCount () const;
+   int cisTransCount () const;
+   int propertyCount () const;
+   bool haveXyz () const;
+
+   const IfmAtom & getAtom (int idx) const;
+   const IfmBond & getBond (int idx) const;
+   const IfmStereocenter & getStereocenter (int idx) const;
+   const IfmCisTrans & getCisTrans (int idx) const;
+
+   // Empty string if the molecule has no name
+   const char * name () const;
+   // NULL if the gross formula could not be calculated on saving
+   const char * grossFormula () const;
+   const char * pseudoAtom (int idx) const;
+
+   const char * propertyName (int idx) const;
+   const char * propertyValue (int idx) const;
+   // NULL if there is no such property
+   const char * findProperty (const char *name) const;
+
+   void loadMolecule (Molecule &mol) const;
+
+   DECL_ERROR;
+
+protected:
+   const IfmHeader *_header;
+   const IfmAtom *_atoms;
+   const IfmBond *_bonds;
+   const IfmStereocenter *_stereocenters;
+   const IfmCisTrans *_cis_trans;
+   const IfmProperty *_properties;
+   const IfmString *_strings;
+   const char *_chars;
+
+   // Aligned copy of an unaligned buffer
+   Array<byte> _aligned;
+
+   const void * _getSection (const byte *buf, dword offset, dword count, int item_size);
+   const char * _getString (int idx) const;
+
+private:
+   IfmLoader (const IfmLoader &); // no implicit copy
+};
+
+}
+
+#endif
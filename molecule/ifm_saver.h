@@ -0,0 +1,53 @@
+/****************************************************************************
+ * Copyright (C) 2009-2015 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#ifndef __ifm_saver__
+#define __ifm_saver__
+
+#include "base_cpp/exception.h"
+
+namespace indigo {
+
+class Molecule;
+class Output;
+class PropertiesMap;
+
+// Saves a molecule in IFM fixed-layout format, see ifm_common.h.
+// Atoms and bonds are renumbered to be contiguous. Gross formula is saved as
+// a string to be read without the molecule, so the molecule gets its
+// aromatic hydrogens restored as MoleculeGrossFormula does.
+class IfmSaver
+{
+public:
+   static const char *VERSION;
+   static bool checkVersion (const char *prefix);
+
+   explicit IfmSaver (Output &output);
+
+   void saveMolecule (Molecule &mol, PropertiesMap *properties = 0);
+
+   bool gross_formula_add_rsites;
+
+   DECL_ERROR;
+
+protected:
+   Output &_output;
+
+private:
+   IfmSaver (const IfmSaver &); // no implicit copy
+};
+
+}
+
+#endif
@@ -33,6 +33,7 @@ public:
    virtual Molecule & asMolecule ();
 
    virtual void clear ();
+   virtual void reserve (int atoms, int bonds);
 
    virtual BaseMolecule * neu ();
 
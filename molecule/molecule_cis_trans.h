@@ -51,6 +51,8 @@ public:
    void ignore (int bond_idx);
 
    void registerBond (int idx);
+   // Reserves memory for the bonds that are going to be registered
+   void reserve (int bonds);
 
    void flipBond (int atom_parent, int atom_from, int atom_to);
 
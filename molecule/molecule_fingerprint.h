@@ -21,7 +21,6 @@
 #include "base_cpp/cancellation_handler.h"
 #include "graph/subgraph_hash.h"
 
-#include <unordered_map>
 #include <limits.h>
 
 #ifdef _WIN32
@@ -83,6 +82,11 @@ public:
 
    void process ();
 
+   // Builds the fingerprint of another molecule with the same settings.
+   // Buffers of the builder are reused, so this is cheaper than creating
+   // a new builder for each molecule.
+   void process (BaseMolecule &mol);
+
    const byte * get ();
    byte * getOrd ();
    byte * getSim ();
@@ -127,24 +131,37 @@ protected:
    void _calculateFragmentVertexDegree (BaseMolecule &mol, const Array<int> &vertices, const Array<int> &edges);
    int _calculateFragmentExternalConn (BaseMolecule &mol, const Array<int> &vertices, const Array<int> &edges);
 
-   BaseMolecule &_mol;
+   BaseMolecule *_mol;
    const MoleculeFingerprintParameters &_parameters;
 
    // these parameters are indirectly passed to the callbacks
    TautomerSuperStructure *_tau_super_structure;
    bool _is_cycle;
 
-   struct HashBits
-   {
-      HashBits (dword hash, int bits_per_fragment);
-      bool operator== (const HashBits &right) const;
-
-      dword hash;
-      int bits_per_fragment;
-   };
-   struct Hasher
+   // Open addressing table of the ORD fragment hashes with their counters.
+   // The table keeps its memory, and clear() touches only used entries.
+   class OrdHashes
    {
-      size_t operator () (const HashBits &input) const;
+   public:
+      struct Entry
+      {
+         dword hash;
+         int bits_per_fragment;
+         int count;
+      };
+
+      void clear ();
+      void add (dword hash, int bits_per_fragment);
+
+      int size () const { return _used.size(); }
+      const Entry & at (int i) const { return _table[_used[i]]; }
+
+   private:
+      Array<Entry> _table;
+      Array<int> _used;
+
+      void _resize (int capacity);
+      int _findSlot (dword hash, int bits_per_fragment) const;
    };
 
    void _addOrdHashBits (dword hash, int bits_per_fragment);
@@ -163,8 +180,7 @@ protected:
    TL_CP_DECL(Array<int>, _fragment_vertex_degree);
    TL_CP_DECL(Array<int>, _bond_orders);
 
-   typedef std::unordered_map<HashBits, int, Hasher> HashesMap;
-   TL_CP_DECL(HashesMap, _ord_hashes);
+   TL_CP_DECL(OrdHashes, _ord_hashes);
 
 private:
    MoleculeFingerprintBuilder (const MoleculeFingerprintBuilder &); // no implicit copy
@@ -31,6 +31,7 @@ namespace indigo {
 #endif
 
 class BaseMolecule;
+class FlatMolecule;
 
 
 
@@ -50,6 +51,8 @@ public:
    
    static void collect (BaseMolecule &molecule, Array<int> &gross);
    static std::unique_ptr<GROSS_UNITS> collect (BaseMolecule &molecule);
+   // Gross formula of a molecule loaded by SmilesFlatLoader
+   static std::unique_ptr<GROSS_UNITS> collect (const FlatMolecule &molecule);
    
    static void toString (const Array<int> &gross, Array<char> &str, bool add_rsites = false);
    static void toString (GROSS_UNITS& gross, Array<char> &str, bool add_rsites = false);
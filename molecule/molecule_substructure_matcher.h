@@ -80,6 +80,11 @@ public:
    int   match_3d;       // 0 or AFFINE or CONFORMATION
    float rms_threshold;  // for AFFINE and CONFORMATION
 
+   // Find candidate target atoms for all query atoms before the search.
+   // It costs (query atoms) x (target atoms) atom checks but prunes the
+   // search early, so it pays off for hard queries and big targets.
+   bool use_candidate_sets;
+
    void ignoreQueryAtom (int idx);
    void ignoreTargetAtom (int idx);
    bool fix (int query_atom_idx, int target_atom_idx);
@@ -171,6 +176,10 @@ protected:
    static bool _matchAtoms (Graph &subgraph, Graph &supergraph,
                             const int *core_sub, int sub_idx, int super_idx, void *userdata);
 
+   // Part of _matchAtoms that does not depend on the current mapping
+   static bool _matchAtomsStatic (Graph &subgraph, Graph &supergraph,
+                                  int sub_idx, int super_idx, void *userdata);
+
    static bool _matchBonds (Graph &subgraph, Graph &supergraph,
                             int sub_idx, int super_idx, void *userdata);
 
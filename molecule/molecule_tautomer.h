@@ -297,6 +297,8 @@ protected:
    TL_CP_DECL(Array<int>,  _inv_mapping);
    TL_CP_DECL(Array<int>,  _edge_mapping);
    TL_CP_DECL(Array<int>,  _total_h);
+   // Zero-filled between getSubgraphType() calls
+   TL_CP_DECL(Array<int>,  _attached_bonds_count);
 };
 
 }
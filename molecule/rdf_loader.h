@@ -35,7 +35,11 @@ class RdfLoader
 	 */
 	enum { MAX_DATA_SIZE = 104857600 };
 public:
-   RdfLoader (Scanner &scanner);
+   /*
+    * Gzipped input is inflated on gzip_threads background threads if it is
+    * greater than zero, see GZipScanner
+    */
+   RdfLoader (Scanner &scanner, int gzip_threads = 0);
    ~RdfLoader ();
 
    bool isEOF ();
@@ -45,6 +49,34 @@ public:
    int currentNumber ();
    int count ();
 
+   /*
+    * Offsets of the records read so far
+    */
+   const Array<long long> & offsets ();
+   /*
+    * Sets offsets of all the records, e.g. loaded from an index. end_offset
+    * is the offset after the last record.
+    */
+   void setOffsets (const Array<long long> &offsets, long long end_offset);
+   /*
+    * Offset after the last record read so far
+    */
+   long long endOffset ();
+   /*
+    * True if the input is gzipped and the offsets are in the uncompressed data
+    */
+   bool isCompressed ();
+
+   /*
+    * Appends offsets of the lines starting with "$MFMT" or "$RFMT" among
+    * the lines starting before end. The scanner should be at a line start.
+    */
+   static void findRecordBoundaries (Scanner &scanner, long long end, Array<long long> &boundaries);
+   /*
+    * Converts boundaries found in the whole input into offsets of the records
+    */
+   static void boundariesToOffsets (Scanner &scanner, Array<long long> &boundaries);
+
    CP_DECL;
    /*
     * Data buffer with reaction or molecule for current record
@@ -67,12 +99,19 @@ protected:
    bool _readIdentifiers(bool);
    inline Scanner& _getScanner() const;
    static bool _readLine(Scanner&, Array<char>&);
+   bool _readInnerLine();
+   long long _recordStart() const;
 
    inline bool _startsWith(const char* str) const {
       return ((size_t)_innerBuffer.size() >= strlen(str) && strncmp(_innerBuffer.ptr(), str, strlen(str))==0);
    }
 
    TL_CP_DECL(Array<char>, _innerBuffer);
+   /*
+    * Offset of the line in the inner buffer. Records start at this line,
+    * so seeking to a record offset needs no other state.
+    */
+   long long _innerBufferOffset;
    bool _ownScanner;
    Scanner *_scanner;
    bool _isMolecule;
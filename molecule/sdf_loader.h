@@ -30,7 +30,9 @@ class SdfLoader
 	 */
 	enum { MAX_DATA_SIZE = 10485760 };
 public:
-   SdfLoader (Scanner &scanner);
+   // Gzipped input is inflated on gzip_threads background threads if it is
+   // greater than zero, see GZipScanner
+   SdfLoader (Scanner &scanner, int gzip_threads = 0);
    ~SdfLoader ();
 
    bool isEOF ();
@@ -42,6 +44,22 @@ public:
 
    void readAt (int index);
 
+   // Offsets of the records read so far
+   const Array<long long> & offsets ();
+   // Sets offsets of all the records, e.g. loaded from an index. end_offset
+   // is the offset after the last record.
+   void setOffsets (const Array<long long> &offsets, long long end_offset);
+   // Offset after the last record read so far
+   long long endOffset ();
+   // True if the input is gzipped and the offsets are in the uncompressed data
+   bool isCompressed ();
+
+   // Appends offsets that follow the lines starting with "$$$$" among the
+   // lines starting before end. The scanner should be at a line start.
+   static void findRecordBoundaries (Scanner &scanner, long long end, Array<long long> &boundaries);
+   // Converts boundaries found in the whole input into offsets of the records
+   static void boundariesToOffsets (Scanner &scanner, Array<long long> &boundaries);
+
    CP_DECL;
    TL_CP_DECL(Array<char>, data);
    TL_CP_DECL(PropertiesMap, properties);
@@ -0,0 +1,91 @@
+/****************************************************************************
+ * Copyright (C) 2009-2015 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#ifndef __smiles_flat_loader__
+#define __smiles_flat_loader__
+
+#include "base_cpp/tlscont.h"
+#include "molecule/flat_molecule.h"
+
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+namespace indigo {
+
+// Streaming SMILES parser that fills FlatMolecule without building Molecule.
+// It handles plain SMILES: organic subset and bracket atoms, bonds, branches,
+// ring closures and disconnected components. Stereo marks are skipped and the
+// name after the SMILES is ignored. The hydrogen counts are the same as
+// SmilesLoader gives.
+//
+// load() returns false for anything else, e.g. query features, pseudoatoms,
+// CXSMILES extensions or aromatic rings that need hydrogens to be restored,
+// and for invalid SMILES. SmilesLoader should be used for them.
+class DLLEXPORT SmilesFlatLoader
+{
+public:
+   SmilesFlatLoader ();
+
+   bool load (const char *smiles, int length, FlatMolecule &mol);
+
+   CP_DECL;
+
+protected:
+   enum { _NO_BOND = -1, _DIRECTED_BOND = -2 };
+
+   struct _Closure
+   {
+      int atom;
+      int bond_type;
+   };
+
+   const char *_str;
+   int _len;
+   int _pos;
+
+   TL_CP_DECL(Array<_Closure>, _closures);
+   TL_CP_DECL(Array<int>, _branches);
+   // Bond types as written, _NO_BOND for the bonds without a symbol
+   TL_CP_DECL(Array<int>, _bond_types);
+   TL_CP_DECL(Array<int>, _closure_bonds);
+   TL_CP_DECL(Array<int>, _parents);
+   TL_CP_DECL(Array<int>, _parent_bonds);
+   TL_CP_DECL(Array<int>, _depths);
+   TL_CP_DECL(Array<int>, _brackets);
+   TL_CP_DECL(Array<char>, _ring_bonds);
+   TL_CP_DECL(Array<int>, _ring_systems);
+   TL_CP_DECL(Array<char>, _aliphatic_systems);
+   TL_CP_DECL(Array<char>, _need_double);
+   TL_CP_DECL(Array<int>, _matching);
+
+   bool _parse (FlatMolecule &mol);
+   bool _readAtom (FlatMolecule::Atom &atom, bool &bracket);
+   bool _readBracketAtom (FlatMolecule::Atom &atom);
+   bool _markRingBonds (FlatMolecule &mol);
+   int  _findRingSystem (int atom);
+   bool _setBondOrders (FlatMolecule &mol);
+   bool _setHydrogens (FlatMolecule &mol);
+   bool _checkKekuleStructure (FlatMolecule &mol);
+   bool _matchAtoms (FlatMolecule &mol, int from, int &steps);
+};
+
+}
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif
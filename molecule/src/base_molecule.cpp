@@ -94,6 +94,27 @@ void BaseMolecule::clear ()
    updateEditRevision();
 }
 
+void BaseMolecule::reserve (int atoms, int bonds)
+{
+   if (atoms > 0)
+   {
+      int size = vertexEnd() + atoms;
+
+      _xyz.reserve(size);
+      reaction_atom_mapping.reserve(size);
+      reaction_atom_inversion.reserve(size);
+      reaction_atom_exact_change.reserve(size);
+   }
+
+   if (bonds > 0)
+   {
+      reaction_bond_reacting_center.reserve(edgeEnd() + bonds);
+      cis_trans.reserve(bonds);
+   }
+
+   Graph::reserve(atoms, bonds);
+}
+
 bool BaseMolecule::hasCoord (BaseMolecule &mol)
 {
    int i;
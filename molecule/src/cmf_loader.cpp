@@ -30,6 +30,8 @@ TL_CP_GET(atom_mapping_to_restore),
 TL_CP_GET(inv_atom_mapping_to_restore),
 TL_CP_GET(bond_mapping_to_restore),
 TL_CP_GET(inv_bond_mapping_to_restore),
+TL_CP_GET(_encoded),
+TL_CP_GET(_decoded),
 TL_CP_GET(_atoms),
 TL_CP_GET(_bonds),
 TL_CP_GET(_pseudo_labels),
@@ -37,9 +39,54 @@ TL_CP_GET(_attachments),
 TL_CP_GET(_sgroup_order)
 {
    _init();
-   _decoder_obj.create(dict, scanner);
-   _lzw_scanner.create(_decoder_obj.ref());
-   _scanner = _lzw_scanner.get();
+   scanner.readAll(_encoded);
+   _decode(dict, (const byte *)_encoded.ptr(), _encoded.size());
+}
+
+CmfLoader::CmfLoader (LzwDict &dict, const byte *data, int size) :
+CP_INIT,
+TL_CP_GET(atom_mapping_to_restore),
+TL_CP_GET(inv_atom_mapping_to_restore),
+TL_CP_GET(bond_mapping_to_restore),
+TL_CP_GET(inv_bond_mapping_to_restore),
+TL_CP_GET(_encoded),
+TL_CP_GET(_decoded),
+TL_CP_GET(_atoms),
+TL_CP_GET(_bonds),
+TL_CP_GET(_pseudo_labels),
+TL_CP_GET(_attachments),
+TL_CP_GET(_sgroup_order)
+{
+   _init();
+   _decode(dict, data, size);
+}
+
+void CmfLoader::_decode (LzwDict &dict, const byte *data, int size)
+{
+   LzwDecoder::decode(dict, data, size, _decoded);
+
+   const byte *decoded = _decoded.ptr();
+   int decoded_size = _decoded.size();
+
+   _decoded_scanner.create(decoded, decoded_size);
+   _scanner = _decoded_scanner.get();
+}
+
+void CmfLoader::decodeMany (LzwDict &dict, const Array<const byte *> &buffers,
+                            const Array<int> &sizes, ObjArray<Molecule> &molecules)
+{
+   if (buffers.size() != sizes.size())
+      throw Error("%d buffers and %d sizes", buffers.size(), sizes.size());
+
+   while (molecules.size() < buffers.size())
+      molecules.push();
+
+   for (int i = 0; i < buffers.size(); i++)
+   {
+      CmfLoader loader(dict, buffers[i], sizes[i]);
+
+      loader.loadMolecule(molecules[i]);
+   }
 }
 
 CmfLoader::CmfLoader (Scanner &scanner) :
@@ -48,6 +95,8 @@ TL_CP_GET(atom_mapping_to_restore),
 TL_CP_GET(inv_atom_mapping_to_restore),
 TL_CP_GET(bond_mapping_to_restore),
 TL_CP_GET(inv_bond_mapping_to_restore),
+TL_CP_GET(_encoded),
+TL_CP_GET(_decoded),
 TL_CP_GET(_atoms),
 TL_CP_GET(_bonds),
 TL_CP_GET(_pseudo_labels),
@@ -64,6 +113,8 @@ TL_CP_GET(atom_mapping_to_restore),
 TL_CP_GET(inv_atom_mapping_to_restore),
 TL_CP_GET(bond_mapping_to_restore),
 TL_CP_GET(inv_bond_mapping_to_restore),
+TL_CP_GET(_encoded),
+TL_CP_GET(_decoded),
 TL_CP_GET(_atoms),
 TL_CP_GET(_bonds),
 TL_CP_GET(_pseudo_labels),
@@ -0,0 +1,60 @@
+/****************************************************************************
+ * Copyright (C) 2009-2015 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#include "molecule/flat_molecule.h"
+#include "molecule/elements.h"
+
+using namespace indigo;
+
+int FlatMolecule::countHeavyAtoms () const
+{
+   int count = 0;
+
+   for (int i = 0; i < atoms.size(); i++)
+      if (atoms[i].number != ELEM_H)
+         count++;
+   return count;
+}
+
+void FlatMolecule::buildNeighbors ()
+{
+   int n = atoms.size(), i;
+
+   nei_offsets.clear_resize(n + 1);
+   nei_offsets.zerofill();
+   nei_atoms.clear_resize(bonds.size() * 2);
+   nei_bonds.clear_resize(bonds.size() * 2);
+
+   for (i = 0; i < bonds.size(); i++)
+   {
+      nei_offsets[bonds[i].beg]++;
+      nei_offsets[bonds[i].end]++;
+   }
+
+   // End of each row at first, then the rows are filled backwards
+   for (i = 1; i <= n; i++)
+      nei_offsets[i] += nei_offsets[i - 1];
+
+   for (i = bonds.size() - 1; i >= 0; i--)
+   {
+      int pos = --nei_offsets[bonds[i].beg];
+
+      nei_atoms[pos] = bonds[i].end;
+      nei_bonds[pos] = i;
+
+      pos = --nei_offsets[bonds[i].end];
+      nei_atoms[pos] = bonds[i].beg;
+      nei_bonds[pos] = i;
+   }
+}
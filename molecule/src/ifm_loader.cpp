@@ -0,0 +1,280 @@
+/****************************************************************************
+ * Copyright (C) 2009-2015 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#include "molecule/ifm_loader.h"
+#include "molecule/ifm_saver.h"
+#include "molecule/molecule.h"
+#include "molecule/elements.h"
+
+using namespace indigo;
+
+IMPL_ERROR(IfmLoader, "IFM loader");
+
+IfmLoader::IfmLoader (const byte *buf, int size)
+{
+   if (buf == 0 || size < (int)sizeof(IfmHeader))
+      throw Error("buffer is too small");
+   if (!IfmSaver::checkVersion((const char *)buf))
+      throw Error("expected '%s' signature", IfmSaver::VERSION);
+
+   if (((size_t)buf & 3) != 0)
+   {
+      // Only the saved molecule is copied, the buffer may hold more data
+      IfmHeader header;
+
+      memcpy(&header, buf, sizeof(header));
+      if (header.byte_order == IFM_BYTE_ORDER && header.size >= sizeof(IfmHeader) &&
+          header.size < (dword)size)
+         size = header.size;
+
+      _aligned.copy(buf, size);
+      buf = _aligned.ptr();
+   }
+
+   _header = (const IfmHeader *)buf;
+
+   if (_header->version != IFM_VERSION)
+      throw Error("unsupported version %d", _header->version);
+   if (_header->byte_order != IFM_BYTE_ORDER)
+      throw Error("byte order mismatch");
+   if (_header->size < sizeof(IfmHeader) || _header->size > (dword)size)
+      throw Error("molecule size is %u, buffer size is %d", _header->size, size);
+
+   _atoms = (const IfmAtom *)_getSection(buf, _header->atoms, _header->atom_count, sizeof(IfmAtom));
+   _bonds = (const IfmBond *)_getSection(buf, _header->bonds, _header->bond_count, sizeof(IfmBond));
+   _stereocenters = (const IfmStereocenter *)_getSection(buf, _header->stereocenters,
+                                                         _header->stereocenter_count, sizeof(IfmStereocenter));
+   _cis_trans = (const IfmCisTrans *)_getSection(buf, _header->cis_trans,
+                                                 _header->cis_trans_count, sizeof(IfmCisTrans));
+   _properties = (const IfmProperty *)_getSection(buf, _header->properties,
+                                                  _header->property_count, sizeof(IfmProperty));
+   _strings = (const IfmString *)_getSection(buf, _header->strings, _header->string_count, sizeof(IfmString));
+   _chars = (const char *)_getSection(buf, _header->chars, _header->chars_size, 1);
+}
+
+const void * IfmLoader::_getSection (const byte *buf, dword offset, dword count, int item_size)
+{
+   if (offset < sizeof(IfmHeader) || (offset & 3) != 0 ||
+       (qword)offset + (qword)count * item_size > _header->size)
+      throw Error("section at %u with %u items is out of the buffer", offset, count);
+
+   return buf + offset;
+}
+
+const char * IfmLoader::_getString (int idx) const
+{
+   if (idx < 0 || idx >= (int)_header->string_count)
+      throw Error("string index %d is out of range", idx);
+
+   const IfmString &str = _strings[idx];
+
+   if ((qword)str.offset + str.length >= _header->chars_size || _chars[str.offset + str.length] != 0)
+      throw Error("string %d is corrupted", idx);
+
+   return _chars + str.offset;
+}
+
+int IfmLoader::size () const
+{
+   return _header->size;
+}
+
+int IfmLoader::atomCount () const
+{
+   return _header->atom_count;
+}
+
+int IfmLoader::bondCount () const
+{
+   return _header->bond_count;
+}
+
+int IfmLoader::stereocenterCount () const
+{
+   return _header->stereocenter_count;
+}
+
+int IfmLoader::cisTransCount () const
+{
+   return _header->cis_trans_count;
+}
+
+int IfmLoader::propertyCount () const
+{
+   return _header->property_count;
+}
+
+bool IfmLoader::haveXyz () const
+{
+   return (_header->flags & IFM_XYZ) != 0;
+}
+
+const IfmAtom & IfmLoader::getAtom (int idx) const
+{
+   if (idx < 0 || idx >= (int)_header->atom_count)
+      throw Error("atom index %d is out of range", idx);
+   return _atoms[idx];
+}
+
+const IfmBond & IfmLoader::getBond (int idx) const
+{
+   if (idx < 0 || idx >= (int)_header->bond_count)
+      throw Error("bond index %d is out of range", idx);
+   return _bonds[idx];
+}
+
+const IfmStereocenter & IfmLoader::getStereocenter (int idx) const
+{
+   if (idx < 0 || idx >= (int)_header->stereocenter_count)
+      throw Error("stereocenter index %d is out of range", idx);
+   return _stereocenters[idx];
+}
+
+const IfmCisTrans & IfmLoader::getCisTrans (int idx) const
+{
+   if (idx < 0 || idx >= (int)_header->cis_trans_count)
+      throw Error("cis-trans bond index %d is out of range", idx);
+   return _cis_trans[idx];
+}
+
+const char * IfmLoader::name () const
+{
+   if (_header->name < 0)
+      return "";
+   return _getString(_header->name);
+}
+
+const char * IfmLoader::grossFormula () const
+{
+   if (_header->gross_formula < 0)
+      return 0;
+   return _getString(_header->gross_formula);
+}
+
+const char * IfmLoader::pseudoAtom (int idx) const
+{
+   const IfmAtom &atom = getAtom(idx);
+
+   if (atom.number != ELEM_PSEUDO)
+      throw Error("atom %d is not a pseudoatom", idx);
+   return _getString(atom.label);
+}
+
+const char * IfmLoader::propertyName (int idx) const
+{
+   if (idx < 0 || idx >= (int)_header->property_count)
+      throw Error("property index %d is out of range", idx);
+   return _getString(_properties[idx].name);
+}
+
+const char * IfmLoader::propertyValue (int idx) const
+{
+   if (idx < 0 || idx >= (int)_header->property_count)
+      throw Error("property index %d is out of range", idx);
+   return _getString(_properties[idx].value);
+}
+
+const char * IfmLoader::findProperty (const char *name) const
+{
+   for (int i = 0; i < (int)_header->property_count; i++)
+      if (strcmp(_getString(_properties[i].name), name) == 0)
+         return _getString(_properties[i].value);
+   return 0;
+}
+
+void IfmLoader::loadMolecule (Molecule &mol) const
+{
+   int atom_count = atomCount();
+   int i, j;
+
+   mol.clear();
+   mol.reserve(atom_count, bondCount());
+
+   for (i = 0; i < atom_count; i++)
+   {
+      const IfmAtom &atom = _atoms[i];
+
+      if (atom.number <= 0 || atom.number == ELEM_MAX || atom.number > ELEM_RSITE)
+         throw Error("atom %d has invalid number %d", i, atom.number);
+
+      int idx = mol.addAtom(atom.number);
+
+      if (atom.number == ELEM_PSEUDO)
+         mol.setPseudoAtom(idx, _getString(atom.label));
+      else if (atom.number == ELEM_RSITE)
+         mol.setRSiteBits(idx, atom.label);
+
+      mol.setAtomXyz(idx, atom.xyz[0], atom.xyz[1], atom.xyz[2]);
+   }
+
+   for (i = 0; i < bondCount(); i++)
+   {
+      const IfmBond &bond = _bonds[i];
+
+      if (bond.beg < 0 || bond.beg >= atom_count || bond.end < 0 || bond.end >= atom_count)
+         throw Error("bond %d has invalid atoms", i);
+
+      int idx = mol.addBond(bond.beg, bond.end, bond.order);
+
+      if (bond.direction != 0)
+         mol.setBondDirection(idx, bond.direction);
+   }
+
+   // Adding bonds resets the calculated hydrogens and radicals of their atoms
+   for (i = 0; i < atom_count; i++)
+   {
+      const IfmAtom &atom = _atoms[i];
+
+      mol.setAtomCharge(i, atom.charge);
+      mol.setAtomIsotope(i, atom.isotope);
+      if (atom.valence >= 0)
+         mol.setExplicitValence(i, atom.valence);
+      if ((atom.flags & IFM_ATOM_H_COUNT) != 0 && atom.number < ELEM_MAX)
+         mol.setImplicitH(i, atom.implicit_h);
+      mol.setAtomRadical(i, atom.radical);
+   }
+
+   for (i = 0; i < stereocenterCount(); i++)
+   {
+      const IfmStereocenter &center = _stereocenters[i];
+
+      if (center.atom < 0 || center.atom >= atom_count)
+         throw Error("stereocenter %d has invalid atom", i);
+      for (j = 0; j < 4; j++)
+         if (center.pyramid[j] < -1 || center.pyramid[j] >= atom_count)
+            throw Error("stereocenter %d has invalid pyramid", i);
+
+      mol.stereocenters.add(center.atom, center.type, center.group, center.pyramid);
+   }
+
+   for (i = 0; i < cisTransCount(); i++)
+   {
+      const IfmCisTrans &ct = _cis_trans[i];
+      int substituents[4];
+
+      if (ct.bond < 0 || ct.bond >= bondCount())
+         throw Error("cis-trans bond %d is invalid", i);
+      for (j = 0; j < 4; j++)
+      {
+         if (ct.substituents[j] < -1 || ct.substituents[j] >= atom_count)
+            throw Error("cis-trans bond %d has invalid substituents", i);
+         substituents[j] = ct.substituents[j];
+      }
+
+      mol.cis_trans.add(ct.bond, substituents, ct.parity);
+   }
+
+   mol.have_xyz = haveXyz();
+   mol.name.readString(name(), true);
+}
@@ -0,0 +1,247 @@
+/****************************************************************************
+ * Copyright (C) 2009-2015 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#include "base_cpp/output.h"
+#include "base_cpp/properties_map.h"
+#include "molecule/ifm_saver.h"
+#include "molecule/ifm_common.h"
+#include "molecule/molecule.h"
+#include "molecule/molecule_gross_formula.h"
+#include "molecule/elements.h"
+
+using namespace indigo;
+
+const char* IfmSaver::VERSION = "IFM";
+
+IMPL_ERROR(IfmSaver, "IFM saver");
+
+bool IfmSaver::checkVersion (const char *prefix)
+{
+   return strncmp(prefix, VERSION, 3) == 0;
+}
+
+IfmSaver::IfmSaver (Output &output) : _output(output)
+{
+   gross_formula_add_rsites = false;
+}
+
+static int _addString (const char *str, Array<IfmString> &strings, Array<char> &chars)
+{
+   IfmString &s = strings.push();
+
+   s.offset = chars.size();
+   s.length = (dword)strlen(str);
+   chars.concat(str, s.length + 1);
+   return strings.size() - 1;
+}
+
+static dword _align (dword offset)
+{
+   return (offset + IFM_ALIGNMENT - 1) & ~(dword)(IFM_ALIGNMENT - 1);
+}
+
+static void _writeSection (Output &output, dword &written, dword offset, const void *data, int size)
+{
+   static const char zeros[IFM_ALIGNMENT] = {0};
+
+   output.write(zeros, offset - written);
+   if (size > 0)
+      output.write(data, size);
+   written = offset + size;
+}
+
+void IfmSaver::saveMolecule (Molecule &mol, PropertiesMap *properties)
+{
+   QS_DEF(Array<int>, atom_mapping);
+   QS_DEF(Array<int>, bond_mapping);
+   QS_DEF(Array<IfmAtom>, atoms);
+   QS_DEF(Array<IfmBond>, bonds);
+   QS_DEF(Array<IfmStereocenter>, stereocenters);
+   QS_DEF(Array<IfmCisTrans>, cis_trans);
+   QS_DEF(Array<IfmProperty>, props);
+   QS_DEF(Array<IfmString>, strings);
+   QS_DEF(Array<char>, chars);
+   QS_DEF(Array<char>, formula);
+   int i, j;
+
+   atoms.clear();
+   bonds.clear();
+   stereocenters.clear();
+   cis_trans.clear();
+   props.clear();
+   strings.clear();
+   chars.clear();
+
+   IfmHeader header;
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.signature, VERSION, 3);
+   header.version = IFM_VERSION;
+   header.byte_order = IFM_BYTE_ORDER;
+   header.flags = mol.have_xyz ? IFM_XYZ : 0;
+   header.name = -1;
+   header.gross_formula = -1;
+
+   if (mol.name.size() > 0 && mol.name[0] != 0)
+      header.name = _addString(mol.name.ptr(), strings, chars);
+
+   // The molecule is saved even if its gross formula can not be calculated
+   try
+   {
+      auto gross = MoleculeGrossFormula::collect(mol);
+
+      formula.clear();
+      MoleculeGrossFormula::toString_Hill(*gross, formula, gross_formula_add_rsites);
+      formula.push(0);
+      header.gross_formula = _addString(formula.ptr(), strings, chars);
+   }
+   catch (Exception &)
+   {
+   }
+
+   atom_mapping.clear_resize(mol.vertexEnd());
+   atom_mapping.fffill();
+
+   for (i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
+   {
+      if (mol.isTemplateAtom(i))
+         throw Error("template atoms are not supported");
+
+      IfmAtom &atom = atoms.push();
+
+      memset(&atom, 0, sizeof(atom));
+      atom_mapping[i] = atoms.size() - 1;
+
+      atom.number = mol.getAtomNumber(i);
+      atom.isotope = mol.getAtomIsotope(i);
+      atom.charge = mol.getAtomCharge(i);
+      atom.valence = mol.isExplicitValenceSet(i) ? mol.getExplicitValence(i) : -1;
+
+      if (mol.getAtomAromaticity(i) == ATOM_AROMATIC)
+         atom.flags |= IFM_ATOM_AROMATIC;
+      if (mol.isPseudoAtom(i))
+      {
+         atom.implicit_h = 0;
+         atom.label = _addString(mol.getPseudoAtom(i), strings, chars);
+      }
+      else if (mol.isRSite(i))
+      {
+         atom.implicit_h = 0;
+         atom.label = mol.getRSiteBits(i);
+      }
+      else
+      {
+         try
+         {
+            atom.radical = mol.getAtomRadical(i);
+         }
+         catch (Element::Error &)
+         {
+         }
+
+         atom.implicit_h = mol.getImplicitH_NoThrow(i, -1);
+         atom.label = -1;
+
+         if (atom.implicit_h >= 0 && Molecule::shouldWriteHCount(mol, i))
+            atom.flags |= IFM_ATOM_H_COUNT;
+      }
+
+      const Vec3f &xyz = mol.getAtomXyz(i);
+
+      atom.xyz[0] = xyz.x;
+      atom.xyz[1] = xyz.y;
+      atom.xyz[2] = xyz.z;
+   }
+
+   bond_mapping.clear_resize(mol.edgeEnd());
+   bond_mapping.fffill();
+
+   for (i = mol.edgeBegin(); i != mol.edgeEnd(); i = mol.edgeNext(i))
+   {
+      const Edge &edge = mol.getEdge(i);
+      IfmBond &bond = bonds.push();
+
+      memset(&bond, 0, sizeof(bond));
+      bond_mapping[i] = bonds.size() - 1;
+
+      bond.beg = atom_mapping[edge.beg];
+      bond.end = atom_mapping[edge.end];
+      bond.order = mol.getBondOrder(i);
+      bond.direction = mol.getBondDirection(i);
+
+      int parity = mol.cis_trans.getParity(i);
+
+      if (parity != 0)
+      {
+         IfmCisTrans &ct = cis_trans.push();
+         const int *substituents = mol.cis_trans.getSubstituents(i);
+
+         ct.bond = bond_mapping[i];
+         ct.parity = parity;
+         for (j = 0; j < 4; j++)
+            ct.substituents[j] = substituents[j] >= 0 ? atom_mapping[substituents[j]] : -1;
+      }
+   }
+
+   for (i = mol.stereocenters.begin(); i != mol.stereocenters.end(); i = mol.stereocenters.next(i))
+   {
+      IfmStereocenter &center = stereocenters.push();
+      int atom_idx, pyramid[4];
+
+      mol.stereocenters.get(i, atom_idx, center.type, center.group, pyramid);
+      center.atom = atom_mapping[atom_idx];
+      for (j = 0; j < 4; j++)
+         center.pyramid[j] = pyramid[j] >= 0 ? atom_mapping[pyramid[j]] : -1;
+   }
+
+   if (properties != 0)
+   {
+      for (auto p : properties->elements())
+      {
+         IfmProperty &prop = props.push();
+
+         prop.name = _addString(properties->key(p), strings, chars);
+         prop.value = _addString(properties->value(p), strings, chars);
+      }
+   }
+
+   header.atom_count = atoms.size();
+   header.bond_count = bonds.size();
+   header.stereocenter_count = stereocenters.size();
+   header.cis_trans_count = cis_trans.size();
+   header.property_count = props.size();
+   header.string_count = strings.size();
+   header.chars_size = chars.size();
+
+   header.atoms = _align(sizeof(IfmHeader));
+   header.bonds = _align(header.atoms + atoms.sizeInBytes());
+   header.stereocenters = _align(header.bonds + bonds.sizeInBytes());
+   header.cis_trans = _align(header.stereocenters + stereocenters.sizeInBytes());
+   header.properties = _align(header.cis_trans + cis_trans.sizeInBytes());
+   header.strings = _align(header.properties + props.sizeInBytes());
+   header.chars = _align(header.strings + strings.sizeInBytes());
+   header.size = _align(header.chars + chars.size());
+
+   dword written = 0;
+
+   _writeSection(_output, written, 0, &header, sizeof(header));
+   _writeSection(_output, written, header.atoms, atoms.ptr(), atoms.sizeInBytes());
+   _writeSection(_output, written, header.bonds, bonds.ptr(), bonds.sizeInBytes());
+   _writeSection(_output, written, header.stereocenters, stereocenters.ptr(), stereocenters.sizeInBytes());
+   _writeSection(_output, written, header.cis_trans, cis_trans.ptr(), cis_trans.sizeInBytes());
+   _writeSection(_output, written, header.properties, props.ptr(), props.sizeInBytes());
+   _writeSection(_output, written, header.strings, strings.ptr(), strings.sizeInBytes());
+   _writeSection(_output, written, header.chars, chars.ptr(), chars.size());
+   _writeSection(_output, written, header.size, 0, 0);
+}
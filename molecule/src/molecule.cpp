@@ -58,6 +58,20 @@ void Molecule::clear ()
    updateEditRevision();
 }
 
+void Molecule::reserve (int atoms, int bonds)
+{
+   if (atoms > 0)
+   {
+      _atoms.reserve(vertexEnd() + atoms);
+      _radicals.reserve(vertexEnd() + atoms);
+   }
+
+   if (bonds > 0)
+      _bond_orders.reserve(edgeEnd() + bonds);
+
+   BaseMolecule::reserve(atoms, bonds);
+}
+
 void Molecule::_flipBond (int atom_parent, int atom_from, int atom_to)
 {
    int src_bond_idx = findEdgeIndex(atom_parent, atom_from);
@@ -379,6 +379,13 @@ void MoleculeCisTrans::registerBond (int idx)
    _bonds[idx].clear();
 }
 
+void MoleculeCisTrans::reserve (int bonds)
+{
+   // Bonds are indexed by the edge index, which can be past _bonds.size()
+   if (bonds > 0)
+      _bonds.reserve(_getMolecule().edgeEnd() + bonds);
+}
+
 void MoleculeCisTrans::validate ()
 {
    BaseMolecule &mol = _getMolecule();
@@ -34,7 +34,7 @@ CP_DEF(MoleculeFingerprintBuilder);
 MoleculeFingerprintBuilder::MoleculeFingerprintBuilder (BaseMolecule &mol,
                      const MoleculeFingerprintParameters &parameters):
 cancellation(0),
-_mol(mol),
+_mol(&mol),
 _parameters(parameters), 
 CP_INIT,
 TL_CP_GET(_total_fingerprint),
@@ -69,7 +69,7 @@ TL_CP_GET(_ord_hashes)
 
 void MoleculeFingerprintBuilder::_initHashCalculations (BaseMolecule &mol, const Filter &vfilter)
 {
-   subgraph_hash.create(mol);
+   subgraph_hash.recreate(mol);
 
    _atom_codes.clear_resize(mol.vertexEnd());
    _atom_codes_empty.clear_resize(mol.vertexEnd());
@@ -169,7 +169,14 @@ MoleculeFingerprintBuilder::~MoleculeFingerprintBuilder ()
 void MoleculeFingerprintBuilder::process ()
 {
    _total_fingerprint.zerofill();
-   _makeFingerprint(_mol);
+   _ord_hashes.clear();
+   _makeFingerprint(*_mol);
+}
+
+void MoleculeFingerprintBuilder::process (BaseMolecule &mol)
+{
+   _mol = &mol;
+   process();
 }
 /*
  * Accepted types: 'sim', 'sub', 'sub-res', 'sub-tau', 'full'
@@ -304,13 +311,7 @@ dword MoleculeFingerprintBuilder::_canonicalizeFragment (BaseMolecule &mol, cons
 
 void MoleculeFingerprintBuilder::_addOrdHashBits (dword hash, int bits_per_fragment)
 {
-   HashBits hash_bits(hash, bits_per_fragment);
-
-   auto it = _ord_hashes.find(hash_bits);
-   if (it == _ord_hashes.end())
-      _ord_hashes.emplace(hash_bits, 1);
-   else
-      _ord_hashes.at(hash_bits)++;
+   _ord_hashes.add(hash, bits_per_fragment);
 }
 
 void MoleculeFingerprintBuilder::_calculateFragmentVertexDegree (BaseMolecule &mol, const Array<int> &vertices, const Array<int> &edges)
@@ -581,14 +582,15 @@ void MoleculeFingerprintBuilder::_makeFingerprint (BaseMolecule &mol)
       se.process();
 
       // Set hash bits
-      for (auto it : _ord_hashes)
+      for (int i = 0; i < _ord_hashes.size(); i++)
       {
-         int bits_per_fragment = it.first.bits_per_fragment + (bitLog2Dword(it.second) - 1);
+         const OrdHashes::Entry &entry = _ord_hashes.at(i);
+         int bits_per_fragment = entry.bits_per_fragment + (bitLog2Dword(entry.count) - 1);
          // Heuristic: if a fragment has high frequency and they are close to each other (like in substructure query)
          // then there should be larger fragment with lower frequency
          if (bits_per_fragment > 8)
             bits_per_fragment = 8;
-         _setBits(it.first.hash, getOrd(), _parameters.fingerprintSizeOrd(), bits_per_fragment);
+         _setBits(entry.hash, getOrd(), _parameters.fingerprintSizeOrd(), bits_per_fragment);
       }
    }
    
@@ -716,23 +718,66 @@ int MoleculeFingerprintBuilder::countBits_Sim ()
 }
 
 //
-// MoleculeFingerprintBuilder::HashBits
+// MoleculeFingerprintBuilder::OrdHashes
 //
 
-MoleculeFingerprintBuilder::HashBits::HashBits (dword hash, int bits_per_fragment) : 
-   hash(hash), bits_per_fragment(bits_per_fragment)
+void MoleculeFingerprintBuilder::OrdHashes::clear ()
 {
+   for (int i = 0; i < _used.size(); i++)
+      _table[_used[i]].count = 0;
+   _used.clear();
 }
 
-bool MoleculeFingerprintBuilder::HashBits::operator== (const HashBits &right) const
+int MoleculeFingerprintBuilder::OrdHashes::_findSlot (dword hash, int bits_per_fragment) const
 {
-   return right.bits_per_fragment == bits_per_fragment && right.hash == hash;
+   int mask = _table.size() - 1;
+   int slot = (int)(((hash + bits_per_fragment * 0x9E3779B9U) * 0x85EBCA6BU) >> 7) & mask;
+
+   // Linear probing, empty entries have zero count
+   while (_table[slot].count != 0 &&
+          (_table[slot].hash != hash || _table[slot].bits_per_fragment != bits_per_fragment))
+      slot = (slot + 1) & mask;
+
+   return slot;
 }
 
-//
-// MoleculeFingerprintBuilder::Hasher
-//
-size_t MoleculeFingerprintBuilder::Hasher::operator () (const HashBits &input) const
+void MoleculeFingerprintBuilder::OrdHashes::_resize (int capacity)
+{
+   QS_DEF(Array<Entry>, entries);
+   int i;
+
+   entries.clear();
+   for (i = 0; i < _used.size(); i++)
+      entries.push(_table[_used[i]]);
+
+   _table.clear_resize(capacity);
+   for (i = 0; i < capacity; i++)
+      _table[i].count = 0;
+   _used.clear();
+
+   for (i = 0; i < entries.size(); i++)
+   {
+      int slot = _findSlot(entries[i].hash, entries[i].bits_per_fragment);
+
+      _table[slot] = entries[i];
+      _used.push(slot);
+   }
+}
+
+void MoleculeFingerprintBuilder::OrdHashes::add (dword hash, int bits_per_fragment)
 {
-   return (input.bits_per_fragment << 10) + input.hash;
+   // Keep the load factor below 1/2
+   if (2 * (_used.size() + 1) > _table.size())
+      _resize(__max(256, 2 * _table.size()));
+
+   int slot = _findSlot(hash, bits_per_fragment);
+   Entry &entry = _table[slot];
+
+   if (entry.count == 0)
+   {
+      entry.hash = hash;
+      entry.bits_per_fragment = bits_per_fragment;
+      _used.push(slot);
+   }
+   entry.count++;
 }
@@ -22,6 +22,7 @@
 #include "molecule/molecule_gross_formula.h"
 #include "molecule/molecule.h"
 #include "molecule/query_molecule.h"
+#include "molecule/flat_molecule.h"
 
 using namespace indigo;
 
@@ -157,6 +158,21 @@ std::unique_ptr<GROSS_UNITS> MoleculeGrossFormula::collect(BaseMolecule &mol) {
    return result;
 }
 
+std::unique_ptr<GROSS_UNITS> MoleculeGrossFormula::collect (const FlatMolecule &mol) {
+   std::unique_ptr<GROSS_UNITS> result(new GROSS_UNITS());
+   auto& unit = result->push();
+
+   unit.multiplier.appendString(" ", true);
+   unit.elems.clear_resize(ELEM_RSITE + 1);
+   unit.elems.zerofill();
+
+   for (int i = 0; i < mol.atomCount(); i++) {
+      unit.elems[mol.atoms[i].number]++;
+      unit.elems[ELEM_H] += mol.atoms[i].implicit_h;
+   }
+   return result;
+}
+
 void MoleculeGrossFormula::toString (const Array<int> &gross, Array<char> &str, bool add_rsites) {
    ArrayOutput output(str);
    _toString(gross, output, _cmp, add_rsites);
@@ -73,6 +73,7 @@ TL_CP_GET(_used_target_h)
    _query = 0;
    match_3d = 0;
    rms_threshold = 0;
+   use_candidate_sets = false;
 
    highlight = false;
    find_all_embeddings = false;
@@ -334,6 +335,13 @@ bool MoleculeSubstructureMatcher::find ()
    _3d_constraints_checker.recreate(_query->spatial_constraints);
    _createEmbeddingsStorage();
 
+   // R-group fragments are attached to the query during the search,
+   // so the candidates can't be found in advance
+   if (use_candidate_sets && _markush.get() == 0)
+      _ee->cb_candidate_vertex = _matchAtomsStatic;
+   else
+      _ee->cb_candidate_vertex = 0;
+
    int result = _ee->process();
 
    if (_h_unfold && restore_unfolded_h)
@@ -590,6 +598,71 @@ bool MoleculeSubstructureMatcher::_matchAtoms(Graph &subgraph, Graph &supergraph
 {
    MoleculeSubstructureMatcher *self = (MoleculeSubstructureMatcher *)userdata;
 
+   // Pairs from the candidate sets have been checked when the sets were built
+   bool known_candidate = (&subgraph == (Graph *)self->_query && self->_ee.get() != 0 &&
+                           self->_ee->isKnownCandidate(sub_idx, super_idx));
+
+   if (!known_candidate && !_matchAtomsStatic(subgraph, supergraph, sub_idx, super_idx, userdata))
+      return false;
+
+   QueryMolecule &query = (QueryMolecule &)subgraph;
+   BaseMolecule &target  = (BaseMolecule &)supergraph;
+
+   if (query.components.size() > sub_idx && query.components[sub_idx] > 0)
+   {
+      int i;
+
+      for (i = query.vertexBegin(); i != query.vertexEnd(); i = query.vertexNext(i))
+      {
+         if (i == sub_idx)
+            continue;
+
+         if (core_sub[i] < 0)
+            continue;
+
+         if (query.components.size() <= i || query.components[i] <= 0)
+            continue;
+
+         if (query.components[i] == query.components[sub_idx] &&
+             target.vertexComponent(core_sub[i]) != target.vertexComponent(super_idx))
+            return false;
+         if (query.components[i] != query.components[sub_idx] &&
+             target.vertexComponent(core_sub[i]) == target.vertexComponent(super_idx))
+            return false;
+      }
+   }
+
+   if (self->match_3d == AFFINE)
+   {
+      QS_DEF(Array<int>, core_sub_full);
+
+      core_sub_full.copy(core_sub, subgraph.vertexEnd());
+      core_sub_full[sub_idx] = super_idx;
+
+      GraphAffineMatcher matcher(subgraph, supergraph, core_sub_full.ptr());
+
+      matcher.cb_get_xyz = getAtomPos;
+
+      int total_fixed = query.vertexCount();
+
+      if (query.fixed_atoms.size() > 0)
+      {
+         matcher.fixed_vertices = &query.fixed_atoms;
+         total_fixed = query.fixed_atoms.size();
+      }
+
+      if (!matcher.match(self->rms_threshold * sqrt((float)total_fixed)))
+         return false;
+   }
+
+   return true;
+}
+
+bool MoleculeSubstructureMatcher::_matchAtomsStatic (Graph &subgraph, Graph &supergraph,
+                                                    int sub_idx, int super_idx, void *userdata)
+{
+   MoleculeSubstructureMatcher *self = (MoleculeSubstructureMatcher *)userdata;
+
    if (self->_h_unfold && (&subgraph == (Graph *)self->_query))
    {
       if (sub_idx < self->_3d_constrained_atoms.size() && self->_3d_constrained_atoms[sub_idx])
@@ -635,30 +708,6 @@ bool MoleculeSubstructureMatcher::_matchAtoms(Graph &subgraph, Graph &supergraph
             return false;
    }
 
-   if (query.components.size() > sub_idx && query.components[sub_idx] > 0)
-   {
-      int i;
-
-      for (i = query.vertexBegin(); i != query.vertexEnd(); i = query.vertexNext(i))
-      {
-         if (i == sub_idx)
-            continue;
-
-         if (core_sub[i] < 0)
-            continue;
-
-         if (query.components.size() <= i || query.components[i] <= 0)
-            continue;
-
-         if (query.components[i] == query.components[sub_idx] &&
-             target.vertexComponent(core_sub[i]) != target.vertexComponent(super_idx))
-            return false;
-         if (query.components[i] != query.components[sub_idx] &&
-             target.vertexComponent(core_sub[i]) == target.vertexComponent(super_idx))
-            return false;
-      }
-   }
-
    QueryMolecule::Atom &sub_atom = query.getAtom(sub_idx);
 
    if (!matchQueryAtom(&sub_atom, target, super_idx, self->fmcache, match_atoms_flags))
@@ -676,29 +725,6 @@ bool MoleculeSubstructureMatcher::_matchAtoms(Graph &subgraph, Graph &supergraph
          return false;
    }
 
-   if (self->match_3d == AFFINE)
-   {
-      QS_DEF(Array<int>, core_sub_full);
-
-      core_sub_full.copy(core_sub, subgraph.vertexEnd());
-      core_sub_full[sub_idx] = super_idx;
-
-      GraphAffineMatcher matcher(subgraph, supergraph, core_sub_full.ptr());
-
-      matcher.cb_get_xyz = getAtomPos;
-
-      int total_fixed = query.vertexCount();
-
-      if (query.fixed_atoms.size() > 0)
-      {
-         matcher.fixed_vertices = &query.fixed_atoms;
-         total_fixed = query.fixed_atoms.size();
-      }
-
-      if (!matcher.match(self->rms_threshold * sqrt((float)total_fixed)))
-         return false;
-   }
-
    return true;
 }
 
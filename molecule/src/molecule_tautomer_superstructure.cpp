@@ -44,7 +44,8 @@ TL_CP_GET(_isBondAttachedArray),
 TL_CP_GET(_mapping),
 TL_CP_GET(_inv_mapping),
 TL_CP_GET(_edge_mapping),
-TL_CP_GET(_total_h)
+TL_CP_GET(_total_h),
+TL_CP_GET(_attached_bonds_count)
 {
    int i;
 
@@ -52,6 +53,10 @@ TL_CP_GET(_total_h)
 
    clone(mol, &_inv_mapping, &_mapping);
 
+   // The pooled array may hold counters of another structure
+   _attached_bonds_count.clear_resize(vertexEnd());
+   _attached_bonds_count.zerofill();
+
    _edge_mapping.clear_resize(edgeEnd());
    _edge_mapping.fffill();
 
@@ -140,13 +145,14 @@ int TautomerSuperStructure::getSubgraphType (const Array<int> &vertices, const A
 {
    // For any atoms number of attached bonds must be 0 or 1
 
-   QS_DEF(Array<int>, per_vertex_attached_bonds);
-
-   per_vertex_attached_bonds.clear_resize(vertexEnd());
-   per_vertex_attached_bonds.zerofill();
+   // This method is called for every fragment, so the counters are
+   // zeroed once in the constructor and reset after the check
 
    int attached_bonds = 0;
-   for (int i = 0; i < edges.size(); i++)
+   bool valid = true;
+   int i;
+
+   for (i = 0; i < edges.size(); i++)
    {
       int edge_index = edges[i];
 
@@ -154,13 +160,26 @@ int TautomerSuperStructure::getSubgraphType (const Array<int> &vertices, const A
          continue;
 
       const Edge &edge = getEdge(edge_index);
-      per_vertex_attached_bonds[edge.beg]++;
-      per_vertex_attached_bonds[edge.end]++;
-      if (per_vertex_attached_bonds[edge.beg] > 1 || per_vertex_attached_bonds[edge.end] > 1)
-         return NONE;
+      _attached_bonds_count[edge.beg]++;
+      _attached_bonds_count[edge.end]++;
+      if (_attached_bonds_count[edge.beg] > 1 || _attached_bonds_count[edge.end] > 1)
+         valid = false;
       attached_bonds++;
    }
 
+   if (attached_bonds != 0)
+   {
+      for (i = 0; i < edges.size(); i++)
+      {
+         const Edge &edge = getEdge(edges[i]);
+
+         _attached_bonds_count[edge.beg] = 0;
+         _attached_bonds_count[edge.end] = 0;
+      }
+   }
+
+   if (!valid)
+      return NONE;
    if (attached_bonds == 0)
       return ORIGINAL;
    return TAUTOMER;
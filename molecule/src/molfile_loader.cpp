@@ -3041,6 +3041,9 @@ void MolfileLoader::_readSGroupsBlock3000 ()
 void MolfileLoader::_fillSGroupsParentIndices() {
    MoleculeSGroups &sgroups = _bmol->sgroups;
 
+   if (sgroups.getSGroupCount() == 0)
+      return;
+
    MultiMap<int,int> indices;
    //original index can be arbitrary, sometimes key is used multiple times
    
@@ -3807,6 +3810,10 @@ void MolfileLoader::_readSGroupDisplay (Scanner &scanner, DataSGroup &dsg)
 
 void MolfileLoader::_init ()
 {
+   // The numbers of atoms and bonds are known from the counts line, so the
+   // arrays of the molecule are allocated once
+   _bmol->reserve(_atoms_num, _bonds_num);
+
    _hcount.clear();
    _atom_types.clear();
    _sgroup_types.clear();
@@ -23,7 +23,7 @@ IMPL_ERROR(RdfLoader, "RDF loader");
 
 CP_DEF(RdfLoader);
 
-RdfLoader::RdfLoader(Scanner &scanner) :
+RdfLoader::RdfLoader(Scanner &scanner, int gzip_threads) :
 CP_INIT,
 TL_CP_GET(data),
 TL_CP_GET(properties),
@@ -45,13 +45,14 @@ TL_CP_GET(_offsets) {
    scanner.seek(pos, SEEK_SET);
 
    if (id[0] == 0x1f && id[1] == 0x8b) {
-      _scanner = new GZipScanner(scanner);
+      _scanner = new GZipScanner(scanner, gzip_threads);
       _ownScanner = true;
    } else {
       _scanner = &scanner;
       _ownScanner = false;
    }
 
+   _innerBufferOffset = 0LL;
    _current_number = 0;
    _max_offset = 0LL;
    _offsets.clear();
@@ -67,11 +68,12 @@ bool RdfLoader::isEOF() {
 }
 
 int RdfLoader::count () {
-   long long offset = _scanner->tell();
+   long long offset = _recordStart();
    int cn = _current_number;
 
    if (offset != _max_offset) {
       _scanner->seek(_max_offset, SEEK_SET);
+      _innerBuffer.clear();
       _current_number = _offsets.size();
    }
 
@@ -82,6 +84,7 @@ int RdfLoader::count () {
 
    if (res != cn) {
       _scanner->seek(offset, SEEK_SET);
+      _innerBuffer.clear();
       _current_number = cn;
    }
 
@@ -98,7 +101,7 @@ void RdfLoader::readNext() {
       throw Error("end of stream");
 
    _offsets.expand(_current_number + 1);
-   _offsets[_current_number++] = _scanner->tell();
+   _offsets[_current_number++] = _recordStart();
 
    /*
     * Read data
@@ -147,7 +150,7 @@ void RdfLoader::readNext() {
       if(data.size() > MAX_DATA_SIZE)
          throw Error("data size exceeded the acceptable size %d bytes, Please check for correct file format", MAX_DATA_SIZE);
 
-   } while(_readLine(_getScanner(), _innerBuffer));
+   } while(_readInnerLine());
 
    /*
     * Current value for property reading
@@ -207,10 +210,10 @@ void RdfLoader::readNext() {
          current_datum->appendString(_innerBuffer.ptr(), true);
       }
       
-   } while(_readLine(_getScanner(), _innerBuffer));
+   } while(_readInnerLine());
 
-   if (_scanner->tell() > _max_offset)
-      _max_offset = _scanner->tell();
+   if (_recordStart() > _max_offset)
+      _max_offset = _recordStart();
 }
 
 Scanner& RdfLoader::_getScanner() const {
@@ -261,6 +264,20 @@ bool RdfLoader::_readIdentifiers(bool from_begin) {
    return result;
 }
 
+bool RdfLoader::_readInnerLine() {
+   _innerBufferOffset = _scanner->tell();
+   return _readLine(*_scanner, _innerBuffer);
+}
+
+long long RdfLoader::_recordStart() const {
+   /*
+    * The line in the inner buffer is already read from the scanner
+    */
+   if (_innerBuffer.size() > 0)
+      return _innerBufferOffset;
+   return _scanner->tell();
+}
+
 bool RdfLoader::_readLine(Scanner& scanner, Array<char>& buffer) {
    buffer.clear();
    if(scanner.isEOF())
@@ -282,6 +299,7 @@ void RdfLoader::readAt (int index)
    if (index < _offsets.size())
    {
       _scanner->seek(_offsets[index], SEEK_SET);
+      _innerBuffer.clear();
       _current_number = index;
       readNext();
    }
@@ -292,6 +310,7 @@ void RdfLoader::readAt (int index)
          throw Error("No such record index: %d", index);
       }
 
+      _innerBuffer.clear();
       _current_number = _offsets.size();
       do
       {
@@ -299,3 +318,67 @@ void RdfLoader::readAt (int index)
       } while (index + 1 != _offsets.size());
    }
 }
+
+const Array<long long> & RdfLoader::offsets () {
+   return _offsets;
+}
+
+void RdfLoader::setOffsets (const Array<long long> &offsets, long long end_offset) {
+   _offsets.copy(offsets);
+   _max_offset = end_offset;
+}
+
+long long RdfLoader::endOffset () {
+   return _max_offset;
+}
+
+bool RdfLoader::isCompressed () {
+   return _ownScanner;
+}
+
+void RdfLoader::findRecordBoundaries (Scanner &scanner, long long end, Array<long long> &boundaries) {
+   QS_DEF(Array<char>, str);
+
+   while (!scanner.isEOF() && scanner.tell() < end) {
+      long long offset = scanner.tell();
+
+      scanner.readLine(str, true);
+      if (strncmp(str.ptr(), "$MFMT", 5) == 0 || strncmp(str.ptr(), "$RFMT", 5) == 0)
+         boundaries.push(offset);
+   }
+}
+
+void RdfLoader::boundariesToOffsets (Scanner &scanner, Array<long long> &boundaries) {
+   QS_DEF(Array<char>, str);
+
+   if (scanner.length() == 0) {
+      boundaries.clear();
+      return;
+   }
+
+   /*
+    * The first record starts at the beginning. It includes the first
+    * "$MFMT" or "$RFMT" line unless there is some data before it.
+    */
+   long long first = boundaries.size() > 0 ? boundaries[0] : scanner.length();
+   bool header_only = true;
+
+   scanner.seek(0, SEEK_SET);
+   while (scanner.tell() < first) {
+      scanner.readLine(str, true);
+      if (strncmp(str.ptr(), "$RDFILE", 7) != 0 && strncmp(str.ptr(), "$DATM", 5) != 0) {
+         header_only = false;
+         break;
+      }
+   }
+
+   if (boundaries.size() > 0 && header_only) {
+      boundaries[0] = 0;
+      return;
+   }
+
+   boundaries.push(0);
+   for (int i = boundaries.size() - 1; i > 0; i--)
+      boundaries[i] = boundaries[i - 1];
+   boundaries[0] = 0;
+}
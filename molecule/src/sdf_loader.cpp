@@ -23,7 +23,7 @@ IMPL_ERROR(SdfLoader, "SDF loader");
 
 CP_DEF(SdfLoader);
 
-SdfLoader::SdfLoader (Scanner &scanner) :
+SdfLoader::SdfLoader (Scanner &scanner, int gzip_threads) :
 CP_INIT,
 TL_CP_GET(data),
 TL_CP_GET(properties),
@@ -42,7 +42,7 @@ TL_CP_GET(_preread)
 
    if (id[0] == 0x1f && id[1] == 0x8b)
    {
-      _scanner = new GZipScanner(scanner);
+      _scanner = new GZipScanner(scanner, gzip_threads);
       _own_scanner = true;
    }
    else
@@ -249,3 +249,59 @@ void SdfLoader::readAt (int index)
       } while (index + 1 != _offsets.size());
    }
 }
+
+const Array<long long> & SdfLoader::offsets ()
+{
+   return _offsets;
+}
+
+void SdfLoader::setOffsets (const Array<long long> &offsets, long long end_offset)
+{
+   _offsets.copy(offsets);
+   _max_offset = end_offset;
+}
+
+long long SdfLoader::endOffset ()
+{
+   return _max_offset;
+}
+
+bool SdfLoader::isCompressed ()
+{
+   return _own_scanner;
+}
+
+void SdfLoader::findRecordBoundaries (Scanner &scanner, long long end, Array<long long> &boundaries)
+{
+   QS_DEF(Array<char>, str);
+
+   while (!scanner.isEOF() && scanner.tell() < end)
+   {
+      scanner.readLine(str, true);
+      if (str.size() > 3 && strncmp(str.ptr(), "$$$$", 4) == 0)
+         boundaries.push(scanner.tell());
+   }
+}
+
+void SdfLoader::boundariesToOffsets (Scanner &scanner, Array<long long> &boundaries)
+{
+   // Spaces after the last "$$$$" line are not a record, the same as in isEOF()
+   if (boundaries.size() > 0)
+   {
+      scanner.seek(boundaries.top(), SEEK_SET);
+      scanner.skipSpace();
+      if (scanner.isEOF())
+         boundaries.pop();
+   }
+
+   // The first record starts at the beginning unless the input is empty
+   scanner.seek(0, SEEK_SET);
+   scanner.skipSpace();
+   if (scanner.isEOF())
+      return;
+
+   boundaries.push(0);
+   for (int i = boundaries.size() - 1; i > 0; i--)
+      boundaries[i] = boundaries[i - 1];
+   boundaries[0] = 0;
+}
@@ -0,0 +1,598 @@
+/****************************************************************************
+ * Copyright (C) 2009-2015 EPAM Systems
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * This file may be distributed and/or modified under the terms of the
+ * GNU General Public License version 3 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ ***************************************************************************/
+
+#include "molecule/smiles_flat_loader.h"
+#include "molecule/base_molecule.h"
+#include "molecule/elements.h"
+#include "base_cpp/tlscont.h"
+
+#include <ctype.h>
+
+using namespace indigo;
+
+// Maximum number of attempts to find Kekule structure before giving up
+static const int _MAX_MATCHING_STEPS = 10000;
+
+CP_DEF(SmilesFlatLoader);
+
+SmilesFlatLoader::SmilesFlatLoader () :
+CP_INIT,
+TL_CP_GET(_closures),
+TL_CP_GET(_branches),
+TL_CP_GET(_bond_types),
+TL_CP_GET(_closure_bonds),
+TL_CP_GET(_parents),
+TL_CP_GET(_parent_bonds),
+TL_CP_GET(_depths),
+TL_CP_GET(_brackets),
+TL_CP_GET(_ring_bonds),
+TL_CP_GET(_ring_systems),
+TL_CP_GET(_aliphatic_systems),
+TL_CP_GET(_need_double),
+TL_CP_GET(_matching)
+{
+   _str = 0;
+   _len = 0;
+   _pos = 0;
+}
+
+bool SmilesFlatLoader::load (const char *smiles, int length, FlatMolecule &mol)
+{
+   _str = smiles;
+   _len = length;
+   _pos = 0;
+
+   if (!_parse(mol))
+      return false;
+
+   mol.buildNeighbors();
+
+   return _markRingBonds(mol) && _setBondOrders(mol) && _setHydrogens(mol);
+}
+
+bool SmilesFlatLoader::_parse (FlatMolecule &mol)
+{
+   mol.clear();
+   _branches.clear();
+   _bond_types.clear();
+   _closure_bonds.clear();
+   _parents.clear();
+   _parent_bonds.clear();
+   _depths.clear();
+   _brackets.clear();
+
+   _closures.clear_resize(100);
+   for (int i = 0; i < _closures.size(); i++)
+      _closures[i].atom = -1;
+
+   int prev = -1;
+   int bond_type = _NO_BOND;
+   bool has_bond = false;
+
+   while (_pos < _len && !isspace(_str[_pos]))
+   {
+      char c = _str[_pos];
+
+      if (c == '(')
+      {
+         if (prev < 0 || has_bond)
+            return false;
+         _branches.push(prev);
+         _pos++;
+      }
+      else if (c == ')')
+      {
+         if (_branches.size() == 0 || has_bond)
+            return false;
+         prev = _branches.pop();
+         _pos++;
+      }
+      else if (c == '.')
+      {
+         if (has_bond || _branches.size() > 0)
+            return false;
+         prev = -1;
+         _pos++;
+      }
+      else if (strchr("-=#:/\\", c) != 0)
+      {
+         if (has_bond || prev < 0)
+            return false;
+
+         if (c == '-')
+            bond_type = BOND_SINGLE;
+         else if (c == '=')
+            bond_type = BOND_DOUBLE;
+         else if (c == '#')
+            bond_type = BOND_TRIPLE;
+         else if (c == ':')
+            bond_type = BOND_AROMATIC;
+         else
+            bond_type = _DIRECTED_BOND;
+         has_bond = true;
+         _pos++;
+      }
+      else if (isdigit(c) || c == '%')
+      {
+         int number;
+
+         if (c == '%')
+         {
+            if (_pos + 2 >= _len || !isdigit(_str[_pos + 1]) || !isdigit(_str[_pos + 2]))
+               return false;
+            number = (_str[_pos + 1] - '0') * 10 + _str[_pos + 2] - '0';
+            _pos += 3;
+         }
+         else
+         {
+            number = c - '0';
+            _pos++;
+         }
+
+         if (prev < 0)
+            return false;
+
+         _Closure &closure = _closures[number];
+         int type = has_bond ? bond_type : _NO_BOND;
+
+         if (closure.atom < 0)
+         {
+            closure.atom = prev;
+            closure.bond_type = type;
+         }
+         else
+         {
+            if (closure.bond_type != _NO_BOND)
+            {
+               if (type != _NO_BOND && type != closure.bond_type)
+                  return false;
+               type = closure.bond_type;
+            }
+
+            if (closure.atom == prev)
+               return false;
+
+            // Two bonds between the same atoms
+            for (int i = 0; i < mol.bonds.size(); i++)
+            {
+               const FlatMolecule::Bond &bond = mol.bonds[i];
+
+               if ((bond.beg == prev && bond.end == closure.atom) ||
+                   (bond.end == prev && bond.beg == closure.atom))
+                  return false;
+            }
+
+            FlatMolecule::Bond &bond = mol.bonds.push();
+
+            bond.beg = closure.atom;
+            bond.end = prev;
+            _bond_types.push(type);
+            _closure_bonds.push(mol.bonds.size() - 1);
+            closure.atom = -1;
+         }
+         has_bond = false;
+      }
+      else
+      {
+         FlatMolecule::Atom &atom = mol.atoms.push();
+         bool bracket;
+
+         if (!_readAtom(atom, bracket))
+            return false;
+
+         int idx = mol.atoms.size() - 1;
+
+         _brackets.push(bracket ? 1 : 0);
+         _parents.push(prev);
+         _depths.push(prev < 0 ? 0 : _depths[prev] + 1);
+         _parent_bonds.push(-1);
+
+         if (prev >= 0)
+         {
+            FlatMolecule::Bond &bond = mol.bonds.push();
+
+            bond.beg = prev;
+            bond.end = idx;
+            _bond_types.push(has_bond ? bond_type : _NO_BOND);
+            _parent_bonds[idx] = mol.bonds.size() - 1;
+         }
+         else if (has_bond)
+            return false;
+
+         prev = idx;
+         has_bond = false;
+      }
+   }
+
+   if (has_bond || _branches.size() > 0)
+      return false;
+
+   for (int i = 0; i < _closures.size(); i++)
+      if (_closures[i].atom >= 0)
+         return false;
+
+   // The rest is the name unless it is a CXSMILES extension
+   while (_pos < _len && isspace(_str[_pos]))
+      _pos++;
+
+   return _pos == _len || _str[_pos] != '|';
+}
+
+bool SmilesFlatLoader::_readAtom (FlatMolecule::Atom &atom, bool &bracket)
+{
+   char c = _str[_pos];
+
+   atom.charge = 0;
+   atom.isotope = 0;
+   atom.implicit_h = -1;
+   atom.aromatic = false;
+
+   bracket = (c == '[');
+   if (bracket)
+      return _readBracketAtom(atom);
+
+   char next = (_pos + 1 < _len) ? _str[_pos + 1] : 0;
+
+   _pos++;
+   if (c == 'B' && next == 'r')
+   {
+      atom.number = ELEM_Br;
+      _pos++;
+   }
+   else if (c == 'C' && next == 'l')
+   {
+      atom.number = ELEM_Cl;
+      _pos++;
+   }
+   else if (strchr("BCNOPSFI", c) != 0)
+      atom.number = Element::fromTwoChars2(c, 0);
+   else if (strchr("cnops", c) != 0)
+   {
+      atom.number = Element::fromTwoChars2(toupper(c), 0);
+      atom.aromatic = true;
+   }
+   else
+      return false;
+
+   return true;
+}
+
+bool SmilesFlatLoader::_readBracketAtom (FlatMolecule::Atom &atom)
+{
+   // Skip '['
+   _pos++;
+
+   while (_pos < _len && isdigit(_str[_pos]))
+      atom.isotope = atom.isotope * 10 + _str[_pos++] - '0';
+
+   if (_pos + 1 >= _len)
+      return false;
+
+   char c1 = _str[_pos], c2 = _str[_pos + 1];
+
+   if (islower(c1))
+   {
+      atom.aromatic = true;
+      if ((c1 == 's' && c2 == 'e') || (c1 == 'a' && c2 == 's'))
+      {
+         atom.number = Element::fromTwoChars2(toupper(c1), c2);
+         _pos += 2;
+      }
+      else if (strchr("cnops", c1) != 0)
+      {
+         atom.number = Element::fromTwoChars2(toupper(c1), 0);
+         _pos++;
+      }
+      else
+         return false;
+   }
+   else if (isupper(c1))
+   {
+      atom.number = -1;
+      if (islower(c2))
+      {
+         atom.number = Element::fromTwoChars2(c1, c2);
+         _pos++;
+      }
+      else
+         atom.number = Element::fromTwoChars2(c1, 0);
+      _pos++;
+
+      // Explicit hydrogens, as well as pseudoatoms and query atoms,
+      // are left to SmilesLoader
+      if (atom.number < ELEM_MIN || atom.number >= ELEM_MAX || atom.number == ELEM_H)
+         return false;
+   }
+   else
+      return false;
+
+   // Tetrahedral stereo marks don't affect the structure
+   if (_pos < _len && _str[_pos] == '@')
+   {
+      _pos++;
+      if (_pos < _len && _str[_pos] == '@')
+         _pos++;
+      if (_pos < _len && isupper(_str[_pos]) && _str[_pos] != 'H')
+         return false;
+   }
+
+   atom.implicit_h = 0;
+   if (_pos < _len && _str[_pos] == 'H')
+   {
+      _pos++;
+      atom.implicit_h = 1;
+      if (_pos < _len && isdigit(_str[_pos]))
+         atom.implicit_h = _str[_pos++] - '0';
+   }
+
+   if (_pos < _len && (_str[_pos] == '+' || _str[_pos] == '-'))
+   {
+      char sign = _str[_pos++];
+
+      atom.charge = 1;
+      if (_pos < _len && isdigit(_str[_pos]))
+         atom.charge = _str[_pos++] - '0';
+      else
+         while (_pos < _len && _str[_pos] == sign)
+         {
+            atom.charge++;
+            _pos++;
+         }
+
+      if (sign == '-')
+         atom.charge = -atom.charge;
+   }
+
+   // Atom class
+   if (_pos < _len && _str[_pos] == ':')
+   {
+      _pos++;
+      if (_pos >= _len || !isdigit(_str[_pos]))
+         return false;
+      while (_pos < _len && isdigit(_str[_pos]))
+         _pos++;
+   }
+
+   if (_pos >= _len || _str[_pos] != ']')
+      return false;
+   _pos++;
+   return true;
+}
+
+bool SmilesFlatLoader::_markRingBonds (FlatMolecule &mol)
+{
+   _ring_bonds.clear_resize(mol.bondCount());
+   _ring_bonds.zerofill();
+
+   // Ring closures are the only bonds outside the tree of the written
+   // atoms, so the ring bonds are the closures and the tree paths they close
+   for (int i = 0; i < _closure_bonds.size(); i++)
+   {
+      int bond = _closure_bonds[i];
+      int u = mol.bonds[bond].beg, v = mol.bonds[bond].end;
+
+      _ring_bonds[bond] = 1;
+
+      while (u != v)
+      {
+         int &w = (_depths[u] >= _depths[v]) ? u : v;
+
+         // The closure joins disconnected components
+         if (_parents[w] < 0)
+            return false;
+
+         _ring_bonds[_parent_bonds[w]] = 1;
+         w = _parents[w];
+      }
+   }
+   return true;
+}
+
+int SmilesFlatLoader::_findRingSystem (int atom)
+{
+   while (_ring_systems[atom] != atom)
+   {
+      _ring_systems[atom] = _ring_systems[_ring_systems[atom]];
+      atom = _ring_systems[atom];
+   }
+   return atom;
+}
+
+bool SmilesFlatLoader::_setBondOrders (FlatMolecule &mol)
+{
+   int i;
+
+   // Ring systems are the components connected by the ring bonds
+   _ring_systems.clear_resize(mol.atomCount());
+   for (i = 0; i < mol.atomCount(); i++)
+      _ring_systems[i] = i;
+
+   for (i = 0; i < mol.bondCount(); i++)
+      if (_ring_bonds[i])
+         _ring_systems[_findRingSystem(mol.bonds[i].beg)] = _findRingSystem(mol.bonds[i].end);
+
+   // 1 for the systems of aromatic atoms and bonds without explicit orders,
+   // 2 for the systems with aliphatic atoms or explicit orders
+   _aliphatic_systems.clear_resize(mol.atomCount());
+   _aliphatic_systems.zerofill();
+
+   for (i = 0; i < mol.bondCount(); i++)
+   {
+      if (!_ring_bonds[i])
+         continue;
+
+      const FlatMolecule::Bond &bond = mol.bonds[i];
+      bool aromatic = mol.atoms[bond.beg].aromatic && mol.atoms[bond.end].aromatic &&
+                      (_bond_types[i] == _NO_BOND || _bond_types[i] == BOND_AROMATIC);
+
+      _aliphatic_systems[_findRingSystem(bond.beg)] |= aromatic ? 1 : 2;
+   }
+
+   // SmilesLoader marks bonds aromatic by SSSR rings. It is the same as here
+   // only if each ring system is either fully aromatic or has no aromatic atoms.
+   for (i = 0; i < mol.atomCount(); i++)
+   {
+      int system = _aliphatic_systems[_findRingSystem(i)];
+
+      if (mol.atoms[i].aromatic && system != 1)
+         return false;
+      if (system == 3)
+         return false;
+   }
+
+   for (i = 0; i < mol.bondCount(); i++)
+   {
+      FlatMolecule::Bond &bond = mol.bonds[i];
+      int type = _bond_types[i];
+      bool aromatic_ring = _ring_bonds[i] && _aliphatic_systems[_findRingSystem(bond.beg)] == 1;
+
+      if (type == _NO_BOND)
+         bond.order = aromatic_ring ? BOND_AROMATIC : BOND_SINGLE;
+      else if (type == _DIRECTED_BOND)
+         bond.order = BOND_SINGLE;
+      else if (type == BOND_AROMATIC && !aromatic_ring)
+         return false;
+      else
+         bond.order = type;
+   }
+   return true;
+}
+
+bool SmilesFlatLoader::_setHydrogens (FlatMolecule &mol)
+{
+   bool ambiguous = false;
+
+   for (int i = 0; i < mol.atomCount(); i++)
+   {
+      FlatMolecule::Atom &atom = mol.atoms[i];
+
+      if (_brackets[i])
+         continue;
+
+      if (atom.aromatic)
+      {
+         // The same rules as in SmilesLoader and Molecule::getImplicitH()
+         // for aromatic atoms, hydrogens on other atoms are restored by
+         // dearomatization in Molecule
+         int degree = mol.degree(i);
+
+         atom.implicit_h = 0;
+         if (atom.number == ELEM_C)
+            atom.implicit_h = (degree < 3) ? 1 : 0;
+         else if ((atom.number == ELEM_N || atom.number == ELEM_S) && degree != 3)
+            ambiguous = true;
+         else if (atom.number == ELEM_P)
+            ambiguous = true;
+         else if (atom.number != ELEM_N && atom.number != ELEM_O && atom.number != ELEM_S)
+            return false;
+         continue;
+      }
+
+      int conn = 0;
+
+      for (int j = mol.nei_offsets[i]; j < mol.nei_offsets[i + 1]; j++)
+         conn += mol.bonds[mol.nei_bonds[j]].order;
+
+      // Nitro groups written as "N(=O)=O", see Molecule::isNitrogenV5()
+      if (atom.number == ELEM_N && conn == 5)
+         atom.implicit_h = 0;
+      else
+      {
+         int valence;
+
+         if (!Element::calcValence(atom.number, 0, 0, conn, valence, atom.implicit_h, false))
+            return false;
+      }
+   }
+
+   // Zero hydrogens on the ambiguous atoms are right if there is a Kekule
+   // structure with them, otherwise dearomatization adds hydrogens
+   return !ambiguous || _checkKekuleStructure(mol);
+}
+
+bool SmilesFlatLoader::_checkKekuleStructure (FlatMolecule &mol)
+{
+   int i;
+
+   _need_double.clear_resize(mol.atomCount());
+   _need_double.zerofill();
+   _matching.clear_resize(mol.atomCount());
+   _matching.fffill();
+
+   for (i = 0; i < mol.atomCount(); i++)
+   {
+      const FlatMolecule::Atom &atom = mol.atoms[i];
+
+      if (!atom.aromatic)
+         continue;
+
+      int valence;
+
+      if (atom.number == ELEM_C)
+         valence = 4 - abs(atom.charge);
+      else if (atom.number == ELEM_N || atom.number == ELEM_P || atom.number == ELEM_As)
+         valence = 3 + atom.charge;
+      else if (atom.number == ELEM_O || atom.number == ELEM_S || atom.number == ELEM_Se)
+         valence = 2 + atom.charge;
+      else
+         return false;
+
+      int unpaired = valence - atom.implicit_h;
+
+      for (int j = mol.nei_offsets[i]; j < mol.nei_offsets[i + 1]; j++)
+      {
+         int order = mol.bonds[mol.nei_bonds[j]].order;
+
+         unpaired -= (order == BOND_AROMATIC) ? 1 : order;
+      }
+
+      if (unpaired != 0 && unpaired != 1)
+         return false;
+      _need_double[i] = unpaired;
+   }
+
+   int steps = 0;
+
+   return _matchAtoms(mol, 0, steps);
+}
+
+bool SmilesFlatLoader::_matchAtoms (FlatMolecule &mol, int from, int &steps)
+{
+   int i = from;
+
+   while (i < mol.atomCount() && (!_need_double[i] || _matching[i] >= 0))
+      i++;
+
+   if (i == mol.atomCount())
+      return true;
+
+   if (++steps > _MAX_MATCHING_STEPS)
+      return false;
+
+   for (int j = mol.nei_offsets[i]; j < mol.nei_offsets[i + 1]; j++)
+   {
+      int nei = mol.nei_atoms[j];
+
+      if (mol.bonds[mol.nei_bonds[j]].order != BOND_AROMATIC || !_need_double[nei] || _matching[nei] >= 0)
+         continue;
+
+      _matching[i] = nei;
+      _matching[nei] = i;
+      if (_matchAtoms(mol, i + 1, steps))
+         return true;
+      _matching[i] = -1;
+      _matching[nei] = -1;
+   }
+   return false;
+}
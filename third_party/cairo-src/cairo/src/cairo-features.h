@@ -0,0 +1,27 @@
+#ifndef CAIRO_FEATURES_H
+#define CAIRO_FEATURES_H
+
+#define CAIRO_HAS_SVG_SURFACE 1
+#define CAIRO_HAS_PDF_SURFACE 1
+#define CAIRO_HAS_PS_SURFACE 1
+#define CAIRO_HAS_PNG_FUNCTIONS 1
+#define CAIRO_HAS_IMAGE_SURFACE 1
+#define CAIRO_HAS_USER_FONT 1
+
+#define CAIRO_HAS_WIN32_FONT 0
+#define CAIRO_HAS_WIN32_SURFACE 0
+#define CAIRO_WIN32_STATIC_BUILD 0
+
+#define CAIRO_HAS_FC_FONT 1
+#define CAIRO_HAS_FT_FONT 1
+
+#define CAIRO_HAS_QUARTZ_FONT 0
+#define CAIRO_HAS_QUARTZ_SURFACE 0
+#define CAIRO_HAS_QUARTZ_IMAGE_SURFACE 0
+
+#define CAIRO_HAS_GL_SURFACE 0
+#define CAIRO_HAS_VG_SURFACE 0
+#define CAIRO_HAS_EGL_FUNCTIONS 0
+#define CAIRO_HAS_GLESV2_SURFACE 0
+
+#endif /* CAIRO_FEATURES_H */